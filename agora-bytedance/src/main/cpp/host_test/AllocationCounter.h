@@ -0,0 +1,19 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_ALLOCATIONCOUNTER_H
+#define AGORAWITHBYTEDANCE_ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+namespace agora {
+    namespace extension {
+        namespace test {
+            // operator new calls of the whole process so far, on any thread
+            uint64_t allocationCount();
+        }
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_ALLOCATIONCOUNTER_H
@@ -0,0 +1,223 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+// AnalysisGraph scheduling: stage order from read/write conflicts, lazy
+// providers that run at most once a frame, and stages pinned to the caller.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "AnalysisGraph.h"
+#include "FrameAnalysisContext.h"
+#include "HostTest.h"
+
+using namespace agora::extension;
+
+namespace {
+    const int kRounds = 200;
+
+    // start and end of each stage on one clock of events
+    struct Span {
+        int start = -1;
+        int end = -1;
+    };
+
+    struct Recorder {
+        std::atomic<int> clock = {0};
+        Span spans[AnalysisGraph::kMaxStages];
+
+        AnalysisGraph::Task stage(int index) {
+            return [this, index] {
+                spans[index].start = clock++;
+                // long enough for a conflicting stage to overlap if it were allowed to
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                spans[index].end = clock++;
+            };
+        }
+
+        bool before(int first, int second) const { return spans[first].end < spans[second].start; }
+    };
+
+    // both stages have to be running at the same time to pass
+    struct Rendezvous {
+        std::mutex mutex;
+        std::condition_variable arrived;
+        int count = 0;
+
+        bool meet() {
+            std::unique_lock<std::mutex> lock(mutex);
+            count++;
+            arrived.notify_all();
+            return arrived.wait_for(lock, std::chrono::seconds(2), [this] { return count >= 2; });
+        }
+    };
+}
+
+// A writer runs before the readers after it, the readers share, and the next
+// writer of the same result waits for them all.
+HOST_TEST(conflictsOrderStages) {
+    WorkerPool pool(4, false);
+    AnalysisGraph graph;
+    int misordered = 0;
+    for (int round = 0; round < kRounds; round++) {
+        Recorder recorder;
+        graph.reset();
+        graph.addStage(0, ANALYSIS_FACE, recorder.stage(0));
+        graph.addStage(ANALYSIS_FACE, 0, recorder.stage(1));
+        graph.addStage(ANALYSIS_FACE, ANALYSIS_FACE_IDENTITY, recorder.stage(2));
+        graph.addStage(ANALYSIS_FACE_IDENTITY, 0, recorder.stage(3));
+        graph.addStage(0, ANALYSIS_FACE, recorder.stage(4));
+        graph.run(&pool);
+        // stage 3 reads nothing stage 4 writes, it may still be running
+        bool ordered = recorder.before(0, 1) && recorder.before(0, 2) && recorder.before(2, 3) &&
+                       recorder.before(1, 4) && recorder.before(2, 4);
+        misordered += ordered ? 0 : 1;
+    }
+    EXPECT_EQ(misordered, 0);
+}
+
+// Stages with nothing in common run at the same time.
+HOST_TEST(independentStagesRunInParallel) {
+    WorkerPool pool(2, false);
+    AnalysisGraph graph;
+    Rendezvous rendezvous;
+    std::atomic<int> met = {0};
+    graph.addStage(ANALYSIS_RGBA, ANALYSIS_FACE, [&] { met += rendezvous.meet(); });
+    graph.addStage(ANALYSIS_RGBA, ANALYSIS_PORTRAIT_MASK, [&] { met += rendezvous.meet(); });
+    graph.run(&pool);
+    EXPECT_EQ(met.load(), 2);
+}
+
+// A provider runs the first time a stage reads its result, with its own
+// inputs first, once however many stages read it, and not at all if none does.
+HOST_TEST(providersRunOnceAndOnlyWhenNeeded) {
+    WorkerPool pool(4, false);
+    AnalysisGraph graph;
+    for (int round = 0; round < kRounds; round++) {
+        std::atomic<int> rgba = {0};
+        std::atomic<int> faces = {0};
+        std::atomic<int> mask = {0};
+        std::atomic<int> facesBeforeRgba = {0};
+        std::atomic<int> readBeforeProvided = {0};
+        graph.reset();
+        graph.setProvider(ANALYSIS_RGBA, ANALYSIS_I420, [&] { rgba++; });
+        graph.setProvider(ANALYSIS_FACE, ANALYSIS_RGBA, [&] {
+            facesBeforeRgba += rgba.load() == 0;
+            faces++;
+        });
+        graph.setProvider(ANALYSIS_PORTRAIT_MASK, ANALYSIS_RGBA, [&] { mask++; });
+        for (int i = 0; i < 6; i++) {
+            unsigned int inputs = (i & 1) ? ANALYSIS_FACE : ANALYSIS_RGBA;
+            graph.addStage(inputs, 0, [&, inputs] {
+                readBeforeProvided += rgba.load() != 1 || ((inputs & ANALYSIS_FACE) && faces.load() != 1);
+            });
+        }
+        graph.run(&pool);
+        EXPECT_EQ(rgba.load(), 1);
+        EXPECT_EQ(faces.load(), 1);
+        EXPECT_EQ(mask.load(), 0);
+        EXPECT_EQ(facesBeforeRgba.load(), 0);
+        EXPECT_EQ(readBeforeProvided.load(), 0);
+        if (rgba.load() != 1 || faces.load() != 1 || readBeforeProvided.load() != 0) {
+            break;
+        }
+
+        // a result already there is not provided again
+        graph.require(ANALYSIS_FACE | ANALYSIS_RGBA);
+        EXPECT_EQ(faces.load(), 1);
+        EXPECT_EQ(rgba.load(), 1);
+    }
+
+    // and reset() starts a new frame
+    int provided = 0;
+    graph.reset();
+    graph.setProvider(ANALYSIS_RGBA, 0, [&] { provided++; });
+    graph.require(ANALYSIS_RGBA);
+    graph.reset();
+    graph.setProvider(ANALYSIS_RGBA, 0, [&] { provided++; });
+    graph.require(ANALYSIS_RGBA);
+    EXPECT_EQ(provided, 2);
+}
+
+// A stage writing a provider's inputs waits for every stage reading the
+// provided result, even though they never named those inputs.
+HOST_TEST(providerInputsCountAsReads) {
+    AnalysisGraph graph;
+    Recorder recorder;
+    WorkerPool pool(4, false);
+    graph.setProvider(ANALYSIS_RGBA, ANALYSIS_I420, [] {});
+    graph.addStage(ANALYSIS_RGBA, 0, recorder.stage(0));
+    graph.addStage(ANALYSIS_RGBA, 0, recorder.stage(1));
+    graph.addStage(0, ANALYSIS_I420, recorder.stage(2));
+    graph.run(&pool);
+    EXPECT_TRUE(recorder.before(0, 2));
+    EXPECT_TRUE(recorder.before(1, 2));
+}
+
+// STAGE_CALLER_THREAD stages run on the thread calling run(), the others may
+// go to the pool; without a pool everything runs on the caller in order.
+HOST_TEST(callerThreadStagesRunOnTheCaller) {
+    WorkerPool pool(4, false);
+    AnalysisGraph graph;
+    std::thread::id caller = std::this_thread::get_id();
+    int offCaller = 0;
+    std::atomic<int> onWorkers = {0};
+    for (int round = 0; round < kRounds; round++) {
+        std::thread::id pinned[4];
+        graph.reset();
+        for (int i = 0; i < 8; i++) {
+            if (i % 2 == 0) {
+                graph.addStage(ANALYSIS_RGBA, 0, [&pinned, i] { pinned[i / 2] = std::this_thread::get_id(); },
+                               AnalysisGraph::STAGE_CALLER_THREAD);
+            } else {
+                graph.addStage(ANALYSIS_RGBA, 0, [&, caller] {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    onWorkers += std::this_thread::get_id() != caller;
+                });
+            }
+        }
+        graph.run(&pool);
+        for (const std::thread::id& id : pinned) {
+            offCaller += id != caller;
+        }
+    }
+    EXPECT_EQ(offCaller, 0);
+    // the pool did take part
+    EXPECT_TRUE(onWorkers.load() > 0);
+
+    int order[4];
+    int next = 0;
+    bool sameThread = true;
+    graph.reset();
+    for (int i = 0; i < 4; i++) {
+        graph.addStage(ANALYSIS_RGBA, 0, [&, i] {
+            order[next++] = i;
+            sameThread = sameThread && std::this_thread::get_id() == caller;
+        });
+    }
+    graph.run(nullptr);
+    EXPECT_EQ(next, 4);
+    EXPECT_TRUE(sameThread && order[0] == 0 && order[1] == 1 && order[2] == 2 && order[3] == 3);
+}
+
+HOST_TEST(currentStageIsTheRunningOne) {
+    WorkerPool pool(2, false);
+    AnalysisGraph graph;
+    int seen[3] = {-2, -2, -2};
+    for (int i = 0; i < 3; i++) {
+        graph.addStage(0, 1u << i, [&seen, i] { seen[i] = AnalysisGraph::currentStage(); });
+    }
+    graph.run(&pool);
+    EXPECT_TRUE(seen[0] == 0 && seen[1] == 1 && seen[2] == 2);
+    EXPECT_EQ(AnalysisGraph::currentStage(), -1);
+
+    graph.reset();
+    for (int i = 0; i < AnalysisGraph::kMaxStages; i++) {
+        EXPECT_TRUE(graph.addStage(0, 0, [] {}));
+    }
+    EXPECT_TRUE(!graph.addStage(0, 0, [] {}));
+}
@@ -0,0 +1,139 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+// Cost of ExtensionAudioFilter::adaptAudioFrame per frame, for every sample
+// rate, channel count and frame duration an AudioPcmFrame can hold, in the
+// plain gain and the loudness configurations.
+//
+//   audio_filter_bench [--seconds N] [file.wav ...]
+//
+// WAV files (16-bit PCM) are run in 10 ms frames at their own format. The
+// real-time factor is processing time over audio time. Fails if a frame
+// allocates once the filter is warmed up.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "AudioTestSupport.h"
+
+using namespace agora::extension::test;
+using agora::media::base::AudioPcmFrame;
+
+namespace {
+    struct BenchConfig {
+        const char* name;
+        const char* params;
+    };
+
+    const BenchConfig kConfigs[] = {
+            {"gain", "{\"loudness\":0,\"volume\":70}"},
+            {"loudness", "{\"loudness\":1,\"loudnessTarget\":-23}"},
+    };
+
+    struct BenchResult {
+        double nsPerFrame;
+        double realTimeFactor;
+        double allocationsPerFrame;
+    };
+
+    BenchResult run(const char* params, const AudioClip& clip, size_t samplesPerChannel, double seconds) {
+        static AudioPcmFrame in;
+        static AudioPcmFrame out;
+        auto filter = createLocalAudioFilter();
+        setProperty(*filter.get(), "params", params);
+
+        size_t frames = clip.frames() / samplesPerChannel;
+        size_t length = samplesPerChannel * clip.channels;
+        in.sample_rate_hz_ = out.sample_rate_hz_ = clip.sampleRate;
+        in.num_channels_ = out.num_channels_ = clip.channels;
+        in.samples_per_channel_ = out.samples_per_channel_ = samplesPerChannel;
+
+        // warm up on one pass of the clip
+        for (size_t i = 0; i < frames; i++) {
+            memcpy(in.data_, clip.samples.data() + i * length, length * sizeof(int16_t));
+            filter->adaptAudioFrame(in, out);
+        }
+
+        size_t total = std::max((size_t)1, (size_t)(seconds * clip.sampleRate / samplesPerChannel));
+        std::chrono::nanoseconds busy(0);
+        uint64_t allocations = allocationCount();
+        for (size_t i = 0; i < total; i++) {
+            memcpy(in.data_, clip.samples.data() + (i % frames) * length, length * sizeof(int16_t));
+            // the copy in is the SDK's work, keep it out of the measurement
+            auto start = std::chrono::steady_clock::now();
+            filter->adaptAudioFrame(in, out);
+            busy += std::chrono::steady_clock::now() - start;
+        }
+        allocations = allocationCount() - allocations;
+
+        double audioNs = 1e9 * total * samplesPerChannel / clip.sampleRate;
+        return {(double)busy.count() / total, busy.count() / audioNs, (double)allocations / total};
+    }
+}
+
+int main(int argc, char** argv) {
+    double seconds = 10;
+    std::vector<std::string> wavs;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = atof(argv[++i]);
+        } else {
+            wavs.push_back(argv[i]);
+        }
+    }
+
+    bool allocated = false;
+    auto report = [&](const char* config, const char* input, int rate, int channels, size_t samples,
+                      const BenchResult& result) {
+        printf("%-9s %-12s %6d Hz %d ch %5zu %10.0f ns/frame  RTF %.5f  %.2f allocs/frame\n",
+               config, input, rate, channels, samples, result.nsPerFrame, result.realTimeFactor,
+               result.allocationsPerFrame);
+        allocated = allocated || result.allocationsPerFrame > 0;
+    };
+
+    const int kRates[] = {8000, 16000, 32000, 44100, 48000};
+    const int kFrameMs[] = {10, 20, 40, 60};
+    for (const BenchConfig& config : kConfigs) {
+        for (int rate : kRates) {
+            for (int channels = 1; channels <= 2; channels++) {
+                AudioClip clip = makeSpeechLike(rate, channels, 3, 5);
+                for (int ms : kFrameMs) {
+                    size_t samples = (size_t)rate * ms / 1000;
+                    if (samples * channels > AudioPcmFrame::kMaxDataSizeSamples) {
+                        continue;
+                    }
+                    report(config.name, "speech", rate, channels, samples, run(config.params, clip, samples, seconds));
+                }
+            }
+        }
+    }
+
+    for (const std::string& path : wavs) {
+        AudioClip clip;
+        if (!readWav(path, clip) || clip.channels > 2 ||
+            (size_t)clip.sampleRate / 100 * clip.channels > AudioPcmFrame::kMaxDataSizeSamples ||
+            clip.frames() < (size_t)clip.sampleRate / 100) {
+            fprintf(stderr, "%s: not a usable 16-bit PCM WAV file\n", path.c_str());
+            return 1;
+        }
+        std::string name = path.substr(path.find_last_of('/') + 1);
+        for (const BenchConfig& config : kConfigs) {
+            size_t samples = clip.sampleRate / 100;
+            report(config.name, name.c_str(), clip.sampleRate, clip.channels, samples,
+                   run(config.params, clip, samples, std::max(seconds, clip.seconds())));
+        }
+    }
+
+    if (allocated) {
+        fprintf(stderr, "adaptAudioFrame allocated on the audio thread\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+// Conformance of ExtensionAudioFilter::adaptAudioFrame: golden outputs, bit
+// exactness where the output is defined exactly, independence from the frame
+// size, and no allocation on the audio thread.
+//
+// AUDIO_GOLDEN_UPDATE=1 rewrites the golden files instead of comparing; do
+// that only for an intended change of the output and commit them with it.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "AllocationCounter.h"
+#include "AudioTestSupport.h"
+#include "HostTest.h"
+
+using namespace agora::extension::test;
+using agora::media::base::AudioPcmFrame;
+
+namespace {
+    // integer gains are exact, loudness only drifts by rounding on another compiler or CPU
+    const double kMinGoldenSnrDb = 60.0;
+
+    struct GoldenSignal {
+        const char* name;
+        AudioClip (*make)();
+    };
+
+    struct GoldenConfig {
+        const char* name;
+        const char* key;
+        const char* value;
+    };
+
+    const GoldenSignal kGoldenSignals[] = {
+            {"sine1k", [] { return makeSine(16000, 1, 1.5, 1000, -20); }},
+            {"sweep", [] { return makeSweep(16000, 1, 1.5, 20, 7000, -12); }},
+            {"speech", [] { return makeSpeechLike(16000, 1, 1.5, 7); }},
+    };
+
+    const GoldenConfig kGoldenConfigs[] = {
+            {"volume50", "volume", "50"},
+            {"volume400", "volume", "400"},
+            {"loudness", "params", "{\"loudness\":1,\"loudnessTarget\":-23}"},
+    };
+
+    bool updateGolden() {
+        const char* update = getenv("AUDIO_GOLDEN_UPDATE");
+        return update && std::string(update) == "1";
+    }
+
+    AudioClip process(const AudioClip& in, const char* key, const char* value, size_t samplesPerChannel) {
+        auto filter = createLocalAudioFilter();
+        AudioClip out;
+        EXPECT_EQ(setProperty(*filter.get(), key, value), 0);
+        EXPECT_TRUE(runFilter(*filter.get(), in, samplesPerChannel, out));
+        return out;
+    }
+
+    size_t tenMs(int sampleRate) {
+        return sampleRate / 100;
+    }
+}
+
+HOST_TEST(unityVolumeIsBitExact) {
+    AudioClip signals[] = {
+            makeSweep(48000, 2, 1, 20, 20000, 0),
+            makeNoise(44100, 1, 1, -3, 1),
+            makeSpeechLike(8000, 1, 3, 2),
+    };
+    for (const AudioClip& in : signals) {
+        AudioClip out = process(in, "volume", "100", tenMs(in.sampleRate));
+        EXPECT_TRUE(out.samples == in.samples);
+    }
+}
+
+HOST_TEST(gainSaturatesInsteadOfWrapping) {
+    AudioClip in = makeSine(48000, 2, 0.5, 440, 0);
+    AudioClip out = process(in, "volume", "400", tenMs(in.sampleRate));
+    ASSERT_TRUE(out.samples.size() == in.samples.size());
+    for (size_t i = 0; i < in.samples.size(); i++) {
+        int expected = in.samples[i] * 4;
+        expected = expected > 32767 ? 32767 : expected < -32768 ? -32768 : expected;
+        if (out.samples[i] != expected) {
+            EXPECT_EQ(out.samples[i], expected);
+            break;
+        }
+    }
+}
+
+HOST_TEST(matchesGoldenOutputs) {
+    for (const GoldenSignal& signal : kGoldenSignals) {
+        AudioClip in = signal.make();
+        for (const GoldenConfig& config : kGoldenConfigs) {
+            std::string path = std::string(HOST_TEST_GOLDEN_DIR) + "/" + signal.name + "_" + config.name + ".wav";
+            AudioClip out = process(in, config.key, config.value, tenMs(in.sampleRate));
+            if (updateGolden()) {
+                EXPECT_TRUE(writeWav(path, out));
+                continue;
+            }
+            AudioClip golden;
+            if (!readWav(path, golden)) {
+                reportFailure(__FILE__, __LINE__, "cannot read " + path);
+                continue;
+            }
+            EXPECT_EQ(golden.sampleRate, out.sampleRate);
+            EXPECT_EQ(golden.channels, out.channels);
+            double snr = snrDb(golden, out);
+            printf("  %s_%s: %.1f dB\n", signal.name, config.name, snr);
+            EXPECT_TRUE(snr >= kMinGoldenSnrDb);
+        }
+    }
+}
+
+// Everything is per sample, so how the SDK slices the stream must not change a
+// single output sample, for every frame size an AudioPcmFrame can hold.
+HOST_TEST(outputIndependentOfFrameSize) {
+    const int kRates[] = {8000, 16000, 32000, 44100, 48000};
+    const int kFrameMs[] = {10, 20, 30, 40, 60};
+    const char* kLoudness = "{\"loudness\":1,\"loudnessTarget\":-16,\"volume\":80}";
+    for (int rate : kRates) {
+        for (int channels = 1; channels <= 2; channels++) {
+            AudioClip in = makeSpeechLike(rate, channels, 4, 11);
+            AudioClip reference = process(in, "params", kLoudness, tenMs(rate));
+
+            size_t maxSamples = AudioPcmFrame::kMaxDataSizeSamples / channels;
+            std::vector<size_t> sizes = {1, 7, 441, 1000, maxSamples};
+            for (int ms : kFrameMs) {
+                sizes.push_back((size_t)rate * ms / 1000);
+            }
+            for (size_t size : sizes) {
+                if (size > maxSamples) {
+                    continue;
+                }
+                AudioClip out = process(in, "params", kLoudness, size);
+                if (out.samples != reference.samples) {
+                    printf("  %d Hz, %d channels, %zu samples per frame differs\n", rate, channels, size);
+                    EXPECT_TRUE(out.samples == reference.samples);
+                }
+            }
+        }
+    }
+}
+
+HOST_TEST(noAllocationPerFrame) {
+    const char* kConfigs[] = {
+            "{\"loudness\":0,\"volume\":70}",
+            "{\"loudness\":1,\"loudnessTarget\":-23}",
+    };
+    for (const char* config : kConfigs) {
+        auto filter = createLocalAudioFilter();
+        EXPECT_EQ(setProperty(*filter.get(), "params", config), 0);
+        AudioClip in = makeSpeechLike(48000, 2, 2, 3);
+        AudioClip out;
+        // first frames may set up state, out is sized by then
+        EXPECT_TRUE(runFilter(*filter.get(), in, 480, out));
+        uint64_t before = allocationCount();
+        EXPECT_TRUE(runFilter(*filter.get(), in, 480, out));
+        EXPECT_EQ(allocationCount() - before, (uint64_t)0);
+    }
+}
@@ -0,0 +1,62 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <cstring>
+#include <limits>
+
+#include "AgoraRtcKit/AgoraBase.h"
+#include "AudioParameters.h"
+#include "HostTest.h"
+
+using namespace agora::extension;
+
+namespace {
+    int setText(AudioParameterBlock& block, const char* key, const char* text) {
+        return block.set(key, text, (int)strlen(text));
+    }
+
+    int setFloat(AudioParameterBlock& block, const char* key, float value) {
+        AudioPropertyValue binary;
+        binary.type = AUDIO_PARAM_FLOAT;
+        binary.f = value;
+        return block.set(key, &binary, sizeof(binary));
+    }
+}
+
+HOST_TEST(acceptsValuesInRange) {
+    AudioParameterBlock block;
+    EXPECT_EQ(setText(block, "volume", "250"), (int)agora::ERR_OK);
+    EXPECT_EQ(setFloat(block, "loudnessTarget", -16.5f), (int)agora::ERR_OK);
+    EXPECT_EQ(setText(block, "params", "{\"loudness\":true,\"volume\":80}"), (int)agora::ERR_OK);
+    AudioParameters params = block.snapshot();
+    EXPECT_EQ(params.volume, 80);
+    EXPECT_EQ(params.loudnessEnabled, 1);
+    EXPECT_NEAR(params.loudnessTarget, -16.5, 1e-6);
+}
+
+HOST_TEST(rejectsNonFiniteValues) {
+    AudioParameterBlock block;
+    const float kNan = std::numeric_limits<float>::quiet_NaN();
+    const float kInf = std::numeric_limits<float>::infinity();
+    EXPECT_EQ(setFloat(block, "loudnessTarget", kNan), -(int)agora::ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(setFloat(block, "loudnessTarget", -kInf), -(int)agora::ERR_INVALID_ARGUMENT);
+    const char* kTexts[] = {"nan", "-nan", "NAN", "inf", "-inf", "infinity", "-1e999"};
+    for (const char* text : kTexts) {
+        EXPECT_EQ(setText(block, "loudnessTarget", text), -(int)agora::ERR_INVALID_ARGUMENT);
+        EXPECT_EQ(setText(block, "volume", text), -(int)agora::ERR_INVALID_ARGUMENT);
+    }
+    AudioParameters params = block.snapshot();
+    EXPECT_EQ(params.volume, 100);
+    EXPECT_NEAR(params.loudnessTarget, -23.0, 1e-6);
+}
+
+HOST_TEST(rejectsOutOfRangeAndFractionalInts) {
+    AudioParameterBlock block;
+    EXPECT_EQ(setText(block, "volume", "401"), -(int)agora::ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(setText(block, "volume", "50.5"), -(int)agora::ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(setText(block, "loudnessTarget", "3"), -(int)agora::ERR_INVALID_ARGUMENT);
+    // one bad key rejects the whole object
+    EXPECT_EQ(setText(block, "params", "{\"volume\":20,\"loudness\":2}"), -(int)agora::ERR_INVALID_ARGUMENT);
+    EXPECT_EQ(block.snapshot().volume, 100);
+}
@@ -0,0 +1,254 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "AudioTestSupport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "AgoraRtcKit/AgoraRefCountedObject.h"
+#include "AudioProcessor.h"
+#include "AudioUtils.h"
+#include "ExtensionAudioFilter.h"
+
+namespace agora {
+    namespace extension {
+        namespace test {
+            namespace {
+                const double kPi = 3.14159265358979323846;
+                const double kFullScale = 32767.0;
+                const int16_t kUnwritten = 0x5a5a;
+
+                double dbToAmplitude(double dbfs) {
+                    return kFullScale * std::pow(10.0, dbfs / 20.0);
+                }
+
+                AudioClip makeClip(int sampleRate, int channels, double seconds) {
+                    AudioClip clip;
+                    clip.sampleRate = sampleRate;
+                    clip.channels = channels;
+                    clip.samples.resize((size_t)std::lround(seconds * sampleRate) * channels);
+                    return clip;
+                }
+
+                void setFrame(AudioClip& clip, size_t frame, double value) {
+                    int16_t sample = FloatS16ToS16((float)value);
+                    for (int ch = 0; ch < clip.channels; ch++) {
+                        clip.samples[frame * clip.channels + ch] = sample;
+                    }
+                }
+
+                // same sequence on every platform, unlike std::rand
+                struct Lcg {
+                    uint32_t state;
+
+                    // uniform in [-1, 1)
+                    double next() {
+                        state = state * 1664525u + 1013904223u;
+                        return (state >> 8) / 8388608.0 - 1.0;
+                    }
+                };
+
+                void putLe(std::vector<uint8_t>& out, uint32_t value, int bytes) {
+                    for (int i = 0; i < bytes; i++) {
+                        out.push_back((uint8_t)(value >> (8 * i)));
+                    }
+                }
+
+                uint32_t getLe(const uint8_t* p, int bytes) {
+                    uint32_t value = 0;
+                    for (int i = 0; i < bytes; i++) {
+                        value |= (uint32_t)p[i] << (8 * i);
+                    }
+                    return value;
+                }
+            }
+
+            AudioClip makeSine(int sampleRate, int channels, double seconds, double hz, double dbfs) {
+                AudioClip clip = makeClip(sampleRate, channels, seconds);
+                double amplitude = dbToAmplitude(dbfs);
+                for (size_t i = 0; i < clip.frames(); i++) {
+                    setFrame(clip, i, amplitude * std::sin(2 * kPi * hz * i / sampleRate));
+                }
+                return clip;
+            }
+
+            AudioClip makeSweep(int sampleRate, int channels, double seconds, double hz0, double hz1, double dbfs) {
+                AudioClip clip = makeClip(sampleRate, channels, seconds);
+                double amplitude = dbToAmplitude(dbfs);
+                double rate = std::log(hz1 / hz0) / seconds;
+                for (size_t i = 0; i < clip.frames(); i++) {
+                    double t = (double)i / sampleRate;
+                    double phase = 2 * kPi * hz0 * (std::exp(rate * t) - 1) / rate;
+                    setFrame(clip, i, amplitude * std::sin(phase));
+                }
+                return clip;
+            }
+
+            AudioClip makeNoise(int sampleRate, int channels, double seconds, double dbfs, uint32_t seed) {
+                AudioClip clip = makeClip(sampleRate, channels, seconds);
+                // uniform noise of peak a has an RMS of a/sqrt(3), a sine a/sqrt(2)
+                double amplitude = dbToAmplitude(dbfs) * std::sqrt(3.0 / 2.0);
+                Lcg lcg = {seed};
+                for (size_t i = 0; i < clip.samples.size(); i++) {
+                    clip.samples[i] = FloatS16ToS16((float)(amplitude * lcg.next()));
+                }
+                return clip;
+            }
+
+            AudioClip makeSpeechLike(int sampleRate, int channels, double seconds, uint32_t seed) {
+                AudioClip clip = makeClip(sampleRate, channels, seconds);
+                Lcg lcg = {seed};
+                // one pole at ~1 kHz gives the noise a voice-like tilt
+                double pole = std::exp(-2 * kPi * 1000.0 / sampleRate);
+                double lowPassed = 0;
+                for (size_t i = 0; i < clip.frames(); i++) {
+                    double t = (double)i / sampleRate;
+                    lowPassed = pole * lowPassed + (1 - pole) * lcg.next();
+                    // 4 Hz syllables, a 0.4 s pause every 1.5 s, talkers 12 dB apart
+                    double sentence = std::fmod(t, 1.5);
+                    double envelope = sentence < 1.1 ? std::fabs(std::sin(2 * kPi * 4 * t)) : 0;
+                    double level = (int)(t / 1.5) % 2 == 0 ? -14.0 : -26.0;
+                    setFrame(clip, i, 4 * dbToAmplitude(level) * envelope * lowPassed);
+                }
+                return clip;
+            }
+
+            bool readWav(const std::string& path, AudioClip& clip) {
+                FILE* file = fopen(path.c_str(), "rb");
+                if (!file) {
+                    return false;
+                }
+                std::vector<uint8_t> data;
+                uint8_t buffer[4096];
+                size_t n;
+                while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+                    data.insert(data.end(), buffer, buffer + n);
+                }
+                fclose(file);
+
+                if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) != 0 ||
+                    memcmp(data.data() + 8, "WAVE", 4) != 0) {
+                    return false;
+                }
+                bool haveFormat = false;
+                size_t pos = 12;
+                while (pos + 8 <= data.size()) {
+                    const uint8_t* chunk = data.data() + pos;
+                    size_t size = getLe(chunk + 4, 4);
+                    if (pos + 8 + size > data.size()) {
+                        return false;
+                    }
+                    if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+                        int format = getLe(chunk + 8, 2);
+                        int bits = getLe(chunk + 22, 2);
+                        if (format != 1 || bits != 16) {
+                            return false;
+                        }
+                        clip.channels = getLe(chunk + 10, 2);
+                        clip.sampleRate = getLe(chunk + 12, 4);
+                        haveFormat = clip.channels > 0 && clip.sampleRate > 0;
+                    } else if (memcmp(chunk, "data", 4) == 0 && haveFormat) {
+                        clip.samples.resize(size / 2);
+                        for (size_t i = 0; i < clip.samples.size(); i++) {
+                            clip.samples[i] = (int16_t)getLe(chunk + 8 + 2 * i, 2);
+                        }
+                        return true;
+                    }
+                    // chunks are padded to an even size
+                    pos += 8 + size + (size & 1);
+                }
+                return false;
+            }
+
+            bool writeWav(const std::string& path, const AudioClip& clip) {
+                uint32_t dataBytes = (uint32_t)(clip.samples.size() * 2);
+                std::vector<uint8_t> out;
+                out.insert(out.end(), {'R', 'I', 'F', 'F'});
+                putLe(out, 36 + dataBytes, 4);
+                out.insert(out.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+                putLe(out, 16, 4);
+                putLe(out, 1, 2);
+                putLe(out, clip.channels, 2);
+                putLe(out, clip.sampleRate, 4);
+                putLe(out, clip.sampleRate * clip.channels * 2, 4);
+                putLe(out, clip.channels * 2, 2);
+                putLe(out, 16, 2);
+                out.insert(out.end(), {'d', 'a', 't', 'a'});
+                putLe(out, dataBytes, 4);
+                for (int16_t sample : clip.samples) {
+                    putLe(out, (uint16_t)sample, 2);
+                }
+
+                FILE* file = fopen(path.c_str(), "wb");
+                if (!file) {
+                    return false;
+                }
+                bool ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+                return fclose(file) == 0 && ok;
+            }
+
+            double snrDb(const AudioClip& reference, const AudioClip& test) {
+                if (reference.samples.size() != test.samples.size()) {
+                    return -200;
+                }
+                double signal = 0;
+                double noise = 0;
+                for (size_t i = 0; i < reference.samples.size(); i++) {
+                    double r = reference.samples[i];
+                    double d = r - test.samples[i];
+                    signal += r * r;
+                    noise += d * d;
+                }
+                if (noise == 0) {
+                    return 200;
+                }
+                return 10 * std::log10(std::max(signal, 1.0) / noise);
+            }
+
+            bool runFilter(agora::rtc::IAudioFilter& filter, const AudioClip& in, size_t samplesPerChannel,
+                           AudioClip& out) {
+                // AudioPcmFrame carries its buffer inline, keep the pair off the stack
+                static media::base::AudioPcmFrame inFrame;
+                static media::base::AudioPcmFrame outFrame;
+                out.sampleRate = in.sampleRate;
+                out.channels = in.channels;
+                out.samples.resize(in.samples.size());
+
+                size_t frames = in.frames();
+                for (size_t pos = 0; pos < frames; pos += samplesPerChannel) {
+                    size_t count = std::min(samplesPerChannel, frames - pos);
+                    size_t length = count * in.channels;
+                    inFrame.samples_per_channel_ = count;
+                    inFrame.sample_rate_hz_ = in.sampleRate;
+                    inFrame.num_channels_ = in.channels;
+                    memcpy(inFrame.data_, in.samples.data() + pos * in.channels, length * sizeof(int16_t));
+                    // poisoned, so samples the filter leaves unwritten show up in the output
+                    outFrame.samples_per_channel_ = count;
+                    outFrame.sample_rate_hz_ = in.sampleRate;
+                    outFrame.num_channels_ = in.channels;
+                    std::fill(outFrame.data_, outFrame.data_ + length, kUnwritten);
+                    if (!filter.adaptAudioFrame(inFrame, outFrame)) {
+                        return false;
+                    }
+                    memcpy(out.samples.data() + pos * in.channels, outFrame.data_, length * sizeof(int16_t));
+                }
+                return true;
+            }
+
+            agora_refptr<agora::rtc::IAudioFilter> createLocalAudioFilter() {
+                agora_refptr<AdjustVolumeAudioProcessor> processor =
+                        new agora::RefCountedObject<AdjustVolumeAudioProcessor>();
+                processor->setVendorName("ByteDance");
+                return new agora::RefCountedObject<ExtensionAudioFilter>(processor);
+            }
+
+            int setProperty(agora::rtc::IAudioFilter& filter, const char* key, const char* value) {
+                return filter.setProperty(key, value, (int)strlen(value));
+            }
+        }
+    }
+}
@@ -0,0 +1,63 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_AUDIOTESTSUPPORT_H
+#define AGORAWITHBYTEDANCE_AUDIOTESTSUPPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AgoraRtcKit/AgoraRefPtr.h"
+#include "AgoraRtcKit/NGIAgoraMediaNode.h"
+
+namespace agora {
+    namespace extension {
+        namespace test {
+            // interleaved S16 PCM
+            struct AudioClip {
+                int sampleRate = 0;
+                int channels = 0;
+                std::vector<int16_t> samples;
+
+                size_t frames() const { return channels > 0 ? samples.size() / channels : 0; }
+
+                double seconds() const { return sampleRate > 0 ? (double)frames() / sampleRate : 0; }
+            };
+
+            // Deterministic test signals, the same on every host. Levels are dB
+            // relative to a full scale sine.
+            AudioClip makeSine(int sampleRate, int channels, double seconds, double hz, double dbfs);
+
+            // logarithmic sweep from hz0 to hz1
+            AudioClip makeSweep(int sampleRate, int channels, double seconds, double hz0, double hz1, double dbfs);
+
+            AudioClip makeNoise(int sampleRate, int channels, double seconds, double dbfs, uint32_t seed);
+
+            // low-passed noise in syllable-rate bursts with pauses, loud and quiet talkers alternating
+            AudioClip makeSpeechLike(int sampleRate, int channels, double seconds, uint32_t seed);
+
+            // 16-bit PCM only
+            bool readWav(const std::string& path, AudioClip& clip);
+
+            bool writeWav(const std::string& path, const AudioClip& clip);
+
+            // of test against reference, 200 dB when they are identical
+            double snrDb(const AudioClip& reference, const AudioClip& test);
+
+            // Feeds the clip through the filter samplesPerChannel at a time, the
+            // last frame may be shorter. Returns false if the filter rejected a frame.
+            bool runFilter(agora::rtc::IAudioFilter& filter, const AudioClip& in, size_t samplesPerChannel,
+                           AudioClip& out);
+
+            // the local audio filter as the provider creates it
+            agora_refptr<agora::rtc::IAudioFilter> createLocalAudioFilter();
+
+            int setProperty(agora::rtc::IAudioFilter& filter, const char* key, const char* value);
+        }
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_AUDIOTESTSUPPORT_H
@@ -0,0 +1,171 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+// BackgroundCompositor with a known portrait mask: the left half of the mask
+// is the person, the right half background. The mask covers the whole luma
+// stride, as the processor's RGBA copy does, so on a padded frame the person
+// reaches further into the visible picture than half its width.
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "BackgroundCompositor.h"
+#include "HostTest.h"
+#include "MaskCache.h"
+#include "VideoTestSupport.h"
+
+using namespace agora::extension;
+using namespace agora::extension::test;
+
+namespace {
+    const int kMaskWidth = 16;
+    const int kMaskHeight = 8;
+    const uint8_t kPadding = 0xA5;
+
+    agora::agora_refptr<SegmentationMask> halfMask(MaskCache& cache) {
+        agora::agora_refptr<SegmentationMask> mask = cache.acquire(MASK_PORTRAIT);
+        mask->resetRegions(1);
+        MaskRegion& region = mask->region(0);
+        region.width = kMaskWidth;
+        region.height = kMaskHeight;
+        region.alpha.assign(kMaskWidth * kMaskHeight, 0);
+        for (int y = 0; y < kMaskHeight; y++) {
+            std::fill_n(region.alpha.begin() + y * kMaskWidth, kMaskWidth / 2, 255);
+        }
+        cache.publish(MASK_PORTRAIT, mask);
+        return cache.latest(MASK_PORTRAIT);
+    }
+
+    // a pattern a blur flattens: 1 pixel checkerboard, padding marked
+    I420Image checkerboard(int width, int height, int yStride) {
+        I420Image image(width, height, yStride);
+        std::fill(image.y.begin(), image.y.end(), kPadding);
+        std::fill(image.u.begin(), image.u.end(), kPadding);
+        std::fill(image.v.begin(), image.v.end(), kPadding);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                image.lumaAt(x, y) = ((x + y) & 1) ? 220 : 30;
+            }
+        }
+        for (int y = 0; y < image.chromaHeight(); y++) {
+            for (int x = 0; x < image.chromaWidth(); x++) {
+                image.uAt(x, y) = ((x + y) & 1) ? 200 : 60;
+                image.vAt(x, y) = ((x + y) & 1) ? 90 : 170;
+            }
+        }
+        return image;
+    }
+
+    // last luma / chroma column the person fully covers and first one the
+    // background fully covers, for a mask spanning `stride` luma columns:
+    // the 4x bilinear upscale blends over the two mask columns at the edge
+    struct Edges {
+        int personLuma;
+        int backgroundLuma;
+        int personChroma;
+        int backgroundChroma;
+    };
+
+    Edges edgesFor(int stride) {
+        int lumaScale = stride / kMaskWidth;
+        int half = stride / 2;
+        return {half - lumaScale / 2 - 1, half + lumaScale / 2 + 1,
+                half / 2 - lumaScale / 4 - 1, half / 2 + lumaScale / 4 + 1};
+    }
+
+    void expectColorComposite(int width, int yStride) {
+        const int kHeight = 32;
+        MaskCache cache;
+        I420Image image = checkerboard(width, kHeight, yStride);
+        I420Image original = image;
+        BackgroundCompositor compositor;
+        compositor.setMode(BACKGROUND_COLOR);
+        compositor.setColor(0x0000FF);
+        compositor.setMask(halfMask(cache));
+        compositor.apply(image.frame());
+
+        // BT.601 limited range blue
+        const int kY = 41, kU = 240, kV = 110;
+        Edges edges = edgesFor(image.yStride);
+        int personMismatch = 0, backgroundMismatch = 0;
+        for (int y = 0; y < kHeight; y++) {
+            for (int x = 0; x < image.yStride; x++) {
+                if (x <= edges.personLuma || x >= width) {
+                    personMismatch += image.lumaAt(x, y) != original.lumaAt(x, y);
+                } else if (x >= edges.backgroundLuma) {
+                    backgroundMismatch += image.lumaAt(x, y) != kY;
+                }
+            }
+        }
+        for (int y = 0; y < image.chromaHeight(); y++) {
+            for (int x = 0; x < image.chromaStride(); x++) {
+                if (x <= edges.personChroma || x >= image.chromaWidth()) {
+                    personMismatch += image.uAt(x, y) != original.uAt(x, y);
+                    personMismatch += image.vAt(x, y) != original.vAt(x, y);
+                } else if (x >= edges.backgroundChroma) {
+                    backgroundMismatch += image.uAt(x, y) != kU;
+                    backgroundMismatch += image.vAt(x, y) != kV;
+                }
+            }
+        }
+        // the person and the padding are untouched, the background is the color
+        EXPECT_EQ(personMismatch, 0);
+        EXPECT_EQ(backgroundMismatch, 0);
+    }
+}
+
+HOST_TEST(colorReplacesTheBackgroundOnly) {
+    expectColorComposite(64, 64);
+}
+
+// With a 48 pixel picture in a 64 byte stride the mask edge is at luma column
+// 32, not 24: the mask is laid over the stride, padding included.
+HOST_TEST(maskSpansTheLumaStride) {
+    expectColorComposite(48, 64);
+}
+
+HOST_TEST(blurSmoothsTheBackgroundOnly) {
+    const int kWidth = 64;
+    const int kHeight = 32;
+    MaskCache cache;
+    I420Image image = checkerboard(kWidth, kHeight, kWidth);
+    I420Image original = image;
+    BackgroundCompositor compositor;
+    compositor.setMode(BACKGROUND_BLUR);
+    compositor.setBlurRadius(8);
+    compositor.setMask(halfMask(cache));
+    compositor.apply(image.frame());
+
+    Edges edges = edgesFor(kWidth);
+    int personMismatch = 0;
+    int worstDeviation = 0;
+    for (int y = 0; y < kHeight; y++) {
+        for (int x = 0; x < kWidth; x++) {
+            if (x <= edges.personLuma) {
+                personMismatch += image.lumaAt(x, y) != original.lumaAt(x, y);
+            } else if (x >= edges.backgroundLuma) {
+                worstDeviation = std::max(worstDeviation, std::abs(image.lumaAt(x, y) - 125));
+            }
+        }
+    }
+    EXPECT_EQ(personMismatch, 0);
+    // the checkerboard swings 95 around its mean, blurred it is nearly flat
+    EXPECT_TRUE(worstDeviation <= 10);
+}
+
+// Without a mask, or with the mode off, the frame is left alone.
+HOST_TEST(noMaskOrNoModeLeavesTheFrame) {
+    MaskCache cache;
+    I420Image image = checkerboard(64, 32, 64);
+    I420Image original = image;
+    BackgroundCompositor compositor;
+    compositor.setMode(BACKGROUND_COLOR);
+    compositor.apply(image.frame());
+    EXPECT_TRUE(image.y == original.y && image.u == original.u && image.v == original.v);
+
+    compositor.setMode(BACKGROUND_NONE);
+    compositor.setMask(halfMask(cache));
+    compositor.apply(image.frame());
+    EXPECT_TRUE(image.y == original.y && image.u == original.u && image.v == original.v);
+}
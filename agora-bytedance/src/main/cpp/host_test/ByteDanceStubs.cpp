@@ -0,0 +1,526 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "ByteDanceStubs.h"
+
+#include <cstring>
+#include <mutex>
+
+#include "bytedance/bef_effect_ai_api.h"
+#include "bytedance/bef_effect_ai_dynamic_action.h"
+#include "bytedance/bef_effect_ai_face_verify.h"
+#include "bytedance/bef_effect_ai_hairparser.h"
+#include "bytedance/bef_effect_ai_headseg.h"
+#include "bytedance/bef_effect_ai_human_distance.h"
+#include "bytedance/bef_effect_ai_lightcls.h"
+#include "bytedance/bef_effect_ai_pet_face.h"
+#include "bytedance/bef_effect_ai_portrait_matting.h"
+#include "bytedance/bef_effect_ai_yuv_process.h"
+
+namespace {
+    struct Call {
+        const char* function;
+        int count;
+        int imageWidth;
+        int imageStride;
+    };
+
+    // fixed, so counting never allocates
+    const int kMaxFunctions = 96;
+    std::mutex callsMutex;
+    Call calls[kMaxFunctions];
+    int functionCount = 0;
+
+    Call* find(const char* function) {
+        for (int i = 0; i < functionCount; i++) {
+            if (strcmp(calls[i].function, function) == 0) {
+                return &calls[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void count(const char* function, int imageWidth = 0, int imageStride = 0) {
+        const std::lock_guard<std::mutex> lock(callsMutex);
+        Call* call = find(function);
+        if (!call && functionCount < kMaxFunctions) {
+            call = &calls[functionCount++];
+            *call = {function, 0, 0, 0};
+        }
+        if (call) {
+            call->count++;
+            if (imageStride > 0) {
+                call->imageWidth = imageWidth;
+                call->imageStride = imageStride;
+            }
+        }
+    }
+
+    char handles[16];
+
+    bef_effect_handle_t newHandle() {
+        return &handles[0];
+    }
+}
+
+namespace agora {
+    namespace extension {
+        namespace test {
+            int stubCalls(const char* function) {
+                const std::lock_guard<std::mutex> lock(callsMutex);
+                Call* call = find(function);
+                return call ? call->count : 0;
+            }
+
+            int stubImageWidth(const char* function) {
+                const std::lock_guard<std::mutex> lock(callsMutex);
+                Call* call = find(function);
+                return call ? call->imageWidth : 0;
+            }
+
+            int stubImageStride(const char* function) {
+                const std::lock_guard<std::mutex> lock(callsMutex);
+                Call* call = find(function);
+                return call ? call->imageStride : 0;
+            }
+
+            void resetStubCalls() {
+                const std::lock_guard<std::mutex> lock(callsMutex);
+                functionCount = 0;
+            }
+        }
+    }
+}
+
+// colour conversion
+
+void cvt_yuv2rgba(const unsigned char*, unsigned char*, bef_ai_pixel_format, int, int, int, int,
+                  bef_ai_rotate_type, bool) {
+    count(__func__);
+}
+
+void cvt_rgba2yuv(const unsigned char*, unsigned char*, bef_ai_pixel_format, int, int) {
+    count(__func__);
+}
+
+// effect
+
+bef_effect_result_t bef_effect_ai_create(bef_effect_handle_t* handle) {
+    count(__func__);
+    *handle = newHandle();
+    return BEF_RESULT_SUC;
+}
+
+void bef_effect_ai_destroy(bef_effect_handle_t) {
+    count(__func__);
+}
+
+bef_effect_result_t bef_effect_ai_init(bef_effect_handle_t, int, int, const char*, const char*) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_composer_set_mode(bef_effect_handle_t, int, int) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_composer_set_nodes(bef_effect_handle_t, const char*[], int) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_composer_update_node(bef_effect_handle_t, const char*, const char*, float) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_set_width_height(bef_effect_handle_t, int, int) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_set_orientation(bef_effect_handle_t, bef_ai_rotate_type) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_set_effect(bef_effect_handle_t, const char*) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_algorithm_buffer(bef_effect_handle_t, const unsigned char*, bef_ai_pixel_format,
+                                                   int width, int, int stride, double) {
+    count(__func__, width, stride);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_process_buffer(bef_effect_handle_t, const unsigned char*, bef_ai_pixel_format,
+                                                 int width, int, int stride, unsigned char*, bef_ai_pixel_format,
+                                                 double) {
+    count(__func__, width, stride);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_algorithm_texture(bef_effect_handle_t, unsigned int, double) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_process_texture(bef_effect_handle_t, unsigned int, unsigned int, double) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+// face detection and attributes
+
+bef_effect_result_t bef_effect_ai_face_detect_create(unsigned long long, const char*, bef_effect_handle_t* handle) {
+    count(__func__);
+    *handle = newHandle();
+    return BEF_RESULT_SUC;
+}
+
+void bef_effect_ai_face_detect_destroy(bef_effect_handle_t) {
+    count(__func__);
+}
+
+bef_effect_result_t bef_effect_ai_face_detect_setparam(bef_effect_handle_t, bef_face_detect_type, float) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_face_detect(bef_effect_handle_t, const unsigned char*, bef_ai_pixel_format,
+                                              int width, int height, int stride, bef_ai_rotate_type, unsigned long long,
+                                              bef_ai_face_info* info) {
+    count(__func__, width, stride);
+    // one face in the middle, so the analyzers that need faces run too
+    memset(info, 0, sizeof(*info));
+    info->face_count = 1;
+    info->base_infos[0].ID = 1;
+    info->base_infos[0].score = 1;
+    info->base_infos[0].rect = {width / 4, height / 4, width * 3 / 4, height * 3 / 4};
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_face_attribute_create(unsigned long long, const char*, bef_effect_handle_t* handle) {
+    count(__func__);
+    *handle = newHandle();
+    return BEF_RESULT_SUC;
+}
+
+void bef_effect_ai_face_attribute_destroy(bef_effect_handle_t) {
+    count(__func__);
+}
+
+bef_effect_result_t bef_effect_ai_face_attribute_detect_batch(bef_effect_handle_t, const unsigned char*,
+                                                              bef_ai_pixel_format, int width, int, int stride,
+                                                              const bef_ai_face_106*, int, unsigned long long,
+                                                              bef_ai_face_attribute_result*) {
+    count(__func__, width, stride);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_human_distance_create(bef_effect_handle_t* handle) {
+    count(__func__);
+    *handle = newHandle();
+    return BEF_RESULT_SUC;
+}
+
+void bef_effect_ai_human_distance_destroy(bef_effect_handle_t) {
+    count(__func__);
+}
+
+bef_effect_result_t bef_effect_ai_human_distance_load_model(bef_effect_handle_t, bef_human_distance_model_type,
+                                                            const char*) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_human_distance_setparam(bef_effect_handle_t, bef_ai_human_distance_param_type,
+                                                          float) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_human_distance_detect(bef_effect_handle_t, const unsigned char*,
+                                                        bef_ai_pixel_format, int width, int, int stride,
+                                                        bef_ai_rotate_type, const bef_ai_face_info*,
+                                                        const bef_ai_face_attribute_result*,
+                                                        bef_ai_human_distance_result* result) {
+    count(__func__, width, stride);
+    memset(result, 0, sizeof(*result));
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_face_verify_create(const char*, const int, bef_effect_handle_t* handle) {
+    count(__func__);
+    *handle = newHandle();
+    return BEF_RESULT_SUC;
+}
+
+void bef_effect_ai_face_verify_destroy(bef_effect_handle_t) {
+    count(__func__);
+}
+
+bef_effect_result_t bef_effect_ai_face_extract_feature_single(bef_effect_handle_t, const unsigned char*,
+                                                              bef_ai_pixel_format, int width, int, int stride,
+                                                              bef_ai_rotate_type, const bef_ai_face_106*, float*) {
+    count(__func__, width, stride);
+    return BEF_RESULT_SUC;
+}
+
+// hands, body, light
+
+bef_effect_result_t bef_effect_ai_hand_detect_create(bef_ai_hand_sdk_handle* handle, unsigned int) {
+    count(__func__);
+    *handle = newHandle();
+    return BEF_RESULT_SUC;
+}
+
+void bef_effect_ai_hand_detect_destroy(bef_ai_hand_sdk_handle) {
+    count(__func__);
+}
+
+bef_effect_result_t bef_effect_ai_hand_detect_setmodel(bef_effect_handle_t, bef_ai_hand_model_type, const char*) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_hand_detect_setparam(bef_effect_handle_t, bef_ai_hand_param_type, float) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_hand_detect(bef_ai_hand_sdk_handle, const unsigned char*, bef_ai_pixel_format,
+                                              int width, int, int stride, bef_ai_rotate_type, unsigned long long,
+                                              bef_ai_hand_info* info, int) {
+    count(__func__, width, stride);
+    memset(info, 0, sizeof(*info));
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_skeleton_create(const char*, bef_effect_handle_t* handle) {
+    count(__func__);
+    *handle = newHandle();
+    return BEF_RESULT_SUC;
+}
+
+void bef_effect_ai_skeleton_destroy(bef_effect_handle_t) {
+    count(__func__);
+}
+
+bef_effect_result_t bef_effect_ai_skeleton_set_targetnum(bef_effect_handle_t, int) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_skeleton_set_tracking_inputsize(bef_effect_handle_t, int, int) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_skeleton_detect(bef_effect_handle_t, const unsigned char*, bef_ai_pixel_format,
+                                                  int width, int, int stride, bef_ai_rotate_type, int* count,
+                                                  bef_ai_skeleton_info** info) {
+    ::count(__func__, width, stride);
+    *count = 0;
+    *info = nullptr;
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_lightcls_create(bef_effect_handle_t* handle, const char*, int) {
+    count(__func__);
+    *handle = newHandle();
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_lightcls_release(bef_effect_handle_t) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_lightcls_detect(bef_effect_handle_t, const unsigned char*, bef_ai_pixel_format,
+                                                  int width, int, int stride, bef_ai_rotate_type,
+                                                  bef_ai_light_cls_result* result) {
+    count(__func__, width, stride);
+    memset(result, 0, sizeof(*result));
+    return BEF_RESULT_SUC;
+}
+
+// pets and gesture sequences
+
+bef_effect_result_t bef_effect_ai_pet_face_create(const char*, long long, unsigned int, bef_effect_handle_t* handle) {
+    count(__func__);
+    *handle = newHandle();
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_pet_face_release(bef_effect_handle_t) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_pet_face_detect(bef_effect_handle_t, const unsigned char*, bef_ai_pixel_format,
+                                                  int width, int, int stride, bef_ai_rotate_type,
+                                                  bef_ai_pet_face_result* result) {
+    count(__func__, width, stride);
+    memset(result, 0, sizeof(*result));
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_dynamic_action_create(bef_effect_handle_t* handle, unsigned int) {
+    count(__func__);
+    *handle = newHandle();
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_dynamic_action_release(bef_effect_handle_t) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_dynamic_action_load_model(bef_effect_handle_t, bef_ai_dynamic_action_model_type,
+                                                            const char*) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_dynamic_action_set_param(bef_effect_handle_t, bef_ai_dynamic_action_param_type,
+                                                           float) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_dynamic_action_detect(bef_effect_handle_t, const unsigned char*,
+                                                        bef_ai_pixel_format, int width, int, int stride,
+                                                        bef_ai_rotate_type, unsigned long long, int,
+                                                        bef_ai_dynamic_action_result* result,
+                                                        bef_ai_dynamic_action_sk* skeleton) {
+    count(__func__, width, stride);
+    memset(result, 0, sizeof(*result));
+    memset(skeleton, 0, sizeof(*skeleton));
+    return BEF_RESULT_SUC;
+}
+
+// segmentation
+
+bef_effect_result_t bef_effect_ai_portrait_matting_create(bef_effect_handle_t* handle) {
+    count(__func__);
+    *handle = newHandle();
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_portrait_matting_destroy(bef_effect_handle_t) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_portrait_matting_init_model(bef_effect_handle_t, bef_ai_matting_model_type,
+                                                              const char*) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_portrait_matting_set_param(bef_effect_handle_t, bef_ai_matting_param_type, int) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_portrait_get_output_shape(bef_effect_handle_t, int width, int height,
+                                                            int* outputWidth, int* outputHeight) {
+    count(__func__);
+    *outputWidth = (width + 7) / 8;
+    *outputHeight = (height + 7) / 8;
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_portrait_matting_do_detect(bef_effect_handle_t, const unsigned char*,
+                                                             bef_ai_pixel_format, int width, int, int stride,
+                                                             bef_ai_rotate_type, bool, bef_ai_matting_ret* ret) {
+    count(__func__, width, stride);
+    memset(ret->alpha, 255, (size_t)ret->width * ret->height);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_hairparser_create(bef_effect_handle_t* handle) {
+    count(__func__);
+    *handle = newHandle();
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_hairparser_destroy(bef_effect_handle_t) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_hairparser_init_model(bef_effect_handle_t, const char*) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_hairparser_set_param(bef_effect_handle_t, int, int, bool, bool) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_hairparser_get_output_shape(bef_effect_handle_t, int* width, int* height,
+                                                              int* channels) {
+    count(__func__);
+    *width = 16;
+    *height = 16;
+    *channels = 1;
+    return BEF_RESULT_SUC;
+}
+
+bef_effect_result_t bef_effect_ai_hairparser_do_detect(bef_effect_handle_t, const unsigned char*,
+                                                       bef_ai_pixel_format, int width, int, int stride,
+                                                       bef_ai_rotate_type, unsigned char* alpha, bool) {
+    count(__func__, width, stride);
+    memset(alpha, 0, 16 * 16);
+    return BEF_RESULT_SUC;
+}
+
+int BEF_AI_HSeg_CreateHandler(bef_ai_headseg_handle* out) {
+    count(__func__);
+    *out = 1;
+    return BEF_RESULT_SUC;
+}
+
+int BEF_AI_HSeg_CheckLicense(bef_ai_headseg_handle, const char*) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+int BEF_AI_HSeg_SetConfig(bef_ai_headseg_handle, bef_ai_headseg_config*) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+int BEF_AI_HSeg_SetModelFromBuff(bef_ai_headseg_handle, const unsigned char*, unsigned int) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+int BEF_AI_HSeg_SetParam(bef_ai_headseg_handle, bef_ai_headseg_paramtype, float) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+int BEF_AI_HSeg_InitModel(bef_ai_headseg_handle, const char*) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
+
+int BEF_AI_HSeg_DoHeadSeg(bef_ai_headseg_handle, bef_ai_headseg_input* input, bef_ai_headseg_output* output) {
+    count(__func__, input->image_width, input->image_stride);
+    output->face_result = nullptr;
+    output->face_count = 0;
+    return BEF_RESULT_SUC;
+}
+
+int BEF_AI_HSeg_ReleaseHandle(bef_ai_headseg_handle) {
+    count(__func__);
+    return BEF_RESULT_SUC;
+}
@@ -0,0 +1,32 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_BYTEDANCESTUBS_H
+#define AGORAWITHBYTEDANCE_BYTEDANCESTUBS_H
+
+namespace agora {
+    namespace extension {
+        namespace test {
+            /**
+             * ByteDanceStubs.cpp defines every ByteDance SDK function the video
+             * processor calls. Each one counts its calls and succeeds: handles are
+             * non-null, face detection finds one face and the other detectors
+             * nothing, segmentation fills a blank mask and the colour conversions
+             * leave their output alone.
+             */
+
+            // calls of the named function since the last resetStubCalls()
+            int stubCalls(const char* function);
+
+            // image width and stride the named function was last given, 0 if none
+            int stubImageWidth(const char* function);
+
+            int stubImageStride(const char* function);
+
+            void resetStubCalls();
+        }
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_BYTEDANCESTUBS_H
@@ -0,0 +1,139 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "FaceGallery.h"
+#include "HostTest.h"
+
+using namespace agora::extension;
+
+namespace {
+    // not a multiple of the 8 dot product lanes, so the tail is summed too
+    const int kDimension = 13;
+
+    // a feature along one axis, scaled
+    std::vector<float> axis(int index, float scale = 1) {
+        std::vector<float> feature(kDimension, 0.0f);
+        feature[index] = scale;
+        return feature;
+    }
+
+    // a deterministic, unnormalized feature of its own per seed
+    std::vector<float> pseudoRandom(int seed) {
+        std::vector<float> feature(kDimension);
+        uint32_t state = 2654435761u * (uint32_t)(seed + 1);
+        for (float& value : feature) {
+            state = state * 1664525u + 1013904223u;
+            value = (float)(state >> 8) / (1 << 24) - 0.5f;
+        }
+        return feature;
+    }
+}
+
+// Scores are cosine similarities: the scale of either vector does not matter.
+HOST_TEST(cosineSimilarity) {
+    FaceGallery gallery(kDimension);
+    EXPECT_EQ(gallery.dimension(), kDimension);
+    gallery.enroll("x", axis(0, 5).data());
+    gallery.enroll("y", axis(1, 0.25f).data());
+
+    float similarity = 0;
+    EXPECT_EQ(gallery.match(axis(0, 0.1f).data(), 0.5f, &similarity), 0);
+    EXPECT_NEAR(similarity, 1.0f, 1e-6);
+    EXPECT_EQ(gallery.match(axis(1, 300).data(), 0.5f, &similarity), 1);
+    EXPECT_NEAR(similarity, 1.0f, 1e-6);
+
+    // between both axes, closer to y
+    std::vector<float> query(kDimension, 0.0f);
+    query[0] = 3;
+    query[1] = 4;
+    EXPECT_EQ(gallery.match(query.data(), 0.5f, &similarity), 1);
+    EXPECT_NEAR(similarity, 0.8f, 1e-6);
+
+    // opposite, orthogonal and empty queries match nothing and report 0
+    EXPECT_EQ(gallery.match(axis(0, -1).data(), 0.01f, &similarity), -1);
+    EXPECT_EQ(similarity, 0.0f);
+    EXPECT_EQ(gallery.match(axis(2).data(), 0.01f, &similarity), -1);
+    std::vector<float> zero(kDimension, 0.0f);
+    EXPECT_EQ(gallery.match(zero.data(), 0.01f, nullptr), -1);
+
+    // a full vector is matched to itself, against the others
+    FaceGallery crowd(kDimension);
+    for (int i = 0; i < 20; i++) {
+        crowd.enroll("face" + std::to_string(i), pseudoRandom(i).data());
+    }
+    for (int i = 0; i < 20; i++) {
+        std::vector<float> feature = pseudoRandom(i);
+        for (float& value : feature) {
+            value *= 3;
+        }
+        int index = crowd.match(feature.data(), 0.99f, &similarity);
+        if (index != i) {
+            EXPECT_EQ(index, i);
+            printf("  face%d\n", i);
+        }
+        EXPECT_NEAR(similarity, 1.0f, 1e-5);
+    }
+}
+
+// Every new name takes a row, an enrolled name is replaced in place, and
+// removing keeps the remaining names matchable.
+HOST_TEST(enrollmentCapacity) {
+    const int kFaces = 500;
+    FaceGallery gallery(kDimension);
+    for (int i = 0; i < kFaces; i++) {
+        gallery.enroll("face" + std::to_string(i), pseudoRandom(i).data());
+    }
+    EXPECT_EQ(gallery.size(), kFaces);
+    EXPECT_TRUE(gallery.name(kFaces - 1) == "face" + std::to_string(kFaces - 1));
+
+    // re-enrolling replaces the feature, the size stays
+    gallery.enroll("face7", pseudoRandom(kFaces).data());
+    EXPECT_EQ(gallery.size(), kFaces);
+    float similarity = 0;
+    EXPECT_EQ(gallery.match(pseudoRandom(kFaces).data(), 0.99f, &similarity), 7);
+
+    // the last row fills the hole of a removed one
+    EXPECT_TRUE(gallery.remove("face3"));
+    EXPECT_TRUE(!gallery.remove("face3"));
+    EXPECT_EQ(gallery.size(), kFaces - 1);
+    EXPECT_TRUE(gallery.name(3) == "face" + std::to_string(kFaces - 1));
+    EXPECT_EQ(gallery.match(pseudoRandom(kFaces - 1).data(), 0.99f, &similarity), 3);
+    EXPECT_EQ(gallery.match(pseudoRandom(3).data(), 0.99f, &similarity), -1);
+
+    gallery.clear();
+    EXPECT_EQ(gallery.size(), 0);
+    EXPECT_EQ(gallery.match(pseudoRandom(0).data(), -1.0f, &similarity), -1);
+    gallery.enroll("again", axis(4).data());
+    EXPECT_EQ(gallery.match(axis(4).data(), 0.99f, nullptr), 0);
+}
+
+// A score equal to the threshold matches, a threshold just above it does not.
+HOST_TEST(thresholdBoundary) {
+    FaceGallery gallery(kDimension);
+    gallery.enroll("x", axis(0).data());
+    std::vector<float> query(kDimension, 0.0f);
+    query[0] = 3;
+    query[1] = 4;
+
+    float score = 0;
+    ASSERT_TRUE(gallery.match(query.data(), -1.0f, &score) == 0);
+    EXPECT_NEAR(score, 0.6f, 1e-6);
+
+    float similarity = 0;
+    EXPECT_EQ(gallery.match(query.data(), score, &similarity), 0);
+    EXPECT_EQ(similarity, score);
+    EXPECT_EQ(gallery.match(query.data(), std::nextafter(score, 2.0f), &similarity), -1);
+    EXPECT_EQ(similarity, 0.0f);
+
+    // of two at or above the threshold the better one wins
+    gallery.enroll("y", axis(1).data());
+    EXPECT_EQ(gallery.match(query.data(), score, &similarity), 1);
+    EXPECT_NEAR(similarity, 0.8f, 1e-6);
+}
@@ -0,0 +1,125 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <cstdint>
+#include <vector>
+
+#include "FrameClock.h"
+#include "HostTest.h"
+
+using namespace agora::extension;
+
+namespace {
+    std::vector<FrameTime> replay(FrameClock& clock, const std::vector<int64_t>& renderTimesMs) {
+        std::vector<FrameTime> times;
+        for (int64_t renderTimeMs : renderTimesMs) {
+            times.push_back(clock.tick(renderTimeMs));
+        }
+        return times;
+    }
+
+    bool same(const FrameTime& a, const FrameTime& b) {
+        return a.timestampMs == b.timestampMs && a.intervalMs == b.intervalMs && a.duplicate == b.duplicate &&
+               a.discontinuity == b.discontinuity && a.fallback == b.fallback;
+    }
+}
+
+// A regular stream keeps its renderTimeMs.
+HOST_TEST(monotonicPassthrough) {
+    FrameClock clock;
+    std::vector<FrameTime> times = replay(clock, {1000, 1033, 1066, 1100});
+    EXPECT_EQ(times[0].timestampMs, (int64_t)1000);
+    EXPECT_EQ(times[0].intervalMs, (int64_t)0);
+    EXPECT_TRUE(times[0].discontinuity);
+    for (size_t i = 1; i < times.size(); i++) {
+        EXPECT_TRUE(!times[i].discontinuity && !times[i].duplicate && !times[i].fallback);
+    }
+    EXPECT_EQ(times[3].timestampMs, (int64_t)1100);
+    EXPECT_EQ(times[3].intervalMs, (int64_t)34);
+}
+
+// A repeated renderTimeMs keeps the timestamp and reports no time passing.
+HOST_TEST(duplicateRenderTime) {
+    FrameClock clock;
+    std::vector<FrameTime> times = replay(clock, {1000, 1033, 1033, 1066});
+    EXPECT_TRUE(times[2].duplicate);
+    EXPECT_TRUE(!times[2].discontinuity);
+    EXPECT_EQ(times[2].timestampMs, (int64_t)1033);
+    EXPECT_EQ(times[2].intervalMs, (int64_t)0);
+    EXPECT_TRUE(!times[3].duplicate);
+    EXPECT_EQ(times[3].timestampMs, (int64_t)1066);
+    EXPECT_EQ(times[3].intervalMs, (int64_t)33);
+}
+
+// A looped source restarts one interval after the last timestamp and runs on from there.
+HOST_TEST(rewindContinuesForward) {
+    FrameClock clock;
+    std::vector<FrameTime> times = replay(clock, {1000, 1033, 1066, 500, 533});
+    EXPECT_TRUE(times[3].discontinuity);
+    EXPECT_EQ(times[3].timestampMs, (int64_t)1066 + clock.intervalMs());
+    EXPECT_TRUE(times[3].intervalMs > 0);
+    EXPECT_TRUE(!times[4].discontinuity);
+    EXPECT_EQ(times[4].timestampMs, times[3].timestampMs + 33);
+}
+
+// A stall keeps its length but is flagged, and does not skew the interval estimate.
+HOST_TEST(gapIsADiscontinuity) {
+    FrameClock clock;
+    std::vector<FrameTime> times = replay(clock, {1000, 1033, 1066, 1066 + FrameClock::kMaxIntervalMs + 1});
+    EXPECT_TRUE(times[3].discontinuity);
+    EXPECT_EQ(times[3].timestampMs, (int64_t)1066 + FrameClock::kMaxIntervalMs + 1);
+    EXPECT_EQ(times[3].intervalMs, FrameClock::kMaxIntervalMs + 1);
+    EXPECT_EQ(clock.intervalMs(), (int64_t)33);
+
+    // up to kMaxIntervalMs is a regular, if slow, frame
+    FrameClock slow;
+    std::vector<FrameTime> slowTimes = replay(slow, {1000, 1000 + FrameClock::kMaxIntervalMs});
+    EXPECT_TRUE(!slowTimes[1].discontinuity);
+}
+
+// Frames without renderTimeMs are stamped by the steady clock; every switch of
+// source is a discontinuity and the timeline never runs backwards.
+HOST_TEST(steadyClockFallbackAndBack) {
+    FrameClock clock;
+    std::vector<FrameTime> times = replay(clock, {1000, 1033, 0, 0, 0, 5000, 5033});
+    EXPECT_TRUE(!times[1].fallback);
+
+    EXPECT_TRUE(times[2].fallback);
+    EXPECT_TRUE(times[2].discontinuity);
+    EXPECT_EQ(times[2].timestampMs, (int64_t)1033 + 33);
+    for (size_t i = 3; i < 5; i++) {
+        EXPECT_TRUE(times[i].fallback);
+        // steady clock frames are never duplicates, even within the same millisecond
+        EXPECT_TRUE(!times[i].duplicate);
+        EXPECT_TRUE(times[i].timestampMs >= times[i - 1].timestampMs);
+    }
+
+    EXPECT_TRUE(!times[5].fallback);
+    EXPECT_TRUE(times[5].discontinuity);
+    EXPECT_TRUE(times[5].timestampMs > times[4].timestampMs);
+    EXPECT_TRUE(!times[6].discontinuity);
+    EXPECT_EQ(times[6].timestampMs, times[5].timestampMs + 33);
+}
+
+// The same renderTimeMs sequence gives the same timeline, however it is replayed.
+HOST_TEST(replaysAreIdentical) {
+    const std::vector<int64_t> sequence = {1000, 1033, 1033, 1070, 1100, 400, 433, 466, 2000, 2033, 2033, 2066};
+
+    FrameClock first;
+    FrameClock second;
+    std::vector<FrameTime> a = replay(first, sequence);
+    std::vector<FrameTime> b = replay(second, sequence);
+    second.reset();
+    std::vector<FrameTime> c = replay(second, sequence);
+
+    ASSERT_TRUE(a.size() == b.size() && a.size() == c.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        EXPECT_TRUE(same(a[i], b[i]));
+        EXPECT_TRUE(same(a[i], c[i]));
+        if (i > 0) {
+            EXPECT_TRUE(a[i].timestampMs >= a[i - 1].timestampMs);
+        }
+    }
+    EXPECT_TRUE(same(first.last(), a.back()));
+}
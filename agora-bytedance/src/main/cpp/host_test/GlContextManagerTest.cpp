@@ -0,0 +1,281 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "GlContextManager.h"
+#include "HostTest.h"
+
+using namespace agora::extension;
+
+namespace {
+    // what the mock EGL saw, shared with the test after the manager took the backend
+    struct EglLog {
+        std::mutex mutex;
+        int contextsCreated = 0;
+        int contextsDestroyed = 0;
+        int surfacesDestroyed = 0;
+        int makeCurrentCalls = 0;
+        int objectsCreated = 0;
+        std::vector<int> surfaceWidths;
+        std::vector<unsigned int> deletedObjects;
+        // a GL call made on a thread its context is not current on
+        bool wrongThread = false;
+    };
+
+    struct CurrentBinding {
+        void* context = nullptr;
+        void* surface = nullptr;
+    };
+
+    thread_local CurrentBinding current;
+
+    class MockEglBackend : public GlBackend {
+    public:
+        explicit MockEglBackend(std::shared_ptr<EglLog> log) : log_(std::move(log)) {}
+
+        void* createContext() override {
+            const std::lock_guard<std::mutex> lock(log_->mutex);
+            log_->contextsCreated++;
+            return reinterpret_cast<void*>(++nextHandle_);
+        }
+
+        void destroyContext(void*) override {
+            const std::lock_guard<std::mutex> lock(log_->mutex);
+            log_->contextsDestroyed++;
+        }
+
+        void* createSurface(void*, int width, int) override {
+            const std::lock_guard<std::mutex> lock(log_->mutex);
+            log_->surfaceWidths.push_back(width);
+            return reinterpret_cast<void*>(++nextHandle_);
+        }
+
+        void destroySurface(void*, void* surface) override {
+            const std::lock_guard<std::mutex> lock(log_->mutex);
+            log_->surfacesDestroyed++;
+            // EGL keeps a surface that is still current alive, the manager lets go first
+            if (current.surface == surface) {
+                log_->wrongThread = true;
+            }
+        }
+
+        bool isCurrent(void* context, void* surface) override {
+            return current.context == context && current.surface == surface;
+        }
+
+        void makeCurrent(void* context, void* surface) override {
+            const std::lock_guard<std::mutex> lock(log_->mutex);
+            log_->makeCurrentCalls++;
+            current.context = context;
+            current.surface = surface;
+        }
+
+        void makeNothingCurrent(void*) override {
+            current = CurrentBinding();
+        }
+
+        unsigned int createObject(const GlObjectKey&) override {
+            const std::lock_guard<std::mutex> lock(log_->mutex);
+            log_->objectsCreated++;
+            log_->wrongThread = log_->wrongThread || !current.context;
+            return ++nextObject_;
+        }
+
+        void deleteObject(GL_OBJECT_KIND, unsigned int name) override {
+            const std::lock_guard<std::mutex> lock(log_->mutex);
+            log_->deletedObjects.push_back(name);
+            log_->wrongThread = log_->wrongThread || !current.context;
+        }
+
+    private:
+        std::shared_ptr<EglLog> log_;
+        uintptr_t nextHandle_ = 0;
+        unsigned int nextObject_ = 0;
+    };
+
+    // installs a fresh mock on the process-wide manager, and drops it again
+    struct MockEgl {
+        std::shared_ptr<EglLog> log = std::make_shared<EglLog>();
+
+        MockEgl() {
+            GlContextManager::getInstance().setBackend(std::unique_ptr<GlBackend>(new MockEglBackend(log)));
+        }
+
+        ~MockEgl() {
+            GlContextManager::getInstance().releaseAll();
+            GlContextManager::getInstance().setBackend(nullptr);
+            current = CurrentBinding();
+        }
+    };
+
+    const GlObjectKey kTexture = {GL_OBJECT_TEXTURE, 64, 64, 0x8058};
+}
+
+HOST_TEST(noBackendNoContext) {
+    GlContextManager& manager = GlContextManager::getInstance();
+    EXPECT_TRUE(manager.bind(nullptr, 64, 64) == nullptr);
+    EXPECT_EQ(manager.contextCount(), 0);
+}
+
+// One context per thread, made current once and kept current.
+HOST_TEST(bindKeepsOneContextPerThread) {
+    MockEgl egl;
+    GlContextManager& manager = GlContextManager::getInstance();
+
+    GlContextManager::Context* context = manager.bind(nullptr, 64, 64);
+    ASSERT_TRUE(context != nullptr);
+    EXPECT_TRUE(manager.isOwner(context));
+    for (int i = 0; i < 10; i++) {
+        EXPECT_TRUE(manager.bind(context, 64, 64) == context);
+    }
+    EXPECT_EQ(egl.log->contextsCreated, 1);
+    EXPECT_EQ(egl.log->makeCurrentCalls, 1);
+
+    GlContextManager::Context* other = nullptr;
+    bool otherOwned = true;
+    std::thread thread([&] {
+        other = manager.bind(nullptr, 64, 64);
+        otherOwned = manager.isOwner(context);
+    });
+    thread.join();
+    EXPECT_TRUE(other != nullptr && other != context);
+    EXPECT_TRUE(!otherOwned);
+    EXPECT_EQ(manager.contextCount(), 2);
+    EXPECT_EQ(egl.log->contextsCreated, 2);
+}
+
+// The surface follows the largest frame, a smaller one keeps it.
+HOST_TEST(surfaceOnlyGrows) {
+    MockEgl egl;
+    GlContextManager& manager = GlContextManager::getInstance();
+
+    GlContextManager::Context* context = manager.bind(nullptr, 64, 64);
+    manager.bind(context, 32, 32);
+    manager.bind(context, 128, 16);
+    EXPECT_EQ(egl.log->surfaceWidths.size(), (size_t)2);
+    EXPECT_EQ(egl.log->surfaceWidths.back(), 128);
+    EXPECT_EQ(egl.log->surfacesDestroyed, 1);
+    EXPECT_TRUE(!egl.log->wrongThread);
+    // the new surface is made current
+    EXPECT_EQ(egl.log->makeCurrentCalls, 2);
+}
+
+// Recycled objects go out again for the same key; idle ones are deleted, used ones never.
+HOST_TEST(objectsAreRecycledAndTrimmed) {
+    MockEgl egl;
+    GlContextManager& manager = GlContextManager::getInstance();
+
+    GlContextManager::Context* context = manager.bind(nullptr, 64, 64);
+    unsigned int first = manager.acquire(context, kTexture);
+    unsigned int held = manager.acquire(context, kTexture);
+    EXPECT_TRUE(first != held);
+    manager.recycle(context, GL_OBJECT_TEXTURE, first);
+    EXPECT_EQ(manager.acquire(context, kTexture), first);
+    EXPECT_EQ(egl.log->objectsCreated, 2);
+
+    // another size or kind is another object
+    GlObjectKey larger = kTexture;
+    larger.width = 128;
+    EXPECT_TRUE(manager.acquire(context, larger) != first);
+    GlObjectKey framebuffer = {GL_OBJECT_FRAMEBUFFER, 64, 64, 0};
+    unsigned int fbo = manager.acquire(context, framebuffer);
+    EXPECT_EQ(egl.log->objectsCreated, 4);
+
+    manager.recycle(context, GL_OBJECT_TEXTURE, first);
+    // a name recycled as the wrong kind is ignored
+    manager.recycle(context, GL_OBJECT_TEXTURE, fbo);
+    for (int i = 0; i < GlContextManager::kIdleFrames; i++) {
+        manager.bind(context, 64, 64);
+    }
+    EXPECT_TRUE(egl.log->deletedObjects.empty());
+    manager.bind(context, 64, 64);
+    EXPECT_EQ(egl.log->deletedObjects.size(), (size_t)1);
+    EXPECT_EQ(egl.log->deletedObjects[0], first);
+    EXPECT_TRUE(!egl.log->wrongThread);
+}
+
+// Several users on one thread share the context; the last release on the owner deletes it all.
+HOST_TEST(ownerReleaseDestroysEverything) {
+    MockEgl egl;
+    GlContextManager& manager = GlContextManager::getInstance();
+
+    GlContextManager::Context* first = manager.bind(nullptr, 64, 64);
+    GlContextManager::Context* second = manager.bind(nullptr, 64, 64);
+    EXPECT_TRUE(first == second);
+    manager.acquire(first, kTexture);
+    manager.acquire(first, {GL_OBJECT_PIXEL_BUFFER, 64, 64, 0});
+
+    manager.release(first);
+    EXPECT_EQ(manager.contextCount(), 1);
+    EXPECT_EQ(egl.log->contextsDestroyed, 0);
+
+    manager.release(second);
+    EXPECT_EQ(manager.contextCount(), 0);
+    EXPECT_EQ(egl.log->deletedObjects.size(), (size_t)2);
+    EXPECT_EQ(egl.log->surfacesDestroyed, 1);
+    EXPECT_EQ(egl.log->contextsDestroyed, 1);
+    EXPECT_TRUE(!egl.log->wrongThread);
+    EXPECT_TRUE(current.context == nullptr);
+}
+
+// Released from another thread, the EGL objects go but no GL call is made
+// without the context current.
+HOST_TEST(foreignReleaseSkipsGlCalls) {
+    MockEgl egl;
+    GlContextManager& manager = GlContextManager::getInstance();
+
+    GlContextManager::Context* context = nullptr;
+    std::thread owner([&] {
+        context = manager.bind(nullptr, 64, 64);
+        manager.acquire(context, kTexture);
+    });
+    owner.join();
+
+    EXPECT_TRUE(!manager.isOwner(context));
+    manager.release(context);
+    EXPECT_EQ(manager.contextCount(), 0);
+    EXPECT_TRUE(egl.log->deletedObjects.empty());
+    EXPECT_EQ(egl.log->surfacesDestroyed, 1);
+    EXPECT_EQ(egl.log->contextsDestroyed, 1);
+    EXPECT_TRUE(!egl.log->wrongThread);
+}
+
+// A caller that moved threads uses the new thread's context and gives up the old one.
+HOST_TEST(callerMovingThreadsSwitchesContext) {
+    MockEgl egl;
+    GlContextManager& manager = GlContextManager::getInstance();
+
+    GlContextManager::Context* old = manager.bind(nullptr, 64, 64);
+    GlContextManager::Context* moved = nullptr;
+    std::thread thread([&] {
+        moved = manager.bind(old, 64, 64);
+        EXPECT_TRUE(manager.bind(moved, 64, 64) == moved);
+    });
+    thread.join();
+
+    EXPECT_TRUE(moved != nullptr && moved != old);
+    EXPECT_EQ(manager.contextCount(), 1);
+    EXPECT_EQ(egl.log->contextsDestroyed, 1);
+    manager.release(moved);
+    EXPECT_EQ(manager.contextCount(), 0);
+}
+
+// The backend cannot change under live contexts.
+HOST_TEST(backendStaysWhileContextsLive) {
+    MockEgl egl;
+    GlContextManager& manager = GlContextManager::getInstance();
+
+    GlContextManager::Context* context = manager.bind(nullptr, 64, 64);
+    std::shared_ptr<EglLog> otherLog = std::make_shared<EglLog>();
+    manager.setBackend(std::unique_ptr<GlBackend>(new MockEglBackend(otherLog)));
+    manager.acquire(context, kTexture);
+    EXPECT_EQ(egl.log->objectsCreated, 1);
+    EXPECT_EQ(otherLog->objectsCreated, 0);
+}
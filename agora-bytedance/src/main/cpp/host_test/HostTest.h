@@ -0,0 +1,85 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_HOSTTEST_H
+#define AGORAWITHBYTEDANCE_HOSTTEST_H
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace agora {
+    namespace extension {
+        namespace test {
+            typedef void (*TestFunction)();
+
+            struct TestCase {
+                const char* name;
+                TestFunction function;
+            };
+
+            std::vector<TestCase>& registry();
+
+            struct TestRegistrar {
+                TestRegistrar(const char* name, TestFunction function) {
+                    registry().push_back({name, function});
+                }
+            };
+
+            // marks the running case failed, it keeps running
+            void reportFailure(const char* file, int line, const std::string& message);
+
+            // runs every case whose name contains one of the arguments, all of them without arguments
+            int runAll(int argc, char** argv);
+
+            template <class A, class B>
+            std::string describe(const char* expression, const A& a, const B& b) {
+                std::ostringstream out;
+                out << expression << " (" << a << " vs " << b << ")";
+                return out.str();
+            }
+        }
+    }
+}
+
+// Each test executable is a list of cases run by HostTestMain.cpp.
+#define HOST_TEST(name) \
+    static void name(); \
+    static agora::extension::test::TestRegistrar name##Registrar_(#name, name); \
+    static void name()
+
+#define EXPECT_TRUE(cond) do { \
+    if (!(cond)) { \
+        agora::extension::test::reportFailure(__FILE__, __LINE__, #cond); \
+    } \
+} while (0)
+
+#define EXPECT_EQ(a, b) do { \
+    auto a_ = (a); \
+    auto b_ = (b); \
+    if (!(a_ == b_)) { \
+        agora::extension::test::reportFailure(__FILE__, __LINE__, \
+                agora::extension::test::describe(#a " == " #b, a_, b_)); \
+    } \
+} while (0)
+
+#define EXPECT_NEAR(a, b, tolerance) do { \
+    double a_ = (a); \
+    double b_ = (b); \
+    if (!(std::fabs(a_ - b_) <= (tolerance))) { \
+        agora::extension::test::reportFailure(__FILE__, __LINE__, \
+                agora::extension::test::describe(#a " ~= " #b, a_, b_)); \
+    } \
+} while (0)
+
+// stops the case, for preconditions the rest of it depends on
+#define ASSERT_TRUE(cond) do { \
+    if (!(cond)) { \
+        agora::extension::test::reportFailure(__FILE__, __LINE__, #cond); \
+        return; \
+    } \
+} while (0)
+
+#endif //AGORAWITHBYTEDANCE_HOSTTEST_H
@@ -0,0 +1,60 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "HostTest.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace agora {
+    namespace extension {
+        namespace test {
+            namespace {
+                int caseFailures = 0;
+            }
+
+            std::vector<TestCase>& registry() {
+                static std::vector<TestCase> cases;
+                return cases;
+            }
+
+            void reportFailure(const char* file, int line, const std::string& message) {
+                fprintf(stderr, "%s:%d: failed: %s\n", file, line, message.c_str());
+                caseFailures++;
+            }
+
+            int runAll(int argc, char** argv) {
+                int run = 0;
+                int failed = 0;
+                for (const TestCase& testCase : registry()) {
+                    bool selected = argc <= 1;
+                    for (int i = 1; i < argc && !selected; i++) {
+                        selected = strstr(testCase.name, argv[i]) != nullptr;
+                    }
+                    if (!selected) {
+                        continue;
+                    }
+                    printf("[ RUN      ] %s\n", testCase.name);
+                    fflush(stdout);
+                    caseFailures = 0;
+                    testCase.function();
+                    run++;
+                    if (caseFailures > 0) {
+                        failed++;
+                        printf("[  FAILED  ] %s\n", testCase.name);
+                    } else {
+                        printf("[       OK ] %s\n", testCase.name);
+                    }
+                    fflush(stdout);
+                }
+                printf("%d of %d cases passed\n", run - failed, run);
+                return failed > 0 || run == 0 ? 1 : 0;
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    return agora::extension::test::runAll(argc, argv);
+}
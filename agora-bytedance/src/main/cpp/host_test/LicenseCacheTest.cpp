@@ -0,0 +1,96 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+#include "HostTest.h"
+#include "LicenseCache.h"
+
+using namespace agora::extension;
+
+namespace {
+    // a license file of its own per case, the cache is process-wide
+    struct LicenseFile {
+        std::string path;
+
+        explicit LicenseFile(const char* name) : path(std::string("/tmp/license_cache_test_") + name + "_" +
+                                                      std::to_string(getpid()) + ".licbag") {
+            write("license");
+        }
+
+        ~LicenseFile() { remove(path.c_str()); }
+
+        void write(const char* content) {
+            FILE* file = fopen(path.c_str(), "wb");
+            fputs(content, file);
+            fclose(file);
+        }
+    };
+
+    struct CountingCheck {
+        bef_effect_result_t result;
+        int calls = 0;
+
+        bef_effect_result_t check(const char* feature, const std::string& path) {
+            return LicenseCache::getInstance().check(feature, path, [this] {
+                calls++;
+                return result;
+            });
+        }
+    };
+}
+
+// A rejected license is not checked again for the same feature.
+HOST_TEST(rejectionIsRemembered) {
+    LicenseFile license("rejected");
+    CountingCheck face{BEF_RESULT_LICENSE_STATUS_EXPIRED};
+    EXPECT_EQ(face.check("face", license.path), BEF_RESULT_LICENSE_STATUS_EXPIRED);
+    EXPECT_EQ(face.check("face", license.path), BEF_RESULT_LICENSE_STATUS_EXPIRED);
+    EXPECT_EQ(face.calls, 1);
+
+    // another feature asks the SDK itself
+    CountingCheck hand{BEF_RESULT_SUC};
+    EXPECT_EQ(hand.check("hand", license.path), BEF_RESULT_SUC);
+    EXPECT_EQ(hand.calls, 1);
+}
+
+// Every new handle has to be authorized, an accepted license is checked each time.
+HOST_TEST(acceptanceIsCheckedPerHandle) {
+    LicenseFile license("accepted");
+    CountingCheck face{BEF_RESULT_SUC};
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(face.check("face", license.path), BEF_RESULT_SUC);
+    }
+    EXPECT_EQ(face.calls, 3);
+}
+
+// Errors that are not about the license may pass on a retry.
+HOST_TEST(otherErrorsAreRetried) {
+    LicenseFile license("retried");
+    CountingCheck face{BEF_RESULT_FAIL};
+    face.check("face", license.path);
+    face.check("face", license.path);
+    EXPECT_EQ(face.calls, 2);
+}
+
+// A license replaced on disk is checked again.
+HOST_TEST(replacedFileIsANewLicense) {
+    LicenseFile license("replaced");
+    CountingCheck face{BEF_RESULT_INVALID_LICENSE};
+    face.check("face", license.path);
+    license.write("renewed license");
+    face.result = BEF_RESULT_SUC;
+    EXPECT_EQ(face.check("face", license.path), BEF_RESULT_SUC);
+    EXPECT_EQ(face.calls, 2);
+}
+
+// Without a file to key the verdict on, every check reaches the SDK.
+HOST_TEST(missingFileIsNotCached) {
+    CountingCheck face{BEF_RESULT_INVALID_LICENSE};
+    face.check("face", "/nonexistent/license.licbag");
+    face.check("face", "/nonexistent/license.licbag");
+    EXPECT_EQ(face.calls, 2);
+}
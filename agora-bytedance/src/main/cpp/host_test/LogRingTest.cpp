@@ -0,0 +1,288 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+// LogRing is process-wide: every case sends the lines to its own control and
+// log file, and posts from call sites of its own.
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "AgoraRtcKit/NGIAgoraExtensionControl.h"
+#include "HostTest.h"
+#include "LogRing.h"
+
+using namespace agora::extension;
+
+namespace {
+    const agora::commons::LOG_LEVEL kInfo = agora::commons::LOG_LEVEL::LOG_LEVEL_INFO;
+
+    // the arguments of a record, laid out as LogRing stores them
+    class Args {
+    public:
+        Args& i(int64_t value) { return put('i', &value, sizeof(value)); }
+
+        Args& u(uint64_t value) { return put('u', &value, sizeof(value)); }
+
+        Args& d(double value) { return put('d', &value, sizeof(value)); }
+
+        Args& s(const char* value, bool clipped = false) {
+            uint16_t length = (uint16_t)strlen(value);
+            uint16_t encoded = clipped ? (uint16_t)(length | 0x8000) : length;
+            bytes_.push_back('s');
+            bytes_.append((const char*)&encoded, sizeof(encoded));
+            bytes_.append(value, length);
+            return *this;
+        }
+
+        std::string format(const char* format, size_t size = 256) const {
+            std::vector<char> out(size);
+            size_t length = LogRing::format(format, bytes_.data(), bytes_.size(), out.data(), out.size());
+            EXPECT_EQ(length, strlen(out.data()));
+            return std::string(out.data(), length);
+        }
+
+    private:
+        Args& put(char tag, const void* value, size_t size) {
+            bytes_.push_back(tag);
+            bytes_.append((const char*)value, size);
+            return *this;
+        }
+
+        std::string bytes_;
+    };
+
+    // the engine log: keeps the lines, and can hold the consumer inside log()
+    class RecordingControl : public agora::rtc::IExtensionControl {
+    public:
+        void getCapabilities(Capabilities&) override {}
+
+        agora::agora_refptr<agora::rtc::IVideoFrame> createVideoFrame(agora::rtc::IVideoFrame::Type,
+                agora::rtc::IVideoFrame::Format, int, int) override {
+            return nullptr;
+        }
+
+        agora::agora_refptr<agora::rtc::IVideoFrame> copyVideoFrame(
+                agora::agora_refptr<agora::rtc::IVideoFrame>) override {
+            return nullptr;
+        }
+
+        void recycleVideoCache(agora::rtc::IVideoFrame::Type) override {}
+
+        int dumpVideoFrame(agora::agora_refptr<agora::rtc::IVideoFrame>, const char*) override { return 0; }
+
+        int fireEvent(const char*, const char*, const char*) override { return 0; }
+
+        int log(agora::commons::LOG_LEVEL, const char* message) override {
+            std::unique_lock<std::mutex> lock(mutex_);
+            lines_.push_back(message);
+            entered_.notify_all();
+            held_.wait(lock, [this] { return !holding_; });
+            return 0;
+        }
+
+        void hold() {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            holding_ = true;
+        }
+
+        void release() {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            holding_ = false;
+            held_.notify_all();
+        }
+
+        // true once the consumer is inside log()
+        bool waitForEntry() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            return entered_.wait_for(lock, std::chrono::seconds(5), [this] { return !lines_.empty(); });
+        }
+
+        std::vector<std::string> lines() {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            return lines_;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable entered_;
+        std::condition_variable held_;
+        bool holding_ = false;
+        std::vector<std::string> lines_;
+    };
+
+    // routes the ring to a control and a log file of its own for one case
+    class Sink {
+    public:
+        explicit Sink(const char* name) : path_(std::string("/tmp/log_ring_test_") + name + "_" +
+                                                std::to_string(getpid()) + ".log") {
+            remove(path_.c_str());
+            LogRing::getInstance().setExtensionControl(&control_);
+            EXPECT_TRUE(LogRing::getInstance().setLogFile(path_));
+        }
+
+        ~Sink() {
+            control_.release();
+            LogRing::getInstance().flush();
+            LogRing::getInstance().setExtensionControl(nullptr);
+            LogRing::getInstance().setLogFile("");
+            remove(path_.c_str());
+        }
+
+        RecordingControl& control() { return control_; }
+
+        // the messages of the file, without time and level
+        std::vector<std::string> fileLines() {
+            std::vector<std::string> lines;
+            std::ifstream file(path_);
+            std::string line;
+            while (std::getline(file, line)) {
+                // "MM-DD hh:mm:ss.mmm I message"
+                EXPECT_TRUE(line.size() >= 21 && line[19] == 'I');
+                lines.push_back(line.size() >= 21 ? line.substr(21) : line);
+            }
+            return lines;
+        }
+
+    private:
+        std::string path_;
+        RecordingControl control_;
+    };
+}
+
+HOST_TEST(formatConversions) {
+    EXPECT_TRUE(Args().i(-42).u(7).d(1.5).s("abc").format("%d %u %.2f %s") == "-42 7 1.50 abc");
+    EXPECT_TRUE(Args().i(255).i(255).i('x').format("%x %04X %c") == "ff 00FF x");
+    // the caller's length modifiers are replaced by our own
+    EXPECT_TRUE(Args().i(-1).u(1ull << 40).format("%ld %llu") == "-1 1099511627776");
+    EXPECT_TRUE(Args().s("abc").s("de").format("[%5s|%-3s]") == "[  abc|de ]");
+    EXPECT_TRUE(Args().format("100%% plain") == "100% plain");
+    EXPECT_TRUE(Args().i(3).format("%*d") == "3");
+}
+
+// A missing argument, or one of another kind than the conversion, prints as "?".
+HOST_TEST(formatMismatchedArguments) {
+    EXPECT_TRUE(Args().s("text").format("%d %s") == "? ?");
+    EXPECT_TRUE(Args().i(1).format("%s") == "?");
+    EXPECT_TRUE(Args().i(1).format("%d %d") == "1 ?");
+    EXPECT_TRUE(Args().format("%") == "");
+}
+
+// Strings cut when posted end in "...", and the line is clipped to the buffer.
+HOST_TEST(formatClipping) {
+    EXPECT_TRUE(Args().s("abc", true).format("<%s>") == "<abc...>");
+    EXPECT_TRUE(Args().s("abcdefghij").format("%s!", 8) == "abcdefg");
+    EXPECT_TRUE(Args().i(123456789).format("n=%d", 6) == "n=123");
+    EXPECT_TRUE(Args().format("plain text", 6) == "plain");
+    char out[1] = {'x'};
+    EXPECT_EQ(LogRing::format("text", nullptr, 0, out, sizeof(out)), (size_t)0);
+    EXPECT_EQ(out[0], '\0');
+}
+
+// A call site gets kSiteBurst records per window; the next one that gets
+// through reports how many were suppressed.
+HOST_TEST(perSiteRateLimit) {
+    Sink sink("rate");
+    LogSite site{};
+    LogSite other{};
+    for (int i = 0; i < 25; i++) {
+        LogRing::getInstance().post(site, kInfo, "tick %d", i);
+    }
+    LogRing::getInstance().post(other, kInfo, "other site");
+    // as if a window had passed
+    site.windowStartMs.store(site.windowStartMs.load() - LogRing::kSiteWindowMs);
+    LogRing::getInstance().post(site, kInfo, "next window");
+    LogRing::getInstance().flush();
+
+    std::vector<std::string> lines = sink.fileLines();
+    ASSERT_TRUE(lines.size() == LogRing::kSiteBurst + 2);
+    for (uint32_t i = 0; i < LogRing::kSiteBurst; i++) {
+        EXPECT_TRUE(lines[i] == "tick " + std::to_string(i));
+    }
+    EXPECT_TRUE(lines[LogRing::kSiteBurst] == "other site");
+    EXPECT_TRUE(lines.back() == "next window (15 more suppressed)");
+    EXPECT_TRUE(sink.control().lines().back() == lines.back());
+}
+
+// A string is cut at kMaxStringBytes or at the room left in the record, and
+// arguments that no longer fit print as "?".
+HOST_TEST(argumentTruncation) {
+    Sink sink("truncation");
+    std::string first(LogRing::kArgBytes, 'a');
+    std::string second(LogRing::kArgBytes, 'b');
+    LogSite site{};
+    LogRing::getInstance().post(site, kInfo, "%s|%s|%d", first.c_str(), second.c_str(), 7);
+    LogRing::getInstance().post(site, kInfo, "%s|%d", "short", 7);
+    LogRing::getInstance().flush();
+
+    // tag and length of a string take 3 bytes
+    size_t secondRoom = LogRing::kArgBytes - (3 + LogRing::kMaxStringBytes) - 3;
+    std::vector<std::string> lines = sink.fileLines();
+    ASSERT_TRUE(lines.size() == 2);
+    EXPECT_TRUE(lines[0] == std::string(LogRing::kMaxStringBytes, 'a') + "...|" + std::string(secondRoom, 'b') +
+                            "...|?");
+    EXPECT_TRUE(lines[1] == "short|7");
+}
+
+// With the consumer stuck writing, the ring takes kSlots - 1 more records and drops the rest.
+HOST_TEST(fullRingDrops) {
+    Sink sink("full");
+    LogRing& ring = LogRing::getInstance();
+    const int kOverflow = 50;
+    std::unique_ptr<LogSite[]> sites(new LogSite[LogRing::kSlots + kOverflow + 1]());
+
+    sink.control().hold();
+    ring.post(sites[0], kInfo, "first");
+    ASSERT_TRUE(sink.control().waitForEntry());
+
+    uint64_t dropped = ring.dropped();
+    for (int i = 1; i <= LogRing::kSlots + kOverflow; i++) {
+        ring.post(sites[i], kInfo, "record %d", i);
+    }
+    EXPECT_EQ(ring.dropped() - dropped, (uint64_t)kOverflow + 1);
+
+    sink.control().release();
+    ring.flush();
+    std::vector<std::string> lines = sink.fileLines();
+    ASSERT_TRUE(lines.size() == (size_t)LogRing::kSlots);
+    EXPECT_TRUE(lines[0] == "first");
+    EXPECT_TRUE(lines.back() == "record " + std::to_string(LogRing::kSlots - 1));
+    EXPECT_EQ(sink.control().lines().size(), (size_t)LogRing::kSlots);
+}
+
+// flush() returns once every record posted before it is written, in posting
+// order. A round of kSlots records fits an empty ring, so nothing is dropped.
+HOST_TEST(flushWritesInOrder) {
+    Sink sink("flush");
+    const int kRecords = 3 * LogRing::kSlots;
+    uint64_t dropped = LogRing::getInstance().dropped();
+    std::unique_ptr<LogSite[]> sites(new LogSite[kRecords]());
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < LogRing::kSlots; i++) {
+            int n = round * LogRing::kSlots + i;
+            LogRing::getInstance().post(sites[n], kInfo, "line %d of %s", n, "the test");
+        }
+        LogRing::getInstance().flush();
+        EXPECT_EQ(sink.fileLines().size(), (size_t)(round + 1) * LogRing::kSlots);
+    }
+
+    std::vector<std::string> lines = sink.fileLines();
+    ASSERT_TRUE(lines.size() == (size_t)kRecords);
+    for (int n = 0; n < kRecords; n++) {
+        if (lines[n] != "line " + std::to_string(n) + " of the test") {
+            EXPECT_TRUE(lines[n] == "line " + std::to_string(n) + " of the test");
+            printf("  line %d\n", n);
+            break;
+        }
+    }
+    EXPECT_EQ(LogRing::getInstance().dropped(), dropped);
+}
@@ -0,0 +1,224 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+// LoudnessMeter and LoudnessNormalizer against the EBU Tech 3341 minimum
+// requirement signals (1 kHz sines, level per channel of a stereo pair).
+//
+// Integrated loudness is measured by an independent BS.1770-4 meter below,
+// with the standard's published 48 kHz K-weighting coefficients and both
+// gates, which is itself checked against the Tech 3341 integrated cases first.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "AudioTestSupport.h"
+#include "HostTest.h"
+#include "LoudnessNormalizer.h"
+
+using namespace agora::extension;
+using namespace agora::extension::test;
+using agora::media::base::AudioPcmFrame;
+
+namespace {
+    const int kRate = 48000;
+    // Tech 3341 allows +-0.1 LU for the meter
+    const double kMeterTolerance = 0.1;
+
+    struct Segment {
+        double seconds;
+        double dbfs;
+    };
+
+    AudioClip ebuSignal(const std::vector<Segment>& segments, int sampleRate = kRate) {
+        AudioClip clip;
+        clip.sampleRate = sampleRate;
+        clip.channels = 2;
+        for (const Segment& segment : segments) {
+            AudioClip part = makeSine(sampleRate, 2, segment.seconds, 1000, segment.dbfs);
+            clip.samples.insert(clip.samples.end(), part.samples.begin(), part.samples.end());
+        }
+        return clip;
+    }
+
+    // BS.1770-4 integrated loudness, 48 kHz only
+    double integratedLufs(const AudioClip& clip) {
+        const double shelfB[] = {1.53512485958697, -2.69169618940638, 1.19839281085285};
+        const double shelfA[] = {-1.69065929318241, 0.73248077421585};
+        const double highPassB[] = {1.0, -2.0, 1.0};
+        const double highPassA[] = {-1.99004745483398, 0.99007225036621};
+        const size_t kStep = kRate / 10;
+
+        // energy per 100 ms, summed over channels
+        std::vector<double> steps(clip.frames() / kStep, 0.0);
+        for (int ch = 0; ch < clip.channels; ch++) {
+            double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+            double u1 = 0, u2 = 0, v1 = 0, v2 = 0;
+            for (size_t i = 0; i < steps.size() * kStep; i++) {
+                double x = clip.samples[i * clip.channels + ch] / 32768.0;
+                double y = shelfB[0] * x + shelfB[1] * x1 + shelfB[2] * x2 - shelfA[0] * y1 - shelfA[1] * y2;
+                x2 = x1;
+                x1 = x;
+                y2 = y1;
+                y1 = y;
+                double v = highPassB[0] * y + highPassB[1] * u1 + highPassB[2] * u2 - highPassA[0] * v1 - highPassA[1] * v2;
+                u2 = u1;
+                u1 = y;
+                v2 = v1;
+                v1 = v;
+                steps[i / kStep] += v * v;
+            }
+        }
+
+        // 400 ms blocks with 75 % overlap
+        std::vector<double> blocks;
+        for (size_t i = 3; i < steps.size(); i++) {
+            blocks.push_back((steps[i - 3] + steps[i - 2] + steps[i - 1] + steps[i]) / (4.0 * kStep));
+        }
+        auto loudness = [](double meanSquare) { return -0.691 + 10 * std::log10(meanSquare); };
+        auto gatedMean = [&](double gateLufs) {
+            double sum = 0;
+            int count = 0;
+            for (double block : blocks) {
+                if (block > 0 && loudness(block) > gateLufs) {
+                    sum += block;
+                    count++;
+                }
+            }
+            return count > 0 ? sum / count : 0.0;
+        };
+        double absoluteGated = gatedMean(-70);
+        if (absoluteGated <= 0) {
+            return -70;
+        }
+        return loudness(gatedMean(loudness(absoluteGated) - 10));
+    }
+
+    AudioClip normalize(const AudioClip& in, float targetLufs) {
+        static AudioPcmFrame inFrame;
+        static AudioPcmFrame outFrame;
+        LoudnessNormalizer normalizer;
+        normalizer.setTargetLufs(targetLufs);
+        AudioClip out = in;
+        size_t samples = in.sampleRate / 100;
+        for (size_t pos = 0; pos + samples <= in.frames(); pos += samples) {
+            inFrame.sample_rate_hz_ = in.sampleRate;
+            inFrame.num_channels_ = in.channels;
+            inFrame.samples_per_channel_ = samples;
+            memcpy(inFrame.data_, in.samples.data() + pos * in.channels, samples * in.channels * sizeof(int16_t));
+            normalizer.process(inFrame, outFrame, 1.0f);
+            memcpy(out.samples.data() + pos * in.channels, outFrame.data_, samples * in.channels * sizeof(int16_t));
+        }
+        return out;
+    }
+
+    AudioClip skip(const AudioClip& clip, double seconds) {
+        AudioClip rest = clip;
+        size_t drop = std::min(rest.samples.size(), (size_t)(seconds * clip.sampleRate) * clip.channels);
+        rest.samples.erase(rest.samples.begin(), rest.samples.begin() + drop);
+        return rest;
+    }
+}
+
+HOST_TEST(referenceMeterPassesTech3341Integrated) {
+    // cases 1 to 5
+    EXPECT_NEAR(integratedLufs(ebuSignal({{20, -23}})), -23.0, kMeterTolerance);
+    EXPECT_NEAR(integratedLufs(ebuSignal({{20, -33}})), -33.0, kMeterTolerance);
+    EXPECT_NEAR(integratedLufs(ebuSignal({{10, -36}, {60, -23}, {10, -36}})), -23.0, kMeterTolerance);
+    EXPECT_NEAR(integratedLufs(ebuSignal({{10, -72}, {10, -36}, {60, -23}, {10, -36}, {10, -72}})), -23.0,
+                kMeterTolerance);
+    EXPECT_NEAR(integratedLufs(ebuSignal({{20, -26}, {20.1, -20}, {20, -26}})), -23.0, kMeterTolerance);
+}
+
+// Tech 3341 cases 1 and 2 for the short-term value, at every rate the SDK delivers
+HOST_TEST(meterShortTermMatchesTech3341) {
+    const int kRates[] = {8000, 16000, 32000, 44100, 48000};
+    for (int rate : kRates) {
+        for (double dbfs : {-23.0, -33.0}) {
+            AudioClip clip = ebuSignal({{20, dbfs}}, rate);
+            LoudnessMeter meter;
+            meter.configure(rate, 2);
+            for (size_t i = 0; i < clip.frames(); i++) {
+                meter.addSample(clip.samples.data() + i * 2);
+            }
+            EXPECT_NEAR(meter.shortTermLufs(), dbfs, kMeterTolerance);
+        }
+    }
+}
+
+// Tech 3341 case 9: 1.34 s at -20 dBFS alternating with 1.66 s at -30 dBFS
+// reads a constant -23 LUFS short-term once the first 3 s have passed.
+HOST_TEST(meterShortTermIsConstantOnTech3341Case9) {
+    std::vector<Segment> segments;
+    for (int i = 0; i < 5; i++) {
+        segments.push_back({1.34, -20});
+        segments.push_back({1.66, -30});
+    }
+    AudioClip clip = ebuSignal(segments);
+    LoudnessMeter meter;
+    meter.configure(kRate, 2);
+    double worst = 0;
+    for (size_t i = 0; i < clip.frames(); i++) {
+        if (meter.addSample(clip.samples.data() + i * 2) && i >= (size_t)kRate * 3) {
+            worst = std::max(worst, std::fabs(meter.shortTermLufs() + 23.0));
+        }
+    }
+    EXPECT_NEAR(worst, 0.0, kMeterTolerance);
+}
+
+// Once the gain has settled the output sits at the target, measured as
+// integrated loudness over the rest of the programme.
+HOST_TEST(normalizerReachesTargetIntegrated) {
+    struct Case {
+        std::vector<Segment> input;
+        float target;
+    };
+    const Case kCases[] = {
+            {{{30, -23}}, -23},
+            {{{30, -33}}, -23},
+            {{{30, -15}}, -23},
+            {{{30, -23}}, -16},
+            {{{10, -36}, {60, -23}, {10, -36}}, -23},
+            {{{10, -26}, {20, -20}, {30, -26}}, -23},
+    };
+    for (const Case& testCase : kCases) {
+        AudioClip out = normalize(ebuSignal(testCase.input), testCase.target);
+        double measured = integratedLufs(skip(out, 10));
+        printf("  target %.0f: %.2f LUFS\n", testCase.target, measured);
+        EXPECT_NEAR(measured, testCase.target, 0.5);
+    }
+
+    // talkers 12 dB apart in turns are pulled to the target within 1 LU
+    AudioClip speech = makeSpeechLike(kRate, 2, 60, 21);
+    EXPECT_NEAR(integratedLufs(skip(normalize(speech, -23), 10)), -23.0, 1.0);
+}
+
+// Outside the +-12 dB gain range the output stays as close as the range allows
+HOST_TEST(normalizerGainIsBounded) {
+    AudioClip out = normalize(ebuSignal({{30, -45}}), -23);
+    EXPECT_NEAR(integratedLufs(skip(out, 10)), -45.0 + 12.0, 0.5);
+}
+
+// A frame without a format still gets its output written, with the volume applied
+HOST_TEST(frameWithoutFormatIsCopied) {
+    static AudioPcmFrame in;
+    static AudioPcmFrame out;
+    in.sample_rate_hz_ = 0;
+    in.num_channels_ = 2;
+    in.samples_per_channel_ = 480;
+    for (int i = 0; i < 960; i++) {
+        in.data_[i] = (int16_t)(i * 7 - 3000);
+        out.data_[i] = 0x5a5a;
+    }
+    LoudnessNormalizer normalizer;
+    normalizer.process(in, out, 0.5f);
+    bool halved = true;
+    for (int i = 0; i < 960; i++) {
+        halved = halved && std::abs(out.data_[i] - in.data_[i] / 2) <= 1;
+    }
+    EXPECT_TRUE(halved);
+}
@@ -0,0 +1,49 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "HostTest.h"
+#include "MaskCache.h"
+
+using namespace agora::extension;
+
+// A mask nobody references any more is handed out again, emptied, with the
+// region buffers of its earlier use.
+HOST_TEST(unreferencedMasksAreReused) {
+    MaskCache cache;
+    agora::agora_refptr<SegmentationMask> first = cache.acquire(MASK_HAIR);
+    first->resetRegions(2);
+    first->region(1).alpha.resize(64);
+    SegmentationMask* pooled = first.get();
+    first = nullptr;
+
+    agora::agora_refptr<SegmentationMask> again = cache.acquire(MASK_HAIR);
+    EXPECT_TRUE(again.get() == pooled);
+    EXPECT_EQ(again->regionCount(), 0);
+    again->resetRegions(2);
+    EXPECT_EQ(again->region(1).alpha.size(), (size_t)64);
+}
+
+// A published mask and one a consumer holds are never refilled underneath.
+HOST_TEST(referencedMasksAreNotReused) {
+    MaskCache cache;
+    agora::agora_refptr<SegmentationMask> published = cache.acquire(MASK_HEAD);
+    published->resetRegions(1);
+    cache.publish(MASK_HEAD, published);
+    agora::agora_refptr<SegmentationMask> held = cache.latest(MASK_HEAD);
+    published = nullptr;
+
+    for (int i = 0; i < MaskCache::kPoolSize + 1; i++) {
+        agora::agora_refptr<SegmentationMask> mask = cache.acquire(MASK_HEAD);
+        EXPECT_TRUE(mask.get() != held.get());
+        // replacing the published mask still leaves the consumer's copy alone
+        cache.publish(MASK_HEAD, mask);
+    }
+    EXPECT_EQ(held->regionCount(), 1);
+
+    // a head segmentation with no face publishes an empty mask
+    agora::agora_refptr<SegmentationMask> empty = cache.acquire(MASK_HEAD);
+    empty->resetRegions(0);
+    cache.publish(MASK_HEAD, empty);
+    EXPECT_EQ(cache.latest(MASK_HEAD)->regionCount(), 0);
+}
@@ -0,0 +1,100 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <cstdio>
+
+#include "FrameOrientation.h"
+#include "HostTest.h"
+
+using namespace agora::extension;
+
+namespace {
+    // a 40x20 buffer, the point (10, 5) and the box (4, 2) - (12, 8) in display space
+    struct Expected {
+        int rotation;
+        bool mirror;
+        bef_ai_rotate_type rotateType;
+        int displayWidth;
+        int displayHeight;
+        float x;
+        float y;
+        bef_ai_rect box;
+    };
+
+    const int kWidth = 40;
+    const int kHeight = 20;
+
+    const Expected kExpected[] = {
+            {0, false, BEF_AI_CLOCKWISE_ROTATE_0, 40, 20, 10, 5, {4, 2, 12, 8}},
+            {0, true, BEF_AI_CLOCKWISE_ROTATE_0, 40, 20, 30, 5, {28, 2, 36, 8}},
+            {90, false, BEF_AI_CLOCKWISE_ROTATE_90, 20, 40, 15, 10, {12, 4, 18, 12}},
+            {90, true, BEF_AI_CLOCKWISE_ROTATE_90, 20, 40, 5, 10, {2, 4, 8, 12}},
+            {180, false, BEF_AI_CLOCKWISE_ROTATE_180, 40, 20, 30, 15, {28, 12, 36, 18}},
+            {180, true, BEF_AI_CLOCKWISE_ROTATE_180, 40, 20, 10, 15, {4, 12, 12, 18}},
+            {270, false, BEF_AI_CLOCKWISE_ROTATE_270, 20, 40, 5, 30, {2, 28, 8, 36}},
+            {270, true, BEF_AI_CLOCKWISE_ROTATE_270, 20, 40, 15, 30, {12, 28, 18, 36}},
+    };
+}
+
+HOST_TEST(rotateTypeForEveryRotation) {
+    EXPECT_EQ(toRotateType(0), BEF_AI_CLOCKWISE_ROTATE_0);
+    EXPECT_EQ(toRotateType(90), BEF_AI_CLOCKWISE_ROTATE_90);
+    EXPECT_EQ(toRotateType(180), BEF_AI_CLOCKWISE_ROTATE_180);
+    EXPECT_EQ(toRotateType(270), BEF_AI_CLOCKWISE_ROTATE_270);
+    // negative, over a full turn, and off quarter turns round to the nearest one
+    EXPECT_EQ(toRotateType(-90), BEF_AI_CLOCKWISE_ROTATE_270);
+    EXPECT_EQ(toRotateType(450), BEF_AI_CLOCKWISE_ROTATE_90);
+    EXPECT_EQ(toRotateType(80), BEF_AI_CLOCKWISE_ROTATE_90);
+    EXPECT_EQ(toRotateType(44), BEF_AI_CLOCKWISE_ROTATE_0);
+    EXPECT_EQ(toRotateType(316), BEF_AI_CLOCKWISE_ROTATE_0);
+}
+
+HOST_TEST(pointsMapToDisplaySpace) {
+    for (const Expected& expected : kExpected) {
+        FrameOrientation orientation;
+        orientation.set(kWidth, kHeight, expected.rotation, expected.mirror);
+        EXPECT_EQ(orientation.rotateType(), expected.rotateType);
+        EXPECT_EQ(orientation.displayWidth(), expected.displayWidth);
+        EXPECT_EQ(orientation.displayHeight(), expected.displayHeight);
+        EXPECT_EQ(orientation.isIdentity(), expected.rotation == 0 && !expected.mirror);
+
+        float x = 10;
+        float y = 5;
+        orientation.toDisplay(x, y);
+        if (x != expected.x || y != expected.y) {
+            EXPECT_EQ(x, expected.x);
+            EXPECT_EQ(y, expected.y);
+            printf("  rotation %d mirror %d\n", expected.rotation, (int)expected.mirror);
+        }
+    }
+}
+
+// Boxes keep their size and stay ordered left < right, top < bottom.
+HOST_TEST(boxesMapToDisplaySpace) {
+    for (const Expected& expected : kExpected) {
+        FrameOrientation orientation;
+        orientation.set(kWidth, kHeight, expected.rotation, expected.mirror);
+
+        bef_ai_rect box = orientation.toDisplay(bef_ai_rect{4, 2, 12, 8});
+        if (box.left != expected.box.left || box.top != expected.box.top ||
+            box.right != expected.box.right || box.bottom != expected.box.bottom) {
+            EXPECT_EQ(box.left, expected.box.left);
+            EXPECT_EQ(box.top, expected.box.top);
+            EXPECT_EQ(box.right, expected.box.right);
+            EXPECT_EQ(box.bottom, expected.box.bottom);
+            printf("  rotation %d mirror %d\n", expected.rotation, (int)expected.mirror);
+        }
+
+        float left = 4;
+        float top = 2;
+        float right = 12;
+        float bottom = 8;
+        orientation.toDisplay(left, top, right, bottom);
+        EXPECT_EQ(left, (float)expected.box.left);
+        EXPECT_EQ(bottom, (float)expected.box.bottom);
+        bool sideways = expected.rotation % 180 != 0;
+        EXPECT_EQ(right - left, sideways ? 6.0f : 8.0f);
+        EXPECT_EQ(bottom - top, sideways ? 8.0f : 6.0f);
+    }
+}
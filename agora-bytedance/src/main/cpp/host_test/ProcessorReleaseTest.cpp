@@ -0,0 +1,91 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+// Every filter owns its ByteDanceProcessor, so the processor hands back every
+// SDK handle it created when it goes, and exactly once.
+
+#include <memory>
+#include <string>
+
+#include "AgoraRtcKit/AgoraRefCountedObject.h"
+#include "ByteDanceStubs.h"
+#include "HostTest.h"
+#include "SharedVideoResources.h"
+#include "VideoProcessor.h"
+#include "VideoTestSupport.h"
+
+using namespace agora::extension;
+using namespace agora::extension::test;
+
+namespace {
+    const char* kEverything =
+            "{\"plugin.bytedance.aiEffectEnabled\":true,"
+            "\"plugin.bytedance.ai.composer.nodes\":[{\"path\":\"beauty\",\"key\":\"smooth\",\"intensity\":0.5}],"
+            "\"plugin.bytedance.faceAttributeEnabled\":true,"
+            "\"plugin.bytedance.handDetectEnabled\":true,"
+            "\"plugin.bytedance.lightDetectEnabled\":true,"
+            "\"plugin.bytedance.skeletonDetectEnabled\":true,"
+            "\"plugin.bytedance.petFaceEnabled\":true,"
+            "\"plugin.bytedance.dynamicActionEnabled\":true,"
+            "\"plugin.bytedance.humanDistanceEnabled\":true,"
+            "\"plugin.bytedance.hairParseEnabled\":true,"
+            "\"plugin.bytedance.headSegEnabled\":true,"
+            "\"plugin.bytedance.faceVerifyEnabled\":true,"
+            "\"plugin.bytedance.backgroundMode\":\"blur\"}";
+
+    // the release call of every handle kEverything creates
+    const char* kReleases[] = {
+            "bef_effect_ai_destroy",
+            "bef_effect_ai_face_detect_destroy",
+            "bef_effect_ai_face_attribute_destroy",
+            "bef_effect_ai_hand_detect_destroy",
+            "bef_effect_ai_lightcls_release",
+            "bef_effect_ai_skeleton_destroy",
+            "bef_effect_ai_pet_face_release",
+            "bef_effect_ai_dynamic_action_release",
+            "bef_effect_ai_human_distance_destroy",
+            "bef_effect_ai_hairparser_destroy",
+            "BEF_AI_HSeg_ReleaseHandle",
+            "bef_effect_ai_face_verify_destroy",
+            "bef_effect_ai_portrait_matting_destroy",
+    };
+
+    agora::agora_refptr<ByteDanceProcessor> runProcessor() {
+        std::shared_ptr<SharedVideoResources> shared = std::make_shared<SharedVideoResources>();
+        agora::agora_refptr<ByteDanceProcessor> processor = new agora::RefCountedObject<ByteDanceProcessor>(shared);
+        EXPECT_EQ(processor->setParameters(kEverything), 0);
+        I420Image image(64, 48);
+        for (int i = 1; i <= 3; i++) {
+            processor->processFrame(image.frame(i * 33));
+        }
+        return processor;
+    }
+}
+
+HOST_TEST(destructorReleasesEveryHandle) {
+    agora::agora_refptr<ByteDanceProcessor> processor = runProcessor();
+    resetStubCalls();
+    processor = nullptr;
+    for (const char* release : kReleases) {
+        if (stubCalls(release) != 1) {
+            EXPECT_EQ(stubCalls(release), 1);
+            printf("  %s\n", release);
+        }
+    }
+}
+
+// An explicit release leaves nothing for the destructor to free again.
+HOST_TEST(releaseThenDestroyReleasesOnce) {
+    agora::agora_refptr<ByteDanceProcessor> processor = runProcessor();
+    resetStubCalls();
+    processor->releaseEffectEngine();
+    processor->releaseEffectEngine();
+    processor = nullptr;
+    for (const char* release : kReleases) {
+        if (stubCalls(release) != 1) {
+            EXPECT_EQ(stubCalls(release), 1);
+            printf("  %s\n", release);
+        }
+    }
+}
@@ -0,0 +1,316 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "HostTest.h"
+#include "ReadbackRing.h"
+
+using namespace agora::extension;
+
+namespace {
+    // what the fake GL saw, shared with the test after the ring took the backend
+    struct GlLog {
+        // one entry per call, "read 3" or "map 3"
+        std::vector<std::string> calls;
+        std::set<unsigned int> buffersInUse;
+        std::set<unsigned int> mappedBuffers;
+        int liveFences = 0;
+        // fences the GPU passed, a wait on any other one times out
+        bool gpuDone = true;
+        bool failMap = false;
+    };
+
+    struct FakeFence {
+        unsigned int buffer;
+    };
+
+    // A buffer holds the framebuffer name it was read from in every byte.
+    class FakeReadbackBackend : public ReadbackBackend {
+    public:
+        explicit FakeReadbackBackend(std::shared_ptr<GlLog> log) : log_(std::move(log)) {}
+
+        unsigned int acquireBuffer(int, int) override {
+            unsigned int buffer = 1;
+            while (log_->buffersInUse.count(buffer)) {
+                buffer++;
+            }
+            log_->buffersInUse.insert(buffer);
+            log_->calls.push_back("acquire " + std::to_string(buffer));
+            return buffer;
+        }
+
+        void recycleBuffer(unsigned int buffer) override {
+            EXPECT_TRUE(log_->buffersInUse.count(buffer) == 1);
+            EXPECT_TRUE(log_->mappedBuffers.count(buffer) == 0);
+            log_->buffersInUse.erase(buffer);
+            log_->calls.push_back("recycle " + std::to_string(buffer));
+        }
+
+        void readPixels(unsigned int framebuffer, int width, int height, unsigned int buffer) override {
+            pixels_[buffer].assign((size_t)width * height * 4, (uint8_t)framebuffer);
+            log_->calls.push_back("read " + std::to_string(buffer));
+        }
+
+        void* insertFence() override {
+            log_->liveFences++;
+            log_->calls.push_back("fence");
+            return new FakeFence();
+        }
+
+        bool waitFence(void*, uint64_t timeoutNs) override {
+            EXPECT_TRUE(timeoutNs > 0);
+            log_->calls.push_back("wait");
+            return log_->gpuDone;
+        }
+
+        void deleteFence(void* fence) override {
+            delete static_cast<FakeFence*>(fence);
+            log_->liveFences--;
+            log_->calls.push_back("delete fence");
+        }
+
+        const void* map(unsigned int buffer, size_t size) override {
+            log_->calls.push_back("map " + std::to_string(buffer));
+            if (log_->failMap) {
+                return nullptr;
+            }
+            EXPECT_EQ(pixels_[buffer].size(), size);
+            log_->mappedBuffers.insert(buffer);
+            return pixels_[buffer].data();
+        }
+
+        void unmap(unsigned int buffer) override {
+            EXPECT_TRUE(log_->mappedBuffers.erase(buffer) == 1);
+            log_->calls.push_back("unmap " + std::to_string(buffer));
+        }
+
+    private:
+        std::shared_ptr<GlLog> log_;
+        std::map<unsigned int, std::vector<uint8_t>> pixels_;
+    };
+
+    struct FakeGl {
+        std::shared_ptr<GlLog> log = std::make_shared<GlLog>();
+        ReadbackRing ring;
+
+        FakeGl() : ring(std::unique_ptr<ReadbackBackend>(new FakeReadbackBackend(log))) {}
+
+        // nothing acquired, mapped or fenced is left
+        bool idle() const {
+            return log->buffersInUse.empty() && log->mappedBuffers.empty() && log->liveFences == 0;
+        }
+    };
+
+    bool contains(const std::vector<std::string>& calls, const std::string& call) {
+        return std::find(calls.begin(), calls.end(), call) != calls.end();
+    }
+}
+
+// Depth 1 collects the frame just submitted: copy, fence, wait, map.
+HOST_TEST(depthOneIsSynchronous) {
+    FakeGl gl;
+    EXPECT_EQ(gl.ring.depth(), 1);
+    ASSERT_TRUE(gl.ring.submit(7, 4, 2, 100));
+    EXPECT_EQ(gl.ring.pending(), 1);
+
+    ReadbackFrame frame;
+    ASSERT_TRUE(gl.ring.acquireOldest(frame));
+    EXPECT_EQ((int)frame.pixels[0], 7);
+    EXPECT_EQ(frame.width, 4);
+    EXPECT_EQ(frame.height, 2);
+    EXPECT_EQ(frame.timestampMs, (int64_t)100);
+    gl.ring.releaseOldest();
+
+    std::vector<std::string> expected = {"acquire 1", "read 1", "fence", "wait", "delete fence", "map 1",
+                                         "unmap 1", "recycle 1"};
+    EXPECT_TRUE(gl.log->calls == expected);
+    EXPECT_EQ(gl.ring.pending(), 0);
+    EXPECT_TRUE(gl.idle());
+}
+
+// With depth k frames come out in submit order, k - 1 frames behind, each
+// with its own pixels and timestamp.
+HOST_TEST(framesComeOutInSubmitOrder) {
+    FakeGl gl;
+    gl.ring.setDepth(3);
+
+    std::vector<int64_t> collected;
+    for (unsigned int framebuffer = 1; framebuffer <= 10; framebuffer++) {
+        ASSERT_TRUE(gl.ring.submit(framebuffer, 2, 2, framebuffer * 33));
+        if (gl.ring.pending() < gl.ring.depth()) {
+            continue;
+        }
+        ReadbackFrame frame;
+        ASSERT_TRUE(gl.ring.acquireOldest(frame));
+        EXPECT_EQ((int64_t)frame.pixels[0] * 33, frame.timestampMs);
+        collected.push_back(frame.timestampMs);
+        gl.ring.releaseOldest();
+    }
+
+    std::vector<int64_t> expected;
+    for (int framebuffer = 1; framebuffer <= 8; framebuffer++) {
+        expected.push_back(framebuffer * 33);
+    }
+    EXPECT_TRUE(collected == expected);
+    EXPECT_EQ(gl.ring.pending(), 2);
+    // never more buffers than the depth
+    EXPECT_EQ(gl.log->buffersInUse.size(), (size_t)2);
+    gl.ring.clear();
+    EXPECT_TRUE(gl.idle());
+}
+
+// A frame is not mapped before the GPU passed its fence, or the wait timed out.
+HOST_TEST(mapWaitsForTheFence) {
+    FakeGl gl;
+    gl.log->gpuDone = false;
+    gl.ring.submit(1, 2, 2, 0);
+
+    ReadbackFrame frame;
+    ASSERT_TRUE(gl.ring.acquireOldest(frame));
+    std::vector<std::string>& calls = gl.log->calls;
+    auto wait = std::find(calls.begin(), calls.end(), "wait");
+    auto map = std::find(calls.begin(), calls.end(), "map 1");
+    EXPECT_TRUE(wait < map);
+    gl.ring.releaseOldest();
+    EXPECT_TRUE(gl.idle());
+}
+
+HOST_TEST(submitFailsWhileEverySlotIsInFlight) {
+    FakeGl gl;
+    gl.ring.setDepth(ReadbackRing::kMaxDepth);
+    for (int i = 0; i < ReadbackRing::kMaxDepth; i++) {
+        EXPECT_TRUE(gl.ring.submit(1, 2, 2, i));
+    }
+    EXPECT_TRUE(!gl.ring.submit(1, 2, 2, 99));
+    EXPECT_EQ(gl.ring.pending(), (int)ReadbackRing::kMaxDepth);
+
+    // the freed slot wraps around
+    gl.ring.releaseOldest();
+    EXPECT_TRUE(gl.ring.submit(2, 2, 2, 100));
+    ReadbackFrame frame;
+    ASSERT_TRUE(gl.ring.acquireOldest(frame));
+    EXPECT_EQ(frame.timestampMs, (int64_t)1);
+}
+
+HOST_TEST(depthIsClamped) {
+    FakeGl gl;
+    gl.ring.setDepth(0);
+    EXPECT_EQ(gl.ring.depth(), 1);
+    gl.ring.setDepth(ReadbackRing::kMaxDepth + 3);
+    EXPECT_EQ(gl.ring.depth(), (int)ReadbackRing::kMaxDepth);
+}
+
+// Lowering the depth keeps the frames in flight; the caller drops the surplus
+// without mapping it and collects the newest. Raising it delays the next output.
+HOST_TEST(depthChangeWithFramesInFlight) {
+    FakeGl gl;
+    gl.ring.setDepth(3);
+    gl.ring.submit(1, 2, 2, 10);
+    gl.ring.submit(2, 2, 2, 20);
+    gl.ring.submit(3, 2, 2, 30);
+
+    gl.ring.setDepth(1);
+    EXPECT_EQ(gl.ring.pending(), 3);
+    while (gl.ring.pending() > gl.ring.depth()) {
+        gl.ring.releaseOldest();
+    }
+    EXPECT_TRUE(!contains(gl.log->calls, "map 1"));
+    EXPECT_TRUE(!contains(gl.log->calls, "map 2"));
+    ReadbackFrame frame;
+    ASSERT_TRUE(gl.ring.acquireOldest(frame));
+    EXPECT_EQ(frame.timestampMs, (int64_t)30);
+    EXPECT_EQ((int)frame.pixels[0], 3);
+    gl.ring.releaseOldest();
+    EXPECT_TRUE(gl.idle());
+
+    gl.ring.setDepth(2);
+    gl.ring.submit(4, 2, 2, 40);
+    EXPECT_TRUE(gl.ring.pending() < gl.ring.depth());
+    gl.ring.submit(5, 2, 2, 50);
+    ASSERT_TRUE(gl.ring.acquireOldest(frame));
+    EXPECT_EQ(frame.timestampMs, (int64_t)40);
+}
+
+// Each slot keeps the size it was submitted with, across a resolution change.
+HOST_TEST(slotsKeepTheirSize) {
+    FakeGl gl;
+    gl.ring.setDepth(2);
+    gl.ring.submit(1, 4, 4, 10);
+    gl.ring.submit(2, 8, 2, 20);
+
+    ReadbackFrame frame;
+    ASSERT_TRUE(gl.ring.acquireOldest(frame));
+    EXPECT_EQ(frame.width, 4);
+    EXPECT_EQ(frame.height, 4);
+    gl.ring.releaseOldest();
+    ASSERT_TRUE(gl.ring.acquireOldest(frame));
+    EXPECT_EQ(frame.width, 8);
+    EXPECT_EQ(frame.height, 2);
+    EXPECT_EQ(frame.timestampMs, (int64_t)20);
+}
+
+// A failed map leaves the slot to releaseOldest(), which still recycles it.
+HOST_TEST(failedMapIsReleased) {
+    FakeGl gl;
+    gl.log->failMap = true;
+    gl.ring.submit(1, 2, 2, 0);
+    ReadbackFrame frame;
+    EXPECT_TRUE(!gl.ring.acquireOldest(frame));
+    gl.ring.releaseOldest();
+    EXPECT_TRUE(!contains(gl.log->calls, "unmap 1"));
+    EXPECT_EQ(gl.ring.pending(), 0);
+    EXPECT_TRUE(gl.idle());
+}
+
+// clear() and the destructor hand back mapped, fenced and queued slots alike.
+HOST_TEST(clearReleasesEverything) {
+    std::shared_ptr<GlLog> log;
+    {
+        FakeGl gl;
+        log = gl.log;
+        gl.ring.setDepth(3);
+        gl.ring.submit(1, 2, 2, 10);
+        gl.ring.submit(2, 2, 2, 20);
+        gl.ring.submit(3, 2, 2, 30);
+        ReadbackFrame frame;
+        ASSERT_TRUE(gl.ring.acquireOldest(frame));
+        gl.ring.clear();
+        EXPECT_EQ(gl.ring.pending(), 0);
+        EXPECT_TRUE(gl.idle());
+
+        gl.ring.submit(4, 2, 2, 40);
+    }
+    EXPECT_TRUE(log->buffersInUse.empty() && log->liveFences == 0);
+}
+
+// After its context is gone the ring forgets its frames without a GL call,
+// and starts over empty.
+HOST_TEST(detachMakesNoGlCalls) {
+    std::shared_ptr<GlLog> log;
+    size_t callsBefore = 0;
+    {
+        FakeGl gl;
+        log = gl.log;
+        gl.ring.setDepth(3);
+        gl.ring.submit(1, 2, 2, 10);
+        gl.ring.submit(2, 2, 2, 20);
+        ReadbackFrame frame;
+        ASSERT_TRUE(gl.ring.acquireOldest(frame));
+
+        callsBefore = log->calls.size();
+        gl.ring.detach();
+        EXPECT_EQ(gl.ring.pending(), 0);
+        EXPECT_TRUE(!gl.ring.acquireOldest(frame));
+        gl.ring.releaseOldest();
+        gl.ring.clear();
+    }
+    // nor when it is destroyed
+    EXPECT_EQ(log->calls.size(), callsBefore);
+}
@@ -0,0 +1,222 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+// RemoteAudioProcessor's stream table under a large room: 50 concurrent
+// remote streams, more streams than slots, and idle eviction, on a fake clock.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "AgoraRtcKit/AgoraRefCountedObject.h"
+#include "AudioTestSupport.h"
+#include "ExtensionRemoteAudioFilter.h"
+#include "HostTest.h"
+#include "LoudnessNormalizer.h"
+#include "RemoteAudioProcessor.h"
+
+using namespace agora::extension;
+using namespace agora::extension::test;
+using agora::media::base::AudioPcmFrame;
+
+namespace {
+    const int kRate = 16000;
+    const size_t kFrameSamples = kRate / 100;
+
+    std::atomic<int64_t> fakeNowMs = {1000};
+
+    int64_t fakeClock() {
+        return fakeNowMs.load();
+    }
+
+    agora::agora_refptr<RemoteAudioProcessor> createProcessor() {
+        agora::agora_refptr<RemoteAudioProcessor> processor =
+                new agora::RefCountedObject<RemoteAudioProcessor>(fakeClock);
+        processor->setVendorName("ByteDance");
+        return processor;
+    }
+
+    agora::agora_refptr<agora::rtc::IAudioFilter> createFilter(agora::agora_refptr<RemoteAudioProcessor> processor) {
+        return new agora::RefCountedObject<ExtensionRemoteAudioFilter>(processor);
+    }
+
+    // a talker at their own level, 10 ms frames
+    AudioClip talker(int index, double seconds) {
+        AudioClip clip = makeSpeechLike(kRate, 1, seconds, 100 + index);
+        double gain = std::pow(10.0, (-20.0 + (index % 10) * 2.0) / 20.0);
+        for (int16_t& sample : clip.samples) {
+            sample = (int16_t)(sample * gain);
+        }
+        return clip;
+    }
+
+    // processes frame `index` of the clip, false if the filter failed
+    bool processFrame(agora::rtc::IAudioFilter& filter, const AudioClip& clip, size_t index, int16_t* out) {
+        static thread_local AudioPcmFrame in;
+        static thread_local AudioPcmFrame adapted;
+        in.samples_per_channel_ = adapted.samples_per_channel_ = kFrameSamples;
+        in.sample_rate_hz_ = adapted.sample_rate_hz_ = kRate;
+        in.num_channels_ = adapted.num_channels_ = 1;
+        memcpy(in.data_, clip.samples.data() + index * kFrameSamples, kFrameSamples * sizeof(int16_t));
+        bool ok = filter.adaptAudioFrame(in, adapted);
+        memcpy(out, adapted.data_, kFrameSamples * sizeof(int16_t));
+        return ok;
+    }
+
+    bool framesEqual(const int16_t* a, const int16_t* b) {
+        return memcmp(a, b, kFrameSamples * sizeof(int16_t)) == 0;
+    }
+
+    AudioClip tail(const AudioClip& clip, int seconds) {
+        AudioClip end = clip;
+        end.samples.erase(end.samples.begin(), end.samples.end() - seconds * clip.sampleRate * clip.channels);
+        return end;
+    }
+
+    float shortTermLufs(const AudioClip& clip) {
+        LoudnessMeter meter;
+        meter.configure(clip.sampleRate, clip.channels);
+        for (size_t i = 0; i < clip.frames(); i++) {
+            meter.addSample(clip.samples.data() + i * clip.channels);
+        }
+        return meter.shortTermLufs();
+    }
+}
+
+// Every stream keeps its own normalizer state: 50 talkers processed at once on
+// five threads come out exactly as each one processed alone, as close to the
+// target as the gain range allows.
+HOST_TEST(fiftyConcurrentStreams) {
+    const int kStreams = 50;
+    const int kThreads = 5;
+    const double kSeconds = 8;
+    auto processor = createProcessor();
+    std::vector<agora::agora_refptr<agora::rtc::IAudioFilter>> filters;
+    std::vector<AudioClip> inputs;
+    std::vector<AudioClip> outputs(kStreams);
+    for (int i = 0; i < kStreams; i++) {
+        filters.push_back(createFilter(processor));
+        inputs.push_back(talker(i, kSeconds));
+        outputs[i] = inputs[i];
+    }
+    EXPECT_EQ(processor->activeStreamCount(), kStreams);
+
+    std::atomic<int> failures = {0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t] {
+            size_t frames = inputs[0].frames() / kFrameSamples;
+            for (size_t f = 0; f < frames; f++) {
+                for (int i = t; i < kStreams; i += kThreads) {
+                    int16_t* out = outputs[i].samples.data() + f * kFrameSamples;
+                    if (!processFrame(*filters[i].get(), inputs[i], f, out)) {
+                        failures++;
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(processor->activeStreamCount(), kStreams);
+
+    for (int i = 0; i < kStreams; i++) {
+        auto alone = createFilter(createProcessor());
+        AudioClip expected;
+        EXPECT_TRUE(runFilter(*alone.get(), inputs[i], kFrameSamples, expected));
+        EXPECT_TRUE(outputs[i].samples == expected.samples);
+        // over the last 3 s, once the gain has settled, within the normalizer's +-12 dB
+        float inLufs = shortTermLufs(tail(inputs[i], 3));
+        float expectedLufs = inLufs + std::min(12.0f, std::max(-12.0f, -23.0f - inLufs));
+        EXPECT_NEAR(shortTermLufs(tail(outputs[i], 3)), expectedLufs, 1.5);
+    }
+}
+
+// Streams beyond kMaxStreams pass through untouched until a slot frees up.
+HOST_TEST(streamsBeyondTheTablePassThrough) {
+    const int kStreams = RemoteAudioProcessor::kMaxStreams + 6;
+    auto processor = createProcessor();
+    std::vector<agora::agora_refptr<agora::rtc::IAudioFilter>> filters;
+    for (int i = 0; i < kStreams; i++) {
+        filters.push_back(createFilter(processor));
+    }
+    EXPECT_EQ(processor->activeStreamCount(), (int)RemoteAudioProcessor::kMaxStreams);
+
+    // quiet enough that normalization changes every frame once it has loudness
+    AudioClip quiet = makeSine(kRate, 1, 1, 300, -45);
+    size_t frames = quiet.frames() / kFrameSamples;
+    int16_t out[kFrameSamples];
+    for (size_t f = 0; f < frames; f++) {
+        for (int i = 0; i < kStreams; i++) {
+            EXPECT_TRUE(processFrame(*filters[i].get(), quiet, f, out));
+            const int16_t* in = quiet.samples.data() + f * kFrameSamples;
+            if (i >= RemoteAudioProcessor::kMaxStreams) {
+                EXPECT_TRUE(framesEqual(out, in));
+            } else if (f == frames - 1) {
+                EXPECT_TRUE(!framesEqual(out, in));
+            }
+        }
+    }
+
+    // closing a stream hands its slot to the next frame of an overflowed one
+    filters.erase(filters.begin());
+    EXPECT_EQ(processor->activeStreamCount(), RemoteAudioProcessor::kMaxStreams - 1);
+    agora::rtc::IAudioFilter& overflowed = *filters.back().get();
+    for (size_t f = 0; f < frames; f++) {
+        EXPECT_TRUE(processFrame(overflowed, quiet, f, out));
+    }
+    EXPECT_EQ(processor->activeStreamCount(), (int)RemoteAudioProcessor::kMaxStreams);
+    EXPECT_TRUE(!framesEqual(out, quiet.samples.data() + (frames - 1) * kFrameSamples));
+}
+
+// A stream silent for kIdleTimeoutMs loses its slot to the sweep, which runs
+// one slot per processed frame; when it comes back it starts from fresh state.
+HOST_TEST(idleStreamsAreEvicted) {
+    auto processor = createProcessor();
+    auto active = createFilter(processor);
+    auto idle = createFilter(processor);
+    AudioClip speech = talker(3, 10);
+    size_t frames = speech.frames() / kFrameSamples;
+    int16_t out[kFrameSamples];
+
+    size_t f = 0;
+    for (; f < 200; f++) {
+        processFrame(*active.get(), speech, f, out);
+        processFrame(*idle.get(), speech, f, out);
+        fakeNowMs += 10;
+    }
+    EXPECT_EQ(processor->activeStreamCount(), 2);
+
+    // one full sweep just short of the timeout keeps the idle stream
+    int64_t idleSince = fakeNowMs - 10;
+    fakeNowMs = idleSince + RemoteAudioProcessor::kIdleTimeoutMs - 1;
+    for (int i = 0; i < RemoteAudioProcessor::kMaxStreams; i++) {
+        processFrame(*active.get(), speech, f++ % frames, out);
+    }
+    EXPECT_EQ(processor->activeStreamCount(), 2);
+
+    fakeNowMs = idleSince + RemoteAudioProcessor::kIdleTimeoutMs;
+    for (int i = 0; i < RemoteAudioProcessor::kMaxStreams; i++) {
+        processFrame(*active.get(), speech, f++ % frames, out);
+    }
+    EXPECT_EQ(processor->activeStreamCount(), 1);
+
+    // back with a new slot and no memory of the old gain
+    auto fresh = createFilter(createProcessor());
+    int16_t expected[kFrameSamples];
+    for (size_t g = 0; g < 300; g++) {
+        processFrame(*idle.get(), speech, g, out);
+        processFrame(*fresh.get(), speech, g, expected);
+        if (!framesEqual(out, expected)) {
+            EXPECT_TRUE(framesEqual(out, expected));
+            break;
+        }
+    }
+    EXPECT_EQ(processor->activeStreamCount(), 2);
+}
@@ -0,0 +1,192 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+// Cost of the remote video enhancement with many streams at once: one
+// ExtensionRemoteVideoFilter per stream, all sharing one RemoteVideoProcessor
+// as the provider sets them up, each fed from its own thread like the SDK's
+// decoders.
+//
+//   remote_video_bench [--seconds N] [--streams N] [--width W --height H]
+//
+// Every stream runs flat out for N seconds, once on the video threads alone
+// (analysisThreadCap 0) and once with the default worker pool. ms/frame is the
+// time adaptVideoFrame takes on a stream's thread; cores at 15 fps is the
+// process CPU time, workers included, that all streams together need at 15
+// fps. Fails if a frame allocates once the filters are warmed up.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "ExtensionRemoteVideoFilter.h"
+#include "RemoteVideoProcessor.h"
+#include "SharedVideoResources.h"
+#include "VideoTestSupport.h"
+
+using namespace agora::extension;
+using namespace agora::extension::test;
+
+namespace {
+    const int kSourceFrames = 4;
+    const int kWarmupFrames = 10;
+    const double kFps = 15;
+
+    struct BenchConfig {
+        const char* name;
+        const char* params;
+    };
+
+    const BenchConfig kConfigs[] = {
+            {"video threads", "{\"plugin.bytedance.analysisThreadCap\":0}"},
+            {"worker pool", "{\"plugin.bytedance.analysisThreadCap\":-1}"},
+    };
+
+    struct BenchResult {
+        double msPerFrame;
+        double worstMsPerFrame;
+        double framesPerSecond;
+        double coresAt15Fps;
+        double allocationsPerFrame;
+    };
+
+    // a dim scene with a moving edge and sensor noise, different for every stream
+    std::vector<I420Image> makeSources(int width, int height, uint32_t seed) {
+        std::vector<I420Image> sources;
+        for (int f = 0; f < kSourceFrames; f++) {
+            sources.emplace_back(width, height);
+            I420Image& image = sources.back();
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    seed = seed * 1664525u + 1013904223u;
+                    int value = ((x + 8 * f) / 40 + y / 40) % 2 ? 70 : 30;
+                    image.lumaAt(x, y) = (uint8_t)(value + (int)(seed >> 28));
+                }
+            }
+            std::fill(image.u.begin(), image.u.end(), 128);
+            std::fill(image.v.begin(), image.v.end(), 128);
+        }
+        return sources;
+    }
+
+    struct Stream {
+        agora::agora_refptr<agora::rtc::IVideoFilter> filter;
+        std::vector<I420Image> sources;
+        std::unique_ptr<I420Image> work;
+        uint64_t frames = 0;
+        std::chrono::nanoseconds busy{0};
+
+        void step() {
+            const I420Image& source = sources[frames % kSourceFrames];
+            // the decoder's output, not the filter's work
+            memcpy(work->y.data(), source.y.data(), source.y.size());
+            agora::media::base::VideoFrame frame = work->frame((int64_t)frames * 66);
+            agora::media::base::VideoFrame adapted;
+            auto start = std::chrono::steady_clock::now();
+            filter->adaptVideoFrame(frame, adapted);
+            busy += std::chrono::steady_clock::now() - start;
+            frames++;
+        }
+    };
+
+    BenchResult run(const char* params, int streamCount, int width, int height, double seconds) {
+        auto shared = std::make_shared<SharedVideoResources>();
+        agora::agora_refptr<RemoteVideoProcessor> processor = new agora::RefCountedObject<RemoteVideoProcessor>(shared);
+        processor->setParameters(params);
+
+        std::vector<Stream> streams(streamCount);
+        for (int i = 0; i < streamCount; i++) {
+            streams[i].filter = new agora::RefCountedObject<ExtensionRemoteVideoFilter>(processor);
+            streams[i].sources = makeSources(width, height, 17 + i);
+            streams[i].work.reset(new I420Image(width, height));
+            streams[i].work->u = streams[i].sources[0].u;
+            streams[i].work->v = streams[i].sources[0].v;
+        }
+        for (Stream& stream : streams) {
+            for (int f = 0; f < kWarmupFrames; f++) {
+                stream.step();
+            }
+            stream.frames = 0;
+            stream.busy = std::chrono::nanoseconds(0);
+        }
+
+        std::atomic<bool> stop(false);
+        std::vector<std::thread> threads;
+        threads.reserve(streamCount);
+        uint64_t allocations = allocationCount();
+        std::clock_t cpuStart = std::clock();
+        auto start = std::chrono::steady_clock::now();
+        for (Stream& stream : streams) {
+            threads.emplace_back([&stream, &stop] {
+                do {
+                    stream.step();
+                } while (!stop.load(std::memory_order_relaxed));
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        stop = true;
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double cpu = (double)(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+        // starting the threads is the harness's work, one allocation each
+        allocations = allocationCount() - allocations - (uint64_t)streamCount;
+
+        uint64_t frames = 0;
+        double busyMs = 0;
+        double worst = 0;
+        for (const Stream& stream : streams) {
+            frames += stream.frames;
+            busyMs += stream.busy.count() / 1e6;
+            worst = std::max(worst, stream.busy.count() / 1e6 / stream.frames);
+        }
+        return {busyMs / frames, worst, frames / elapsed, cpu / frames * kFps * streamCount,
+                (double)allocations / frames};
+    }
+}
+
+int main(int argc, char** argv) {
+    double seconds = 5;
+    int streams = 16;
+    int width = 640;
+    int height = 360;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--seconds") == 0) {
+            seconds = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--streams") == 0) {
+            streams = std::max(1, atoi(argv[i + 1]));
+        } else if (strcmp(argv[i], "--width") == 0) {
+            width = std::max(2, atoi(argv[i + 1]));
+        } else if (strcmp(argv[i], "--height") == 0) {
+            height = std::max(2, atoi(argv[i + 1]));
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    bool allocated = false;
+    for (const BenchConfig& config : kConfigs) {
+        BenchResult result = run(config.params, streams, width, height, seconds);
+        printf("%-13s %2d x %dx%d %7.3f ms/frame (worst stream %.3f)  %7.1f frames/s  "
+               "%.2f cores at 15 fps  %.2f allocs/frame\n",
+               config.name, streams, width, height, result.msPerFrame, result.worstMsPerFrame,
+               result.framesPerSecond, result.coresAt15Fps, result.allocationsPerFrame);
+        allocated = allocated || result.allocationsPerFrame > 0;
+    }
+
+    if (allocated) {
+        fprintf(stderr, "adaptVideoFrame allocated on a video thread\n");
+        return 1;
+    }
+    return 0;
+}
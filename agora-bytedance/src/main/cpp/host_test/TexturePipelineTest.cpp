@@ -0,0 +1,295 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "HostTest.h"
+#include "TexturePipeline.h"
+
+using namespace agora::extension;
+
+namespace {
+    // GL textures as CPU memory, every call logged
+    class FakeTextureSource : public TextureFrameSource {
+    public:
+        struct Texture {
+            int width = 0;
+            int height = 0;
+            bool pooled = false;
+            bool acquired = false;
+            std::vector<uint8_t> rgba;
+        };
+
+        std::map<unsigned int, Texture> textures;
+        std::vector<std::string> calls;
+
+        // a texture of the caller's, every byte `value`
+        unsigned int addInput(int width, int height, uint8_t value) {
+            unsigned int name = nextName_++;
+            Texture& texture = textures[name];
+            texture.width = width;
+            texture.height = height;
+            texture.rgba.assign((size_t)width * height * 4, value);
+            return name;
+        }
+
+        int acquiredCount() const {
+            return (int)std::count_if(textures.begin(), textures.end(),
+                                      [](const std::pair<const unsigned int, Texture>& entry) {
+                                          return entry.second.acquired;
+                                      });
+        }
+
+        int count(const std::string& call) const {
+            return (int)std::count(calls.begin(), calls.end(), call);
+        }
+
+        unsigned int toTexture2D(const TextureFrame& frame) override {
+            if (frame.type == agora::media::base::VIDEO_TEXTURE_2D) {
+                return frame.textureId;
+            }
+            calls.push_back("convert");
+            unsigned int target = acquire(frame.width, frame.height);
+            textures[target].rgba = textures[frame.textureId].rgba;
+            return target;
+        }
+
+        unsigned int acquireTexture(int width, int height) override {
+            calls.push_back("acquire");
+            return acquire(width, height);
+        }
+
+        void recycleTexture(unsigned int texture) override {
+            calls.push_back("recycle");
+            Texture& pooled = textures[texture];
+            EXPECT_TRUE(pooled.pooled && pooled.acquired);
+            pooled.acquired = false;
+        }
+
+        void readPixels(unsigned int texture, int width, int height, uint8_t* rgba) override {
+            calls.push_back("read");
+            const Texture& source = textures[texture];
+            EXPECT_EQ(source.width, width);
+            EXPECT_EQ(source.height, height);
+            std::copy(source.rgba.begin(), source.rgba.end(), rgba);
+        }
+
+        void uploadPixels(unsigned int texture, int width, int height, const uint8_t* rgba) override {
+            calls.push_back("upload");
+            Texture& target = textures[texture];
+            EXPECT_TRUE(target.acquired);
+            EXPECT_EQ(target.width, width);
+            EXPECT_EQ(target.height, height);
+            target.rgba.assign(rgba, rgba + (size_t)width * height * 4);
+        }
+
+        void release() override {
+            textures.clear();
+        }
+
+    private:
+        unsigned int acquire(int width, int height) {
+            for (std::pair<const unsigned int, Texture>& entry : textures) {
+                Texture& texture = entry.second;
+                if (texture.pooled && !texture.acquired && texture.width == width && texture.height == height) {
+                    texture.acquired = true;
+                    return entry.first;
+                }
+            }
+            unsigned int name = nextName_++;
+            Texture& texture = textures[name];
+            texture.width = width;
+            texture.height = height;
+            texture.pooled = true;
+            texture.acquired = true;
+            texture.rgba.assign((size_t)width * height * 4, 0);
+            return name;
+        }
+
+        unsigned int nextName_ = 1;
+    };
+
+    const int kWidth = 8;
+    const int kHeight = 4;
+
+    struct PipelineFixture {
+        FakeTextureSource source;
+        TexturePipeline pipeline{&source};
+        TexturePipeline::Stages stages;
+        TextureFrame frame;
+        bool effectSucceeds = true;
+        int effectRuns = 0;
+        int cpuRuns = 0;
+        bool lastAnalysisOnly = false;
+        // first byte of the pixels the CPU stage got
+        int cpuSaw = -1;
+
+        PipelineFixture() {
+            frame.textureId = source.addInput(kWidth, kHeight, 10);
+            frame.width = kWidth;
+            frame.height = kHeight;
+            // the effect adds 1, the CPU stage adds 100
+            stages.effect = [this](unsigned int input, unsigned int target) {
+                source.calls.push_back("effect");
+                effectRuns++;
+                if (!effectSucceeds) {
+                    return false;
+                }
+                std::vector<uint8_t>& out = source.textures[target].rgba;
+                const std::vector<uint8_t>& in = source.textures[input].rgba;
+                for (size_t i = 0; i < out.size(); i++) {
+                    out[i] = (uint8_t)(in[i] + 1);
+                }
+                return true;
+            };
+            stages.cpu = [this](uint8_t* rgba, int width, int height, bool analysisOnly) {
+                source.calls.push_back("cpu");
+                cpuRuns++;
+                lastAnalysisOnly = analysisOnly;
+                cpuSaw = rgba[0];
+                for (int i = 0; i < width * height * 4; i++) {
+                    rgba[i] = (uint8_t)(rgba[i] + 100);
+                }
+            };
+        }
+
+        int firstByte(unsigned int texture) { return source.textures[texture].rgba[0]; }
+    };
+
+    TextureNeeds needs(bool effect, bool analysis, bool cpuWriters) {
+        TextureNeeds result;
+        result.effect = effect;
+        result.analysis = analysis;
+        result.cpuWriters = cpuWriters;
+        return result;
+    }
+}
+
+HOST_TEST(routeFollowsTheNeeds) {
+    EXPECT_EQ(chooseTextureRoute(needs(false, false, false)), TEXTURE_ROUTE_PASS_THROUGH);
+    EXPECT_EQ(chooseTextureRoute(needs(true, false, false)), TEXTURE_ROUTE_GPU);
+    EXPECT_EQ(chooseTextureRoute(needs(false, true, false)), TEXTURE_ROUTE_GPU_ANALYSIS);
+    EXPECT_EQ(chooseTextureRoute(needs(true, true, false)), TEXTURE_ROUTE_GPU_ANALYSIS);
+    EXPECT_EQ(chooseTextureRoute(needs(false, false, true)), TEXTURE_ROUTE_CPU);
+    EXPECT_EQ(chooseTextureRoute(needs(true, true, true)), TEXTURE_ROUTE_CPU);
+}
+
+HOST_TEST(nothingEnabledPassesTheInput) {
+    PipelineFixture f;
+    EXPECT_EQ(f.pipeline.run(f.frame, needs(false, false, false), f.stages), f.frame.textureId);
+    EXPECT_EQ(f.pipeline.lastRoute(), TEXTURE_ROUTE_PASS_THROUGH);
+    EXPECT_TRUE(f.source.calls.empty());
+
+    // an empty frame is not touched either
+    TextureFrame empty = f.frame;
+    empty.width = 0;
+    EXPECT_EQ(f.pipeline.run(empty, needs(true, true, true), f.stages), f.frame.textureId);
+    EXPECT_TRUE(f.source.calls.empty());
+}
+
+// The effect alone renders texture to texture, no pixel reaches CPU memory.
+HOST_TEST(effectOnlyStaysOnTheGpu) {
+    PipelineFixture f;
+    for (int i = 0; i < 5; i++) {
+        unsigned int output = f.pipeline.run(f.frame, needs(true, false, false), f.stages);
+        EXPECT_EQ(f.pipeline.lastRoute(), TEXTURE_ROUTE_GPU);
+        EXPECT_TRUE(output != f.frame.textureId);
+        EXPECT_EQ(f.firstByte(output), 11);
+        // the previous output went back to the pool, one texture is in use
+        EXPECT_EQ(f.source.acquiredCount(), 1);
+    }
+    EXPECT_EQ(f.source.count("read"), 0);
+    EXPECT_EQ(f.source.count("upload"), 0);
+    EXPECT_EQ(f.cpuRuns, 0);
+    EXPECT_EQ(f.firstByte(f.frame.textureId), 10);
+
+    f.pipeline.reset();
+    EXPECT_EQ(f.source.acquiredCount(), 0);
+}
+
+// An effect that renders nothing leaves the input as the output.
+HOST_TEST(failedEffectReturnsTheInput) {
+    PipelineFixture f;
+    f.effectSucceeds = false;
+    EXPECT_EQ(f.pipeline.run(f.frame, needs(true, false, false), f.stages), f.frame.textureId);
+    EXPECT_EQ(f.effectRuns, 1);
+    EXPECT_EQ(f.source.acquiredCount(), 0);
+}
+
+// Analyzers get one readback of the input and write nothing back.
+HOST_TEST(analysisOnlyReadsBackOnce) {
+    PipelineFixture f;
+    unsigned int output = f.pipeline.run(f.frame, needs(false, true, false), f.stages);
+    EXPECT_EQ(f.pipeline.lastRoute(), TEXTURE_ROUTE_GPU_ANALYSIS);
+    EXPECT_EQ(output, f.frame.textureId);
+    EXPECT_EQ(f.source.count("read"), 1);
+    EXPECT_EQ(f.source.count("upload"), 0);
+    EXPECT_EQ(f.cpuRuns, 1);
+    EXPECT_TRUE(f.lastAnalysisOnly);
+    EXPECT_EQ(f.cpuSaw, 10);
+    EXPECT_EQ(f.firstByte(output), 10);
+    EXPECT_EQ(f.source.acquiredCount(), 0);
+}
+
+// With the effect on too, the analyzers read the input and run after the
+// effect was queued, while the GPU renders it.
+HOST_TEST(analysisRunsWhileTheEffectRenders) {
+    PipelineFixture f;
+    unsigned int output = f.pipeline.run(f.frame, needs(true, true, false), f.stages);
+    std::vector<std::string> expected = {"read", "acquire", "effect", "cpu"};
+    EXPECT_TRUE(f.source.calls == expected);
+    EXPECT_EQ(f.cpuSaw, 10);
+    EXPECT_TRUE(f.lastAnalysisOnly);
+    EXPECT_EQ(f.firstByte(output), 11);
+}
+
+// A CPU writer takes the full round trip; the effect is left to the CPU stage
+// and the caller's texture is never written.
+HOST_TEST(cpuWritersRoundTrip) {
+    PipelineFixture f;
+    for (int i = 0; i < 3; i++) {
+        unsigned int output = f.pipeline.run(f.frame, needs(true, true, true), f.stages);
+        EXPECT_EQ(f.pipeline.lastRoute(), TEXTURE_ROUTE_CPU);
+        EXPECT_TRUE(output != f.frame.textureId);
+        EXPECT_EQ(f.firstByte(output), 110);
+        EXPECT_EQ(f.source.acquiredCount(), 1);
+    }
+    EXPECT_EQ(f.effectRuns, 0);
+    EXPECT_EQ(f.cpuRuns, 3);
+    EXPECT_TRUE(!f.lastAnalysisOnly);
+    EXPECT_EQ(f.source.count("read"), 3);
+    EXPECT_EQ(f.source.count("upload"), 3);
+    EXPECT_EQ(f.firstByte(f.frame.textureId), 10);
+}
+
+// An OES frame is drawn into a 2D texture first, which the pipeline then owns.
+HOST_TEST(oesInputIsConverted) {
+    PipelineFixture f;
+    f.frame.type = agora::media::base::VIDEO_TEXTURE_OES;
+
+    // analysis only: the converted texture is the output
+    unsigned int output = f.pipeline.run(f.frame, needs(false, true, false), f.stages);
+    EXPECT_TRUE(output != f.frame.textureId);
+    EXPECT_EQ(f.firstByte(output), 10);
+    EXPECT_EQ(f.source.acquiredCount(), 1);
+
+    // effect: the converted input goes back once the effect rendered
+    output = f.pipeline.run(f.frame, needs(true, false, false), f.stages);
+    EXPECT_EQ(f.firstByte(output), 11);
+    EXPECT_EQ(f.source.acquiredCount(), 1);
+
+    // CPU writer: the converted texture is written in place, nothing else acquired
+    f.source.calls.clear();
+    output = f.pipeline.run(f.frame, needs(false, false, true), f.stages);
+    EXPECT_EQ(f.firstByte(output), 110);
+    EXPECT_EQ(f.source.count("acquire"), 0);
+    EXPECT_EQ(f.source.acquiredCount(), 1);
+
+    f.pipeline.reset();
+    EXPECT_EQ(f.source.acquiredCount(), 0);
+    EXPECT_EQ(f.source.count("convert"), 1);
+}
@@ -0,0 +1,129 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include <cstdio>
+#include <vector>
+
+#include "HostTest.h"
+#include "TrackSmoother.h"
+
+using namespace agora::extension;
+
+namespace {
+    const int64_t kFrameMs = 33;
+
+    TrackSmoother::Sample sample(int id, float value, float held = 0) {
+        TrackSmoother::Sample sample = {};
+        sample.id = id;
+        sample.values[0] = value;
+        sample.values[1] = -value;
+        sample.held[0] = held;
+        return sample;
+    }
+
+    // one track through one update, returns its smoothed first value
+    float step(TrackSmoother& smoother, int64_t timestampMs, int id, float value) {
+        TrackSmoother::Sample one = sample(id, value);
+        smoother.update(timestampMs, &one, 1);
+        return one.values[0];
+    }
+
+    // 0 for ten frames, then 100 for sixty, the smoothed values after the step
+    std::vector<float> stepResponse(const OneEuroParams& params) {
+        TrackSmoother smoother(2, 0);
+        smoother.setParams(params);
+        int64_t timestampMs = 0;
+        for (int i = 0; i < 10; i++, timestampMs += kFrameMs) {
+            EXPECT_EQ(step(smoother, timestampMs, 1, 0), 0.0f);
+        }
+        std::vector<float> response;
+        for (int i = 0; i < 60; i++, timestampMs += kFrameMs) {
+            response.push_back(step(smoother, timestampMs, 1, 100));
+        }
+
+        // settled, so next to nothing left to extrapolate
+        TrackSmoother::Sample predicted;
+        EXPECT_EQ(smoother.predict(timestampMs - kFrameMs + TrackSmoother::kMaxPredictionMs, &predicted, 1), 1);
+        EXPECT_NEAR(predicted.values[0], 100.0f, 0.5f);
+        return response;
+    }
+
+    bool risesWithoutOvershoot(const std::vector<float>& response) {
+        for (size_t i = 1; i < response.size(); i++) {
+            if (response[i] < response[i - 1] || response[i] > 100) {
+                printf("  frame %d: %f after %f\n", (int)i, response[i], response[i - 1]);
+                return false;
+            }
+        }
+        return response[0] > 0 && response[0] < 100;
+    }
+}
+
+// A track that does not move comes out exactly as it went in, predicted or not.
+HOST_TEST(constantInputPassesThrough) {
+    TrackSmoother smoother(2, 1);
+    for (int i = 0; i < 30; i++) {
+        TrackSmoother::Sample samples[] = {sample(1, 12.5f, 3), sample(2, -40, 4)};
+        smoother.update(i * kFrameMs, samples, 2);
+        EXPECT_EQ(samples[0].values[0], 12.5f);
+        EXPECT_EQ(samples[0].values[1], -12.5f);
+        EXPECT_EQ(samples[1].values[0], -40.0f);
+        EXPECT_EQ(samples[1].held[0], 4.0f);
+    }
+
+    TrackSmoother::Sample predicted[TrackSmoother::kMaxTracks];
+    ASSERT_TRUE(smoother.predict(29 * kFrameMs + 100, predicted, TrackSmoother::kMaxTracks) == 2);
+    EXPECT_EQ(predicted[0].id, 1);
+    EXPECT_EQ(predicted[0].values[0], 12.5f);
+    EXPECT_EQ(predicted[0].held[0], 3.0f);
+    EXPECT_EQ(predicted[1].values[1], 40.0f);
+}
+
+// A step is followed without overshoot and settles on the new value; the
+// speed raises the cutoff, so the default parameters follow it within frames.
+HOST_TEST(stepResponseSettles) {
+    std::vector<float> response = stepResponse(OneEuroParams());
+    EXPECT_TRUE(risesWithoutOvershoot(response));
+    EXPECT_NEAR(response[2], 100.0f, 1.0f);
+    EXPECT_NEAR(response.back(), 100.0f, 0.01f);
+
+    // at the fixed 1 Hz cutoff it takes about a second
+    OneEuroParams fixed;
+    fixed.beta = 0;
+    std::vector<float> slow = stepResponse(fixed);
+    EXPECT_TRUE(risesWithoutOvershoot(slow));
+    EXPECT_TRUE(slow[2] < 60);
+    EXPECT_NEAR(slow[30], 100.0f, 1.0f);
+    EXPECT_NEAR(slow.back(), 100.0f, 0.01f);
+}
+
+// A track missing from an update frees its slot; the id that takes the slot
+// next starts from its own value, not from the old track's value or speed.
+HOST_TEST(staleSlotIsResetForANewTrack) {
+    TrackSmoother smoother(2, 1);
+    int64_t timestampMs = 0;
+    for (int i = 0; i < 10; i++, timestampMs += kFrameMs) {
+        step(smoother, timestampMs, 1, (float)(i * 20));
+    }
+
+    // track 1 is gone, track 2 lands in the same slot
+    smoother.update(timestampMs, nullptr, 0);
+    TrackSmoother::Sample predicted[TrackSmoother::kMaxTracks];
+    EXPECT_EQ(smoother.predict(timestampMs, predicted, TrackSmoother::kMaxTracks), 0);
+    timestampMs += kFrameMs;
+    EXPECT_EQ(step(smoother, timestampMs, 2, -5), -5.0f);
+
+    ASSERT_TRUE(smoother.predict(timestampMs + 200, predicted, TrackSmoother::kMaxTracks) == 1);
+    EXPECT_EQ(predicted[0].id, 2);
+    EXPECT_EQ(predicted[0].values[0], -5.0f);
+    EXPECT_EQ(predicted[0].values[1], 5.0f);
+
+    // replaced within a single update the new id takes another slot, also fresh
+    for (int i = 0; i < 5; i++, timestampMs += kFrameMs) {
+        step(smoother, timestampMs, 2, (float)(i * 50));
+    }
+    EXPECT_EQ(step(smoother, timestampMs, 3, 7), 7.0f);
+    ASSERT_TRUE(smoother.predict(timestampMs, predicted, TrackSmoother::kMaxTracks) == 1);
+    EXPECT_EQ(predicted[0].id, 3);
+}
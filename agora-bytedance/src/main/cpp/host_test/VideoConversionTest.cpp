@@ -0,0 +1,151 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+// ByteDanceProcessor against the counting SDK stubs: however many analyzers
+// run, a frame is converted to RGBA once and back to I420 at most once (only
+// when the effect writes it), every analyzer reads that one RGBA copy at the
+// same stride, and the steady state allocates nothing.
+
+#include <memory>
+#include <string>
+
+#include "AgoraRtcKit/AgoraRefCountedObject.h"
+#include "AllocationCounter.h"
+#include "ByteDanceStubs.h"
+#include "HostTest.h"
+#include "SharedVideoResources.h"
+#include "VideoProcessor.h"
+#include "VideoTestSupport.h"
+
+using namespace agora::extension;
+using namespace agora::extension::test;
+
+namespace {
+    struct Analyzer {
+        const char* parameter;
+        // the stubbed call that does its work
+        const char* detect;
+        // calls over a whole run, 0 for once a frame
+        int runCalls;
+    };
+
+    const Analyzer kAnalyzers[] = {
+            {"\"plugin.bytedance.faceAttributeEnabled\":true", "bef_effect_ai_face_detect", 0},
+            {"\"plugin.bytedance.handDetectEnabled\":true", "bef_effect_ai_hand_detect", 0},
+            {"\"plugin.bytedance.lightDetectEnabled\":true", "bef_effect_ai_lightcls_detect", 0},
+            {"\"plugin.bytedance.skeletonDetectEnabled\":true", "bef_effect_ai_skeleton_detect", 0},
+            {"\"plugin.bytedance.petFaceEnabled\":true", "bef_effect_ai_pet_face_detect", 0},
+            {"\"plugin.bytedance.dynamicActionEnabled\":true", "bef_effect_ai_dynamic_action_detect", 0},
+            {"\"plugin.bytedance.humanDistanceEnabled\":true", "bef_effect_ai_human_distance_detect", 0},
+            {"\"plugin.bytedance.hairParseEnabled\":true", "bef_effect_ai_hairparser_do_detect", 0},
+            {"\"plugin.bytedance.headSegEnabled\":true", "BEF_AI_HSeg_DoHeadSeg", 0},
+            // enrolment and the one face track of the stub
+            {"\"plugin.bytedance.faceVerifyEnabled\":true,\"plugin.bytedance.faceVerifyEnroll\":\"stub\"",
+             "bef_effect_ai_face_extract_feature_single", 2},
+            {"\"plugin.bytedance.backgroundMode\":\"blur\",\"plugin.bytedance.portraitMattingInterval\":1",
+             "bef_effect_ai_portrait_matting_do_detect", 0},
+    };
+    const int kAnalyzerCount = sizeof(kAnalyzers) / sizeof(kAnalyzers[0]);
+
+    // the first `count` analyzers, plus any extra parameters
+    std::string parameters(int count, const char* extra = nullptr) {
+        std::string json = "{";
+        for (int i = 0; i < count; i++) {
+            json += (i > 0 ? "," : "");
+            json += kAnalyzers[i].parameter;
+        }
+        if (extra) {
+            json += (count > 0 ? "," : "");
+            json += extra;
+        }
+        return json + "}";
+    }
+
+    agora::agora_refptr<ByteDanceProcessor> createProcessor(const std::string& json) {
+        std::shared_ptr<SharedVideoResources> shared = std::make_shared<SharedVideoResources>();
+        agora::agora_refptr<ByteDanceProcessor> processor = new agora::RefCountedObject<ByteDanceProcessor>(shared);
+        EXPECT_EQ(processor->setParameters(json), 0);
+        return processor;
+    }
+
+    void run(ByteDanceProcessor& processor, I420Image& image, int frames, int64_t& renderTimeMs) {
+        for (int i = 0; i < frames; i++) {
+            renderTimeMs += 33;
+            processor.processFrame(image.frame(renderTimeMs));
+        }
+    }
+}
+
+HOST_TEST(oneConversionPerFrameForAnyAnalyzerCount) {
+    const int kFrames = 8;
+    for (int count = 1; count <= kAnalyzerCount; count++) {
+        auto processor = createProcessor(parameters(count));
+        I420Image image(64, 48);
+        int64_t renderTimeMs = 0;
+        resetStubCalls();
+        run(*processor.get(), image, kFrames, renderTimeMs);
+        EXPECT_EQ(stubCalls("cvt_yuv2rgba"), kFrames);
+        EXPECT_EQ(stubCalls("cvt_rgba2yuv"), 0);
+        for (int i = 0; i < count; i++) {
+            int expected = kAnalyzers[i].runCalls > 0 ? kAnalyzers[i].runCalls : kFrames;
+            if (stubCalls(kAnalyzers[i].detect) != expected) {
+                EXPECT_EQ(stubCalls(kAnalyzers[i].detect), expected);
+                printf("  %s with %d analyzers\n", kAnalyzers[i].detect, count);
+            }
+        }
+    }
+}
+
+// Nothing that reads pixels, nothing converted
+HOST_TEST(noConversionWithoutAnalyzers) {
+    auto processor = createProcessor(parameters(0));
+    I420Image image(64, 48);
+    int64_t renderTimeMs = 0;
+    resetStubCalls();
+    run(*processor.get(), image, 4, renderTimeMs);
+    EXPECT_EQ(stubCalls("cvt_yuv2rgba"), 0);
+    EXPECT_EQ(stubCalls("cvt_rgba2yuv"), 0);
+}
+
+// The effect reuses the analyzers' RGBA copy and converts its output back once.
+HOST_TEST(effectConvertsBackOncePerFrame) {
+    const int kFrames = 8;
+    auto processor = createProcessor(parameters(kAnalyzerCount, "\"plugin.bytedance.aiEffectEnabled\":true"));
+    I420Image image(64, 48);
+    int64_t renderTimeMs = 0;
+    resetStubCalls();
+    run(*processor.get(), image, kFrames, renderTimeMs);
+    EXPECT_EQ(stubCalls("cvt_yuv2rgba"), kFrames);
+    EXPECT_EQ(stubCalls("cvt_rgba2yuv"), kFrames);
+    EXPECT_EQ(stubCalls("bef_effect_ai_process_buffer"), kFrames);
+}
+
+// On a frame with row padding every analyzer is handed the RGBA copy's own
+// geometry: the luma stride in pixels, four bytes each.
+HOST_TEST(analyzersReadTheRgbaCopyAtItsStride) {
+    auto processor = createProcessor(parameters(kAnalyzerCount));
+    I420Image image(60, 48, 64);
+    int64_t renderTimeMs = 0;
+    resetStubCalls();
+    run(*processor.get(), image, 2, renderTimeMs);
+    for (const Analyzer& analyzer : kAnalyzers) {
+        if (stubImageStride(analyzer.detect) != 64 * 4 || stubImageWidth(analyzer.detect) != 64) {
+            EXPECT_EQ(stubImageStride(analyzer.detect), 64 * 4);
+            EXPECT_EQ(stubImageWidth(analyzer.detect), 64);
+            printf("  %s\n", analyzer.detect);
+        }
+    }
+}
+
+// Once every handle exists and the buffers have their size, a frame through
+// every analyzer and the effect allocates nothing.
+HOST_TEST(noAllocationPerFrame) {
+    auto processor = createProcessor(parameters(kAnalyzerCount, "\"plugin.bytedance.aiEffectEnabled\":true"));
+    I420Image image(64, 48);
+    int64_t renderTimeMs = 0;
+    run(*processor.get(), image, 8, renderTimeMs);
+    uint64_t allocations = allocationCount();
+    run(*processor.get(), image, 32, renderTimeMs);
+    EXPECT_EQ(allocationCount() - allocations, (uint64_t)0);
+}
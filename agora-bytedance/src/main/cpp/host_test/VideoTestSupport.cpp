@@ -0,0 +1,35 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "VideoTestSupport.h"
+
+#include <algorithm>
+
+namespace agora {
+    namespace extension {
+        namespace test {
+            I420Image::I420Image(int width, int height, int yStride)
+                    : width(width), height(height), yStride(std::max(width, yStride)) {
+                y.assign((size_t)this->yStride * height, 0);
+                u.assign((size_t)chromaStride() * chromaHeight(), 128);
+                v.assign((size_t)chromaStride() * chromaHeight(), 128);
+            }
+
+            agora::media::base::VideoFrame I420Image::frame(int64_t renderTimeMs) {
+                agora::media::base::VideoFrame frame;
+                frame.type = agora::media::base::VIDEO_PIXEL_I420;
+                frame.width = width;
+                frame.height = height;
+                frame.yStride = yStride;
+                frame.uStride = chromaStride();
+                frame.vStride = chromaStride();
+                frame.yBuffer = y.data();
+                frame.uBuffer = u.data();
+                frame.vBuffer = v.data();
+                frame.renderTimeMs = renderTimeMs;
+                return frame;
+            }
+        }
+    }
+}
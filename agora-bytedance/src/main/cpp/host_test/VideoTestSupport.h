@@ -0,0 +1,47 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_VIDEOTESTSUPPORT_H
+#define AGORAWITHBYTEDANCE_VIDEOTESTSUPPORT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "AgoraRtcKit/AgoraMediaBase.h"
+
+namespace agora {
+    namespace extension {
+        namespace test {
+            // An I420 frame in owned memory; the luma stride may be wider than the
+            // picture and the chroma strides are half of it, like the SDK's frames.
+            struct I420Image {
+                int width = 0;
+                int height = 0;
+                int yStride = 0;
+                std::vector<uint8_t> y;
+                std::vector<uint8_t> u;
+                std::vector<uint8_t> v;
+
+                I420Image(int width, int height, int yStride = 0);
+
+                int chromaWidth() const { return (width + 1) / 2; }
+
+                int chromaHeight() const { return (height + 1) / 2; }
+
+                int chromaStride() const { return (yStride + 1) / 2; }
+
+                uint8_t& lumaAt(int x, int row) { return y[(size_t)row * yStride + x]; }
+
+                uint8_t& uAt(int x, int row) { return u[(size_t)row * chromaStride() + x]; }
+
+                uint8_t& vAt(int x, int row) { return v[(size_t)row * chromaStride() + x]; }
+
+                // points into this image, renderTimeMs as given
+                agora::media::base::VideoFrame frame(int64_t renderTimeMs = 0);
+            };
+        }
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_VIDEOTESTSUPPORT_H
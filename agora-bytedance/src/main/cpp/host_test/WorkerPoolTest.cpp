@@ -0,0 +1,237 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+// WorkerPool under load from several submitting threads. Build with
+// -DHOST_TEST_TSAN=ON to run it, and every other host test, under
+// ThreadSanitizer.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "HostTest.h"
+#include "SharedVideoResources.h"
+#include "WorkerPool.h"
+
+using namespace agora::extension;
+
+namespace {
+    // counts finished tasks, wait() returns once `expected` have
+    class Completion {
+    public:
+        explicit Completion(int expected) : expected_(expected) {}
+
+        void done() {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (++finished_ == expected_) {
+                finishedAll_.notify_all();
+            }
+        }
+
+        bool wait() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            return finishedAll_.wait_for(lock, std::chrono::seconds(30), [this] { return finished_ >= expected_; });
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable finishedAll_;
+        int expected_;
+        int finished_ = 0;
+    };
+
+    // the threads tasks ran on
+    class ThreadSet {
+    public:
+        void add() {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            ids_.insert(std::this_thread::get_id());
+        }
+
+        std::set<std::thread::id> ids() {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            return ids_;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::set<std::thread::id> ids_;
+    };
+
+    bool allRanOnce(const std::unique_ptr<std::atomic<int>[]>& runs, int count) {
+        for (int i = 0; i < count; i++) {
+            if (runs[i].load() != 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+// Far more tasks than the rings hold, from several threads at once: each runs exactly once.
+HOST_TEST(everyTaskRunsOnce) {
+    const int kSubmitters = 4;
+    const int kTasksEach = 5000;
+    const int kTotal = kSubmitters * kTasksEach;
+    std::unique_ptr<std::atomic<int>[]> runs(new std::atomic<int>[kTotal]);
+    for (int i = 0; i < kTotal; i++) {
+        runs[i] = 0;
+    }
+
+    Completion completion(kTotal);
+    {
+        WorkerPool pool(4, false);
+        std::vector<std::thread> submitters;
+        for (int s = 0; s < kSubmitters; s++) {
+            submitters.emplace_back([&, s] {
+                for (int i = 0; i < kTasksEach; i++) {
+                    std::atomic<int>* run = &runs[s * kTasksEach + i];
+                    pool.submit([run, &completion] {
+                        run->fetch_add(1);
+                        completion.done();
+                    });
+                }
+            });
+        }
+        for (std::thread& submitter : submitters) {
+            submitter.join();
+        }
+        EXPECT_TRUE(completion.wait());
+    }
+    EXPECT_TRUE(allRanOnce(runs, kTotal));
+}
+
+// Tasks submitted from a worker go to its own ring, other workers steal them;
+// with every ring full of parents the workers run their children themselves.
+HOST_TEST(nestedTasksRunOnce) {
+    const int kParents = 200;
+    const int kChildren = 10;
+    std::unique_ptr<std::atomic<int>[]> runs(new std::atomic<int>[kParents * kChildren]);
+    for (int i = 0; i < kParents * kChildren; i++) {
+        runs[i] = 0;
+    }
+
+    Completion completion(kParents * kChildren);
+    ThreadSet threads;
+    WorkerPool pool(3, false);
+    for (int p = 0; p < kParents; p++) {
+        pool.submit([&, p] {
+            for (int c = 0; c < kChildren; c++) {
+                std::atomic<int>* run = &runs[p * kChildren + c];
+                pool.submit([run, &completion, &threads] {
+                    run->fetch_add(1);
+                    threads.add();
+                    completion.done();
+                });
+            }
+        });
+    }
+    EXPECT_TRUE(completion.wait());
+    EXPECT_TRUE(allRanOnce(runs, kParents * kChildren));
+    EXPECT_TRUE(threads.ids().count(std::this_thread::get_id()) == 0);
+}
+
+// A worker's own tasks come back newest first.
+HOST_TEST(ownTasksPopNewestFirst) {
+    std::mutex mutex;
+    std::vector<int> order;
+    Completion completion(3);
+    WorkerPool pool(1, false);
+    pool.submit([&] {
+        for (int i = 0; i < 3; i++) {
+            pool.submit([&, i] {
+                {
+                    const std::lock_guard<std::mutex> lock(mutex);
+                    order.push_back(i);
+                }
+                completion.done();
+            });
+        }
+    });
+    EXPECT_TRUE(completion.wait());
+    const std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_TRUE(order == std::vector<int>({2, 1, 0}));
+}
+
+// The destructor runs what is still queued before the threads exit.
+HOST_TEST(destructorDrainsTheRings) {
+    std::atomic<int> runs(0);
+    {
+        WorkerPool pool(2, false);
+        for (int i = 0; i < 500; i++) {
+            pool.submit([&runs] { runs++; });
+        }
+    }
+    EXPECT_EQ(runs.load(), 500);
+}
+
+// analysisThreadCap 0: no threads, every task runs on the caller before submit() returns.
+HOST_TEST(capZeroRunsOnTheCaller) {
+    SharedVideoResources shared;
+    shared.setAnalysisThreadCap(0);
+    std::shared_ptr<WorkerPool> pool = shared.workers();
+    ASSERT_TRUE(pool != nullptr);
+    EXPECT_EQ(pool->size(), 0);
+
+    ThreadSet threads;
+    int runs = 0;
+    for (int i = 0; i < 100; i++) {
+        pool->submit([&] {
+            threads.add();
+            runs++;
+        });
+        EXPECT_EQ(runs, i + 1);
+    }
+    std::set<std::thread::id> ids = threads.ids();
+    EXPECT_TRUE(ids.size() == 1 && ids.count(std::this_thread::get_id()) == 1);
+}
+
+// analysisThreadCap 1 and N: that many threads, none of them the caller.
+HOST_TEST(capSetsTheThreadCount) {
+    const int kCaps[] = {1, 4};
+    for (int cap : kCaps) {
+        SharedVideoResources shared;
+        shared.setAnalysisThreadCap(cap);
+        std::shared_ptr<WorkerPool> pool = shared.workers();
+        EXPECT_EQ(pool->size(), cap);
+
+        const int kTasks = 2000;
+        Completion completion(kTasks);
+        ThreadSet threads;
+        for (int i = 0; i < kTasks; i++) {
+            pool->submit([&] {
+                threads.add();
+                completion.done();
+            });
+        }
+        EXPECT_TRUE(completion.wait());
+        std::set<std::thread::id> ids = threads.ids();
+        EXPECT_TRUE((int)ids.size() <= cap);
+        EXPECT_TRUE(ids.count(std::this_thread::get_id()) == 0);
+    }
+}
+
+// The pool is shared until the cap changes; one already handed out keeps working.
+HOST_TEST(capChangeRebuildsThePool) {
+    SharedVideoResources shared;
+    shared.setAnalysisThreadCap(2);
+    std::shared_ptr<WorkerPool> first = shared.workers();
+    EXPECT_TRUE(shared.workers() == first);
+    shared.setAnalysisThreadCap(2);
+    EXPECT_TRUE(shared.workers() == first);
+
+    shared.setAnalysisThreadCap(1);
+    std::shared_ptr<WorkerPool> second = shared.workers();
+    EXPECT_TRUE(second != first);
+    EXPECT_EQ(second->size(), 1);
+
+    Completion completion(1);
+    first->submit([&completion] { completion.done(); });
+    EXPECT_TRUE(completion.wait());
+}
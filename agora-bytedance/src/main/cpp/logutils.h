@@ -4,9 +4,17 @@
 
 #ifndef AGORAWITHBYTEDANCE_LOGUTILS_H
 #define AGORAWITHBYTEDANCE_LOGUTILS_H
-#include <android/log.h>
 #define LOG_TAG "Agora_zt C++"
-#define PRINTF_INFO(...) __android_log_print(ANDROID_LOG_DEBUG,LOG_TAG, __VA_ARGS__)
-#define PRINTF_ERROR(...) __android_log_print(ANDROID_LOG_ERROR,LOG_TAG, __VA_ARGS__)
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+#include <android/log.h>
+#endif
+#include "plugin_source_code/LogRing.h"
+// records are formatted and written on the log thread, each call site is rate limited
+#define PRINTF_LOG(level, ...) do { \
+    static agora::extension::LogSite logSite_; \
+    agora::extension::LogRing::getInstance().post(logSite_, level, __VA_ARGS__); \
+} while (0)
+#define PRINTF_INFO(...) PRINTF_LOG(agora::commons::LOG_LEVEL::LOG_LEVEL_INFO, __VA_ARGS__)
+#define PRINTF_ERROR(...) PRINTF_LOG(agora::commons::LOG_LEVEL::LOG_LEVEL_ERROR, __VA_ARGS__)
 #define PRINT_API_CALL(...) PRINTF_INFO("[api] %s , %s", __FUNCTION__, __VA_ARGS__)
 #endif //AGORAWITHBYTEDANCE_LOGUTILS_H
@@ -4,11 +4,16 @@
 //#include "AgoraRtcKit/IAgoraService.h"
 #include "plugin_source_code/ExtensionVideoProvider.h"
 #include "plugin_source_code/ExtensionAudioProvider.h"
+#include "plugin_source_code/ExtensionRemoteAudioProvider.h"
+#include "plugin_source_code/ExtensionRemoteVideoProvider.h"
+#include "plugin_source_code/ExtensionVideoSinkProvider.h"
 #include "logutils.h"
 #include "plugin_source_code/JniHelper.h"
 //#include "AgoraRtcKit/AgoraRefPtr.h"
 #include "plugin_source_code/JniHelper.h"
 #include "plugin_source_code/EGLCore.h"
+#include "plugin_source_code/GlContextManager.h"
+#include "plugin_source_code/LogRing.h"
 
 using namespace agora::extension;
 //static agora::extension::ExtensionProvider* extensionProvider = nullptr;
@@ -37,6 +42,8 @@ JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
 
 JNIEXPORT void JNI_OnUnload(JavaVM* vm, void* reserved) {
     PRINTF_INFO("JNI_OnUnload");
+    // the engine's control goes away with the providers, log to logcat from here on
+    LogRing::getInstance().setExtensionControl(nullptr);
 //    CHECK_EXTENSION_PROVIDER_VOID;
     agora::extension::ExtensionVideoProvider* videoProvider = agora::extension::ExtensionVideoProvider::getInstance();
     if (videoProvider) {
@@ -46,7 +53,25 @@ JNIEXPORT void JNI_OnUnload(JavaVM* vm, void* reserved) {
     if (audioProvider) {
         delete(audioProvider);
     }
+    agora::extension::ExtensionRemoteAudioProvider* remoteAudioProvider = agora::extension::ExtensionRemoteAudioProvider::getInstance();
+    if (remoteAudioProvider) {
+        delete(remoteAudioProvider);
+    }
+    agora::extension::ExtensionRemoteVideoProvider* remoteVideoProvider = agora::extension::ExtensionRemoteVideoProvider::getInstance();
+    if (remoteVideoProvider) {
+        delete(remoteVideoProvider);
+    }
+    agora::extension::ExtensionVideoSinkProvider* localSinkProvider = agora::extension::ExtensionVideoSinkProvider::getInstance(agora::rtc::IExtensionProvider::LOCAL_VIDEO_SINK);
+    if (localSinkProvider) {
+        delete(localSinkProvider);
+    }
+    agora::extension::ExtensionVideoSinkProvider* remoteSinkProvider = agora::extension::ExtensionVideoSinkProvider::getInstance(agora::rtc::IExtensionProvider::REMOTE_VIDEO_SINK);
+    if (remoteSinkProvider) {
+        delete(remoteSinkProvider);
+    }
+    GlContextManager::getInstance().releaseAll();
     JniHelper::release();
+    LogRing::getInstance().shutdown();
 }
 
 extern "C" JNIEXPORT jlong JNICALL
@@ -70,6 +95,24 @@ Java_io_agora_extension_ExtensionManager_nativeGetExtensionProvider(
             provider = agora::extension::ExtensionAudioProvider::getInstance();
             ((ExtensionAudioProvider*)provider)->setExtensionVendor(vendor);
             break;
+        case agora::rtc::IExtensionProvider::REMOTE_AUDIO_FILTER:
+            agora::extension::ExtensionRemoteAudioProvider::create();
+            provider = agora::extension::ExtensionRemoteAudioProvider::getInstance();
+            ((ExtensionRemoteAudioProvider*)provider)->setExtensionVendor(vendor);
+            break;
+        case agora::rtc::IExtensionProvider::REMOTE_VIDEO_FILTER:
+            agora::extension::ExtensionRemoteVideoProvider::create();
+            provider = agora::extension::ExtensionRemoteVideoProvider::getInstance();
+            ((ExtensionRemoteVideoProvider*)provider)->setExtensionVendor(vendor);
+            break;
+        case agora::rtc::IExtensionProvider::LOCAL_VIDEO_SINK:
+        case agora::rtc::IExtensionProvider::REMOTE_VIDEO_SINK: {
+            agora::rtc::IExtensionProvider::PROVIDER_TYPE sinkType = (agora::rtc::IExtensionProvider::PROVIDER_TYPE)type;
+            agora::extension::ExtensionVideoSinkProvider::create(sinkType);
+            provider = agora::extension::ExtensionVideoSinkProvider::getInstance(sinkType);
+            ((ExtensionVideoSinkProvider*)provider)->setExtensionVendor(vendor);
+            break;
+        }
     }
     env->ReleaseStringUTFChars(jVendor, vendor);
     return reinterpret_cast<intptr_t>(provider);
@@ -0,0 +1,41 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "ActivityBus.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace agora {
+    namespace extension {
+        ActivityBus& ActivityBus::getInstance() {
+            static ActivityBus instance;
+            return instance;
+        }
+
+        int64_t ActivityBus::nowMs() {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void ActivityBus::publishFrameEnergy(float meanSquare) {
+            static const float kFullScale = 32768.0f * 32768.0f;
+            float dbfs = meanSquare > 0 ? 10.0f * std::log10(meanSquare / kFullScale) : -100.0f;
+            int64_t now = nowMs();
+            energyDbfs_.store(dbfs, std::memory_order_relaxed);
+            lastFrameMs_.store(now, std::memory_order_relaxed);
+            if (dbfs > kSpeechThresholdDbfs) {
+                lastSpeechMs_.store(now, std::memory_order_relaxed);
+            }
+        }
+
+        bool ActivityBus::hasAudio() const {
+            return nowMs() - lastFrameMs_.load(std::memory_order_relaxed) < kStaleAfterMs;
+        }
+
+        bool ActivityBus::isSpeaking() const {
+            return nowMs() - lastSpeechMs_.load(std::memory_order_relaxed) < kSpeechHangoverMs;
+        }
+    }
+}
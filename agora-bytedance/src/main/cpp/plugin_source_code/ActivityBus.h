@@ -0,0 +1,50 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_ACTIVITYBUS_H
+#define AGORAWITHBYTEDANCE_ACTIVITYBUS_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace agora {
+    namespace extension {
+        /**
+         * Process-wide, lock-free channel from the local audio filter to the video
+         * analyzers. The audio side publishes the level of every microphone frame;
+         * the video side asks whether the local user spoke recently and adapts its
+         * detector cadence. Nothing is published if no audio filter is attached, so
+         * readers must treat "no data" as "unknown", not as "silent".
+         */
+        class ActivityBus {
+        public:
+            static constexpr float kSpeechThresholdDbfs = -45.0f;
+            static const int64_t kSpeechHangoverMs = 1500;
+            static const int64_t kStaleAfterMs = 1000;
+
+            static ActivityBus& getInstance();
+
+            static int64_t nowMs();
+
+            // Audio thread: mean square of the frame in S16 units.
+            void publishFrameEnergy(float meanSquare);
+
+            // True when audio frames are flowing.
+            bool hasAudio() const;
+
+            bool isSpeaking() const;
+
+            float speechEnergyDbfs() const { return energyDbfs_.load(std::memory_order_relaxed); }
+
+        private:
+            ActivityBus() = default;
+
+            std::atomic<float> energyDbfs_ = {-100.0f};
+            std::atomic<int64_t> lastFrameMs_ = {0};
+            std::atomic<int64_t> lastSpeechMs_ = {0};
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_ACTIVITYBUS_H
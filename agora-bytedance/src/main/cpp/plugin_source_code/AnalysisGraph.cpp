@@ -0,0 +1,189 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "AnalysisGraph.h"
+
+namespace agora {
+    namespace extension {
+        namespace {
+            thread_local int runningStage = -1;
+        }
+
+        int AnalysisGraph::currentStage() {
+            return runningStage;
+        }
+
+        void AnalysisGraph::reset() {
+            providers_.clear();
+            stages_.clear();
+            ready_.clear();
+            pending_ = 0;
+            outstanding_ = 0;
+            produced_ = 0;
+            producing_ = 0;
+        }
+
+        void AnalysisGraph::setProvider(unsigned int result, unsigned int inputs, Task provide) {
+            Provider provider;
+            provider.result = result;
+            provider.inputs = inputs;
+            provider.provide = std::move(provide);
+            providers_.push_back(std::move(provider));
+        }
+
+        bool AnalysisGraph::addStage(unsigned int inputs, unsigned int outputs, Task run, unsigned int flags) {
+            if ((int)stages_.size() >= kMaxStages) {
+                return false;
+            }
+            Stage stage;
+            stage.inputs = inputs;
+            stage.outputs = outputs;
+            stage.flags = flags;
+            stage.run = std::move(run);
+            stage.dependents = 0;
+            stage.waiting = 0;
+            stages_.push_back(std::move(stage));
+            return true;
+        }
+
+        unsigned int AnalysisGraph::expand(unsigned int inputs) const {
+            unsigned int expanded = inputs;
+            bool grown = true;
+            while (grown) {
+                grown = false;
+                for (size_t i = 0; i < providers_.size(); i++) {
+                    const Provider& provider = providers_[i];
+                    if ((expanded & provider.result) && (expanded | provider.inputs) != expanded) {
+                        expanded |= provider.inputs;
+                        grown = true;
+                    }
+                }
+            }
+            return expanded;
+        }
+
+        void AnalysisGraph::require(unsigned int results) {
+            for (size_t i = 0; i < providers_.size(); i++) {
+                const Provider& provider = providers_[i];
+                if (!(results & provider.result)) {
+                    continue;
+                }
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    if (produced_ & provider.result) {
+                        continue;
+                    }
+                    if (producing_ & provider.result) {
+                        changed_.wait(lock, [this, &provider] { return (produced_ & provider.result) != 0; });
+                        continue;
+                    }
+                    producing_ |= provider.result;
+                }
+
+                require(provider.inputs);
+                provider.provide();
+
+                {
+                    const std::lock_guard<std::mutex> lock(mutex_);
+                    produced_ |= provider.result;
+                }
+                changed_.notify_all();
+            }
+        }
+
+        void AnalysisGraph::run(WorkerPool* pool) {
+            int count = (int)stages_.size();
+            for (int j = 0; j < count; j++) {
+                Stage& later = stages_[j];
+                unsigned int reads = expand(later.inputs);
+                for (int i = 0; i < j; i++) {
+                    Stage& earlier = stages_[i];
+                    unsigned int earlierReads = expand(earlier.inputs);
+                    if ((reads & earlier.outputs) || (later.outputs & earlierReads) ||
+                        (later.outputs & earlier.outputs)) {
+                        earlier.dependents |= 1u << j;
+                        later.waiting++;
+                    }
+                }
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            pool_ = pool && pool->size() > 0 ? pool : nullptr;
+            pending_ = count;
+            outstanding_ = 0;
+            ready_.reserve(kMaxStages);
+            for (int j = 0; j < count; j++) {
+                if (stages_[j].waiting == 0) {
+                    markReady(j);
+                }
+            }
+
+            // the caller runs stages too, including the ones pinned to it
+            while (pending_ > 0 || outstanding_ > 0) {
+                int index = popReady(true);
+                if (index < 0) {
+                    changed_.wait(lock);
+                    continue;
+                }
+                lock.unlock();
+                execute(index);
+                lock.lock();
+                finish(index);
+            }
+            pool_ = nullptr;
+        }
+
+        void AnalysisGraph::markReady(int index) {
+            ready_.push_back(index);
+            if (pool_ && !(stages_[index].flags & STAGE_CALLER_THREAD)) {
+                outstanding_++;
+                pool_->submit([this] { helpRun(); });
+            }
+        }
+
+        int AnalysisGraph::popReady(bool callerThread) {
+            for (size_t i = 0; i < ready_.size(); i++) {
+                int index = ready_[i];
+                if (callerThread || !(stages_[index].flags & STAGE_CALLER_THREAD)) {
+                    ready_.erase(ready_.begin() + i);
+                    return index;
+                }
+            }
+            return -1;
+        }
+
+        void AnalysisGraph::execute(int index) {
+            Stage& stage = stages_[index];
+            runningStage = index;
+            require(stage.inputs);
+            stage.run();
+            runningStage = -1;
+        }
+
+        void AnalysisGraph::finish(int index) {
+            pending_--;
+            uint32_t dependents = stages_[index].dependents;
+            for (int j = index + 1; j < (int)stages_.size(); j++) {
+                if ((dependents & (1u << j)) && --stages_[j].waiting == 0) {
+                    markReady(j);
+                }
+            }
+            changed_.notify_all();
+        }
+
+        void AnalysisGraph::helpRun() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            outstanding_--;
+            // the caller may have taken the stage this task was submitted for
+            int index = popReady(false);
+            if (index >= 0) {
+                lock.unlock();
+                execute(index);
+                lock.lock();
+                finish(index);
+            }
+            changed_.notify_all();
+        }
+    }
+}
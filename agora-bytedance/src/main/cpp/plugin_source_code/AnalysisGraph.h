@@ -0,0 +1,104 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_ANALYSISGRAPH_H
+#define AGORAWITHBYTEDANCE_ANALYSISGRAPH_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "WorkerPool.h"
+
+namespace agora {
+    namespace extension {
+        /**
+         * Per-frame schedule of the video analyzers.
+         *
+         * Every stage declares the results it reads and writes as a bit mask
+         * (ANALYSIS_RESULT). A stage waits for each earlier stage it conflicts
+         * with: one writes what the other reads or writes. Stages without a
+         * conflict run in parallel on the worker pool, or in insertion order on
+         * the calling thread when there is no pool.
+         *
+         * Results that are not produced by a stage, such as the RGBA conversion or
+         * the face detection, come from providers. A provider runs lazily, the
+         * first time a stage needs its result, and exactly once per frame; other
+         * stages needing the result meanwhile wait for it.
+         */
+        class AnalysisGraph {
+        public:
+            typedef std::function<void()> Task;
+
+            static const int kMaxStages = 32;
+
+            enum STAGE_FLAG {
+                // the stage needs the calling thread, e.g. for its GL context
+                STAGE_CALLER_THREAD = 1 << 0,
+            };
+
+            // drops the stages and providers of the previous frame
+            void reset();
+
+            void setProvider(unsigned int result, unsigned int inputs, Task provide);
+
+            bool addStage(unsigned int inputs, unsigned int outputs, Task run, unsigned int flags = 0);
+
+            // runs the providers of the given results that have not run in this frame
+            void require(unsigned int results);
+
+            // returns once every stage has run
+            void run(WorkerPool* pool);
+
+            int stageCount() const { return (int)stages_.size(); }
+
+            // index of the stage running on this thread, or -1
+            static int currentStage();
+
+        private:
+            struct Provider {
+                unsigned int result;
+                unsigned int inputs;
+                Task provide;
+            };
+
+            struct Stage {
+                unsigned int inputs;
+                unsigned int outputs;
+                unsigned int flags;
+                Task run;
+                uint32_t dependents;
+                int waiting;
+            };
+
+            // inputs plus everything their providers read
+            unsigned int expand(unsigned int inputs) const;
+
+            void markReady(int index);
+
+            int popReady(bool callerThread);
+
+            void execute(int index);
+
+            void finish(int index);
+
+            void helpRun();
+
+            std::vector<Provider> providers_;
+            std::vector<Stage> stages_;
+            std::vector<int> ready_;
+            WorkerPool* pool_ = nullptr;
+            int pending_ = 0;
+            int outstanding_ = 0;
+            unsigned int produced_ = 0;
+            unsigned int producing_ = 0;
+            std::mutex mutex_;
+            std::condition_variable changed_;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_ANALYSISGRAPH_H
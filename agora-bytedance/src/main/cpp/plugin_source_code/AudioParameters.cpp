@@ -0,0 +1,215 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "AudioParameters.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "AgoraRtcKit/AgoraBase.h"
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+namespace agora {
+    namespace extension {
+        namespace {
+            const char* kParamsKey = "params";
+            const int kMaxTextValue = 32;
+
+            struct ParameterKey {
+                const char* name;
+                AUDIO_PARAM_TYPE type;
+                float min;
+                float max;
+                size_t offset;
+            };
+
+            const ParameterKey kKeys[] = {
+                    {"volume",         AUDIO_PARAM_INT,   0.0f,   400.0f, offsetof(AudioParameters, volume)},
+                    {"loudness",       AUDIO_PARAM_INT,   0.0f,   1.0f,   offsetof(AudioParameters, loudnessEnabled)},
+                    {"loudnessTarget", AUDIO_PARAM_FLOAT, -70.0f, 0.0f,   offsetof(AudioParameters, loudnessTarget)},
+            };
+
+            const ParameterKey* findKey(const char* name) {
+                for (const ParameterKey& key : kKeys) {
+                    if (strcmp(key.name, name) == 0) {
+                        return &key;
+                    }
+                }
+                return nullptr;
+            }
+
+            bool assign(const ParameterKey& key, double value, AudioParameters& params) {
+                // NaN passes both comparisons below
+                if (!std::isfinite(value) || value < key.min || value > key.max) {
+                    return false;
+                }
+                char* field = reinterpret_cast<char*>(&params) + key.offset;
+                if (key.type == AUDIO_PARAM_INT) {
+                    int32_t v = static_cast<int32_t>(value);
+                    if (v != value) {
+                        return false;
+                    }
+                    memcpy(field, &v, sizeof(v));
+                } else {
+                    float v = static_cast<float>(value);
+                    memcpy(field, &v, sizeof(v));
+                }
+                return true;
+            }
+
+            double read(const ParameterKey& key, const AudioParameters& params) {
+                const char* field = reinterpret_cast<const char*>(&params) + key.offset;
+                if (key.type == AUDIO_PARAM_INT) {
+                    int32_t v;
+                    memcpy(&v, field, sizeof(v));
+                    return v;
+                }
+                float v;
+                memcpy(&v, field, sizeof(v));
+                return v;
+            }
+
+            bool decodeBinary(const void* buf, int buf_size, double& value) {
+                if (buf_size != sizeof(AudioPropertyValue)) {
+                    return false;
+                }
+                AudioPropertyValue binary;
+                memcpy(&binary, buf, sizeof(binary));
+                if (binary.type == AUDIO_PARAM_INT) {
+                    value = binary.i;
+                    return true;
+                }
+                if (binary.type == AUDIO_PARAM_FLOAT) {
+                    value = binary.f;
+                    return true;
+                }
+                return false;
+            }
+
+            bool decodeText(const void* buf, int buf_size, double& value) {
+                if (buf_size <= 0 || buf_size >= kMaxTextValue) {
+                    return false;
+                }
+                char text[kMaxTextValue];
+                memcpy(text, buf, buf_size);
+                text[buf_size] = '\0';
+                char* end = nullptr;
+                value = strtod(text, &end);
+                // strtod also takes "nan" and "inf"
+                if (end == text || !std::isfinite(value)) {
+                    return false;
+                }
+                while (*end == ' ') {
+                    end++;
+                }
+                return *end == '\0';
+            }
+
+            bool decodeJson(const void* buf, int buf_size, AudioParameters& params) {
+                rapidjson::Document d;
+                d.Parse(static_cast<const char*>(buf), buf_size);
+                if (d.HasParseError() || !d.IsObject()) {
+                    return false;
+                }
+                for (auto it = d.MemberBegin(); it != d.MemberEnd(); ++it) {
+                    const ParameterKey* key = findKey(it->name.GetString());
+                    if (!key) {
+                        return false;
+                    }
+                    double value;
+                    if (it->value.IsBool()) {
+                        value = it->value.GetBool() ? 1 : 0;
+                    } else if (it->value.IsNumber()) {
+                        value = it->value.GetDouble();
+                    } else {
+                        return false;
+                    }
+                    if (!assign(*key, value, params)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        }
+
+        int AudioParameterBlock::set(const char* key, const void* buf, int buf_size) {
+            if (!key || !buf) {
+                return -ERR_INVALID_ARGUMENT;
+            }
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            AudioParameters params = params_.load();
+
+            if (strcmp(key, kParamsKey) == 0) {
+                if (!decodeJson(buf, buf_size, params)) {
+                    return -ERR_INVALID_ARGUMENT;
+                }
+            } else {
+                const ParameterKey* parameterKey = findKey(key);
+                if (!parameterKey) {
+                    return -ERR_INVALID_ARGUMENT;
+                }
+                double value;
+                if (!decodeBinary(buf, buf_size, value) && !decodeText(buf, buf_size, value)) {
+                    return -ERR_INVALID_ARGUMENT;
+                }
+                if (!assign(*parameterKey, value, params)) {
+                    return -ERR_INVALID_ARGUMENT;
+                }
+            }
+
+            params_.store(params);
+            return ERR_OK;
+        }
+
+        int AudioParameterBlock::get(const char* key, void* buf, int buf_size) const {
+            if (!key || !buf || buf_size <= 0) {
+                return -ERR_INVALID_ARGUMENT;
+            }
+            AudioParameters params = params_.load();
+            char* out = static_cast<char*>(buf);
+
+            if (strcmp(key, kParamsKey) == 0) {
+                rapidjson::StringBuffer strBuf;
+                rapidjson::Writer<rapidjson::StringBuffer> writer(strBuf);
+                writer.SetMaxDecimalPlaces(3);
+                writer.StartObject();
+                for (const ParameterKey& k : kKeys) {
+                    writer.Key(k.name);
+                    if (k.type == AUDIO_PARAM_INT) {
+                        writer.Int((int)read(k, params));
+                    } else {
+                        writer.Double(read(k, params));
+                    }
+                }
+                writer.EndObject();
+                int length = (int)strBuf.GetSize();
+                if (length >= buf_size) {
+                    return -ERR_INVALID_ARGUMENT;
+                }
+                memcpy(out, strBuf.GetString(), length + 1);
+                return length;
+            }
+
+            const ParameterKey* parameterKey = findKey(key);
+            if (!parameterKey) {
+                return -ERR_INVALID_ARGUMENT;
+            }
+            int length;
+            if (parameterKey->type == AUDIO_PARAM_INT) {
+                length = snprintf(out, buf_size, "%d", (int)read(*parameterKey, params));
+            } else {
+                length = snprintf(out, buf_size, "%.3f", read(*parameterKey, params));
+            }
+            if (length < 0 || length >= buf_size) {
+                return -ERR_INVALID_ARGUMENT;
+            }
+            return length;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_AUDIOPARAMETERS_H
+#define AGORAWITHBYTEDANCE_AUDIOPARAMETERS_H
+
+#include <cstdint>
+#include <mutex>
+
+#include "SeqLock.h"
+
+namespace agora {
+    namespace extension {
+        /**
+         * Snapshot of every audio filter parameter. The audio thread reads one
+         * consistent copy per frame.
+         */
+        struct AudioParameters {
+            int32_t volume = 100;           // percent
+            int32_t loudnessEnabled = 0;
+            float loudnessTarget = -23.0f;  // LUFS
+        };
+
+        enum AUDIO_PARAM_TYPE {
+            AUDIO_PARAM_INT = 1,
+            AUDIO_PARAM_FLOAT = 2,
+        };
+
+        /**
+         * Binary payload accepted by setProperty() from native callers. A text
+         * payload can never be mistaken for it: the tag's upper bytes are zero.
+         */
+        struct AudioPropertyValue {
+            int32_t type;  // AUDIO_PARAM_TYPE
+            union {
+                int32_t i;
+                float f;
+            };
+        };
+
+        /**
+         * Typed parameter block behind the audio filters' setProperty/getProperty.
+         *
+         * Keys are looked up in a static table; a value may be a binary
+         * AudioPropertyValue, a decimal string, or (key "params") a JSON object
+         * setting several keys at once. Invalid input is rejected as a whole
+         * without touching the published parameters.
+         */
+        class AudioParameterBlock {
+        public:
+            explicit AudioParameterBlock(const AudioParameters& defaults = AudioParameters())
+                    : params_(defaults) {}
+
+            AudioParameters snapshot() const { return params_.load(); }
+
+            int set(const char* key, const void* buf, int buf_size);
+
+            int get(const char* key, void* buf, int buf_size) const;
+
+        private:
+            std::mutex writeMutex_;
+            SeqLock<AudioParameters> params_;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_AUDIOPARAMETERS_H
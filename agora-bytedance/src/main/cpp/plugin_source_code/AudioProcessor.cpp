@@ -3,27 +3,39 @@
 //
 
 #include "AudioProcessor.h"
+#include "AudioUtils.h"
+#include "ActivityBus.h"
 #include <chrono>
 #include "../logutils.h"
 
 namespace agora {
     namespace extension {
-        using limits_int16 = std::numeric_limits<int16_t>;
-        int16_t AdjustVolumeAudioProcessor::FloatS16ToS16(float v) {
-            static const float kMaxRound = (limits_int16::max)() - 0.5f;
-            static const float kMinRound = (limits_int16::min)() + 0.5f;
-            if (v > 0) {
-                return v >= kMaxRound ? (limits_int16::max)() : static_cast<int16_t>(v + 0.5f);
-            }
-            return v <= kMinRound ? (limits_int16::min)() : static_cast<int16_t>(v - 0.5f);
-        }
-
         int AdjustVolumeAudioProcessor::processFrame(const media::base::AudioPcmFrame& inAudioPcmFrame,
                                                       media::base::AudioPcmFrame& adaptedPcmFrame) {
-//            PRINTF_ERROR("adaptAudioFrame %f", volume_.load());
             size_t length = inAudioPcmFrame.samples_per_channel_ * inAudioPcmFrame.num_channels_;
-            for (int idx = 0; idx < length; idx++) {
-                adaptedPcmFrame.data_[idx] = FloatS16ToS16(inAudioPcmFrame.data_[idx] * volume_);
+            float energy = 0.0f;
+            for (size_t idx = 0; idx < length; idx++) {
+                float sample = inAudioPcmFrame.data_[idx];
+                energy += sample * sample;
+            }
+            ActivityBus::getInstance().publishFrameEnergy(length > 0 ? energy / length : 0.0f);
+
+            AudioParameters params = parameters_.snapshot();
+            float volume = params.volume / 100.0f;
+//            PRINTF_ERROR("adaptAudioFrame %f", volume);
+            if (params.loudnessEnabled) {
+                if (!loudnessActive_) {
+                    loudness_.reset();
+                    loudnessActive_ = true;
+                }
+                loudness_.setTargetLufs(params.loudnessTarget);
+                loudness_.process(inAudioPcmFrame, adaptedPcmFrame, volume);
+                return 0;
+            }
+            loudnessActive_ = false;
+
+            for (size_t idx = 0; idx < length; idx++) {
+                adaptedPcmFrame.data_[idx] = FloatS16ToS16(inAudioPcmFrame.data_[idx] * volume);
             }
             return 0;
         }
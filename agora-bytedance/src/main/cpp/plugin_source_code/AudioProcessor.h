@@ -5,6 +5,7 @@
 #ifndef AGORAWITHBYTEDANCE_AUDIOPROCESSOR_H
 #define AGORAWITHBYTEDANCE_AUDIOPROCESSOR_H
 
+#include <atomic>
 #include <thread>
 #include <string>
 #include <mutex>
@@ -13,6 +14,8 @@
 #include <AgoraRtcKit/NGIAgoraExtensionControl.h>
 
 #include "AgoraRtcKit/AgoraMediaBase.h"
+#include "AudioParameters.h"
+#include "LoudnessNormalizer.h"
 
 
 namespace agora {
@@ -24,7 +27,7 @@ namespace agora {
 
             void dataCallback(const char* data);
 
-            void setVolume(int volume) { volume_ = volume / 100.0f; }
+            AudioParameterBlock& parameters() { return parameters_; }
 
             int setExtensionControl(agora::rtc::IExtensionControl* control){
                 control_ = control;
@@ -45,9 +48,10 @@ namespace agora {
         protected:
             ~AdjustVolumeAudioProcessor() {}
         private:
-            static int16_t FloatS16ToS16(float v);
-        private:
-            std::atomic<float> volume_ = {1.0f};
+            AudioParameterBlock parameters_;
+            // only touched on the audio thread
+            LoudnessNormalizer loudness_;
+            bool loudnessActive_ = false;
             agora::rtc::IExtensionControl* control_;
             char* id_;
         };
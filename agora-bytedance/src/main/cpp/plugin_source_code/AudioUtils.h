@@ -0,0 +1,27 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_AUDIOUTILS_H
+#define AGORAWITHBYTEDANCE_AUDIOUTILS_H
+
+#include <cstdint>
+#include <limits>
+
+namespace agora {
+    namespace extension {
+        using limits_int16 = std::numeric_limits<int16_t>;
+
+        // Rounds a float in S16 range to int16, saturating instead of wrapping.
+        inline int16_t FloatS16ToS16(float v) {
+            static const float kMaxRound = (limits_int16::max)() - 0.5f;
+            static const float kMinRound = (limits_int16::min)() + 0.5f;
+            if (v > 0) {
+                return v >= kMaxRound ? (limits_int16::max)() : static_cast<int16_t>(v + 0.5f);
+            }
+            return v <= kMinRound ? (limits_int16::min)() : static_cast<int16_t>(v - 0.5f);
+        }
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_AUDIOUTILS_H
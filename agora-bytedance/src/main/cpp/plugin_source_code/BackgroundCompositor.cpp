@@ -0,0 +1,274 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "BackgroundCompositor.h"
+
+#include <algorithm>
+
+namespace agora {
+    namespace extension {
+        namespace {
+            const int kFixedShift = 16;
+            const int kFixedOne = 1 << kFixedShift;
+
+            uint8_t clampByte(int value) {
+                return (uint8_t)std::min(255, std::max(0, value));
+            }
+
+            // (a * alpha + b * (255 - alpha)) / 255 with rounding
+            inline uint8_t blend(int a, int b, int alpha) {
+                int v = b * 255 + (a - b) * alpha + 127;
+                return (uint8_t)((v + (v >> 8) + 1) >> 8);
+            }
+
+            // one box pass along rows: src (stride) -> dst (width), edges clamped
+            void boxRows(const uint8_t* src, int srcStride, uint8_t* dst,
+                         int width, int height, int radius) {
+                uint32_t scale = kFixedOne / (2 * radius + 1);
+                for (int y = 0; y < height; y++) {
+                    const uint8_t* in = src + y * srcStride;
+                    uint8_t* out = dst + y * width;
+                    uint32_t first = in[0];
+                    uint32_t last = in[width - 1];
+                    uint32_t sum = first * (radius + 1);
+                    for (int x = 1; x <= radius; x++) {
+                        sum += x < width ? in[x] : last;
+                    }
+                    int x = 0;
+                    // left edge, then the clamp-free middle, then the right edge
+                    for (; x < width && x <= radius; x++) {
+                        out[x] = (uint8_t)((sum * scale + kFixedOne / 2) >> kFixedShift);
+                        sum += (x + radius + 1 < width ? in[x + radius + 1] : last) - first;
+                    }
+                    for (; x + radius + 1 < width; x++) {
+                        out[x] = (uint8_t)((sum * scale + kFixedOne / 2) >> kFixedShift);
+                        sum += in[x + radius + 1] - in[x - radius];
+                    }
+                    for (; x < width; x++) {
+                        out[x] = (uint8_t)((sum * scale + kFixedOne / 2) >> kFixedShift);
+                        sum += last - in[x - radius];
+                    }
+                }
+            }
+
+            // one box pass along columns, row by row so the inner loop vectorizes
+            void boxColumns(const uint8_t* src, uint8_t* dst, uint32_t* sums,
+                            int width, int height, int radius) {
+                uint32_t scale = kFixedOne / (2 * radius + 1);
+                for (int x = 0; x < width; x++) {
+                    sums[x] = src[x] * (radius + 1);
+                }
+                for (int y = 1; y <= radius; y++) {
+                    const uint8_t* row = src + std::min(y, height - 1) * width;
+                    for (int x = 0; x < width; x++) {
+                        sums[x] += row[x];
+                    }
+                }
+                for (int y = 0; y < height; y++) {
+                    uint8_t* out = dst + y * width;
+                    const uint8_t* add = src + std::min(y + radius + 1, height - 1) * width;
+                    const uint8_t* sub = src + std::max(y - radius, 0) * width;
+                    for (int x = 0; x < width; x++) {
+                        out[x] = (uint8_t)((sums[x] * scale + kFixedOne / 2) >> kFixedShift);
+                        sums[x] += add[x] - sub[x];
+                    }
+                }
+            }
+
+            // 2x2 average, odd edges replicated
+            void halve(const uint8_t* src, int stride, int width, int height, uint8_t* dst) {
+                int dstWidth = (width + 1) / 2;
+                int dstHeight = (height + 1) / 2;
+                for (int y = 0; y < dstHeight; y++) {
+                    const uint8_t* top = src + 2 * y * stride;
+                    const uint8_t* bottom = src + std::min(2 * y + 1, height - 1) * stride;
+                    uint8_t* out = dst + y * dstWidth;
+                    for (int x = 0; x < width / 2; x++) {
+                        out[x] = (uint8_t)((top[2 * x] + top[2 * x + 1] +
+                                            bottom[2 * x] + bottom[2 * x + 1] + 2) >> 2);
+                    }
+                    if (width & 1) {
+                        out[dstWidth - 1] = (uint8_t)((top[width - 1] + bottom[width - 1] + 1) >> 1);
+                    }
+                }
+            }
+
+            // inverse of halve(): bilinear 2x with fixed 1/4, 3/4 weights
+            void double2x(const uint8_t* src, int srcWidth, int srcHeight,
+                          uint8_t* dst, int width, int height, uint16_t* row) {
+                for (int y = 0; y < height; y++) {
+                    int center = std::min(y / 2, srcHeight - 1);
+                    int neighbour = (y & 1) ? std::min(center + 1, srcHeight - 1) : std::max(center - 1, 0);
+                    const uint8_t* a = src + center * srcWidth;
+                    const uint8_t* b = src + neighbour * srcWidth;
+                    for (int x = 0; x < srcWidth; x++) {
+                        row[x] = (uint16_t)(3 * a[x] + b[x]);
+                    }
+                    uint8_t* out = dst + (size_t)y * width;
+                    int last = srcWidth - 1;
+                    out[0] = (uint8_t)((row[0] + 2) >> 2);
+                    for (int i = 0; i < last; i++) {
+                        out[2 * i + 1] = (uint8_t)((3 * row[i] + row[i + 1] + 8) >> 4);
+                        out[2 * i + 2] = (uint8_t)((row[i] + 3 * row[i + 1] + 8) >> 4);
+                    }
+                    if (width == 2 * srcWidth) {
+                        out[width - 1] = (uint8_t)((row[last] + 2) >> 2);
+                    }
+                }
+            }
+
+            // bilinear resize with pixel centers aligned; index/weight are scratch
+            void resizeBilinear(const uint8_t* src, int srcWidth, int srcHeight,
+                                uint8_t* dst, int width, int height,
+                                std::vector<int>& index, std::vector<int>& weight) {
+                index.resize(width);
+                weight.resize(width);
+                int64_t stepX = ((int64_t)srcWidth << kFixedShift) / width;
+                int64_t stepY = ((int64_t)srcHeight << kFixedShift) / height;
+                for (int x = 0; x < width; x++) {
+                    int64_t sx = std::max<int64_t>(0, x * stepX + stepX / 2 - kFixedOne / 2);
+                    int i = std::min((int)(sx >> kFixedShift), srcWidth - 1);
+                    index[x] = i;
+                    weight[x] = i + 1 < srcWidth ? (int)((sx >> 8) & 0xFF) : 0;
+                }
+
+                for (int y = 0; y < height; y++) {
+                    int64_t sy = std::max<int64_t>(0, y * stepY + stepY / 2 - kFixedOne / 2);
+                    int row = std::min((int)(sy >> kFixedShift), srcHeight - 1);
+                    int wy = row + 1 < srcHeight ? (int)((sy >> 8) & 0xFF) : 0;
+                    const uint8_t* top = src + row * srcWidth;
+                    const uint8_t* bottom = src + std::min(row + 1, srcHeight - 1) * srcWidth;
+                    uint8_t* out = dst + (size_t)y * width;
+                    for (int x = 0; x < width; x++) {
+                        int i = index[x];
+                        int wx = weight[x];
+                        int j = wx ? i + 1 : i;
+                        int t = top[i] * (256 - wx) + top[j] * wx;
+                        int b = bottom[i] * (256 - wx) + bottom[j] * wx;
+                        out[x] = (uint8_t)((t * (256 - wy) + b * wy + (1 << 15)) >> 16);
+                    }
+                }
+            }
+        }
+
+        void BackgroundCompositor::setBlurRadius(int radius) {
+            blurRadius_ = std::min(std::max(1, radius), (int)kMaxBlurRadius);
+        }
+
+        void BackgroundCompositor::setColor(uint32_t rgb) {
+            int r = (rgb >> 16) & 0xFF;
+            int g = (rgb >> 8) & 0xFF;
+            int b = rgb & 0xFF;
+            // BT.601 limited range, as produced by the capture pipeline
+            colorY_ = clampByte(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+            colorU_ = clampByte(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+            colorV_ = clampByte(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+        }
+
+        void BackgroundCompositor::setMask(const agora_refptr<SegmentationMask>& mask) {
+            // a published mask is immutable, a new result always comes in a new object
+            if (mask.get() != mask_.get()) {
+                mask_ = mask;
+                maskDirty_ = true;
+            }
+        }
+
+        void BackgroundCompositor::reset() {
+            mode_ = BACKGROUND_NONE;
+            mask_ = nullptr;
+            maskDirty_ = false;
+            maskedStride_ = 0;
+            maskedHeight_ = 0;
+            std::vector<uint8_t>().swap(lumaMask_);
+            std::vector<uint8_t>().swap(chromaMask_);
+            std::vector<uint8_t>().swap(reduced_);
+            std::vector<uint8_t>().swap(horizontal_);
+            std::vector<uint8_t>().swap(blurred_);
+            std::vector<uint32_t>().swap(columnSums_);
+        }
+
+        void BackgroundCompositor::blurPlane(const Plane& plane, int radius) {
+            // the background is blurred at half resolution and scaled back up;
+            // columnSums_ doubles as the row buffer of the upscale
+            int width = (plane.width + 1) / 2;
+            int height = (plane.height + 1) / 2;
+            reduced_.resize((size_t)width * height);
+            horizontal_.resize((size_t)width * height);
+            blurred_.resize((size_t)plane.width * plane.height);
+            columnSums_.resize(width);
+
+            halve(plane.data, plane.stride, plane.width, plane.height, reduced_.data());
+            radius = std::max(1, radius / 2);
+            // two box passes approximate a gaussian
+            for (int pass = 0; pass < 2; pass++) {
+                boxRows(reduced_.data(), width, horizontal_.data(), width, height, radius);
+                boxColumns(horizontal_.data(), reduced_.data(), columnSums_.data(), width, height, radius);
+            }
+            double2x(reduced_.data(), width, height, blurred_.data(), plane.width, plane.height,
+                     reinterpret_cast<uint16_t*>(columnSums_.data()));
+        }
+
+        void BackgroundCompositor::compositeBlurred(const Plane& plane, const std::vector<uint8_t>& mask) {
+            for (int y = 0; y < plane.height; y++) {
+                uint8_t* fg = plane.data + y * plane.stride;
+                const uint8_t* bg = blurred_.data() + y * plane.width;
+                const uint8_t* alpha = mask.data() + y * plane.maskStride;
+                for (int x = 0; x < plane.width; x++) {
+                    fg[x] = blend(fg[x], bg[x], alpha[x]);
+                }
+            }
+        }
+
+        void BackgroundCompositor::compositeColor(const Plane& plane, const std::vector<uint8_t>& mask,
+                                                  uint8_t value) {
+            for (int y = 0; y < plane.height; y++) {
+                uint8_t* fg = plane.data + y * plane.stride;
+                const uint8_t* alpha = mask.data() + y * plane.maskStride;
+                for (int x = 0; x < plane.width; x++) {
+                    fg[x] = blend(fg[x], value, alpha[x]);
+                }
+            }
+        }
+
+        void BackgroundCompositor::apply(const agora::media::base::VideoFrame &frame) {
+            if (mode_ == BACKGROUND_NONE || !hasMask() || frame.width <= 0 || frame.height <= 0) {
+                return;
+            }
+
+            int chromaWidth = (frame.width + 1) / 2;
+            int chromaHeight = (frame.height + 1) / 2;
+            int lumaMaskStride = std::max(frame.yStride, frame.width);
+            int chromaMaskStride = (lumaMaskStride + 1) / 2;
+            if (maskDirty_ || maskedStride_ != lumaMaskStride || maskedHeight_ != frame.height) {
+                lumaMask_.resize((size_t)lumaMaskStride * frame.height);
+                chromaMask_.resize((size_t)chromaMaskStride * chromaHeight);
+                const MaskRegion& region = mask_->region(0);
+                resizeBilinear(region.alpha.data(), region.width, region.height, lumaMask_.data(),
+                               lumaMaskStride, frame.height, sampleIndex_, sampleWeight_);
+                resizeBilinear(region.alpha.data(), region.width, region.height, chromaMask_.data(),
+                               chromaMaskStride, chromaHeight, sampleIndex_, sampleWeight_);
+                maskedStride_ = lumaMaskStride;
+                maskedHeight_ = frame.height;
+                maskDirty_ = false;
+            }
+
+            Plane planes[3] = {
+                    {frame.yBuffer, frame.yStride, frame.width, frame.height, lumaMaskStride},
+                    {frame.uBuffer, frame.uStride, chromaWidth, chromaHeight, chromaMaskStride},
+                    {frame.vBuffer, frame.vStride, chromaWidth, chromaHeight, chromaMaskStride},
+            };
+            uint8_t colors[3] = {colorY_, colorU_, colorV_};
+            for (int i = 0; i < 3; i++) {
+                const std::vector<uint8_t>& mask = i == 0 ? lumaMask_ : chromaMask_;
+                if (mode_ == BACKGROUND_BLUR) {
+                    int radius = i == 0 ? blurRadius_ : std::max(1, blurRadius_ / 2);
+                    blurPlane(planes[i], radius);
+                    compositeBlurred(planes[i], mask);
+                } else {
+                    compositeColor(planes[i], mask, colors[i]);
+                }
+            }
+        }
+    }
+}
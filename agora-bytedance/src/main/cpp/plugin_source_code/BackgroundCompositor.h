@@ -0,0 +1,99 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_BACKGROUNDCOMPOSITOR_H
+#define AGORAWITHBYTEDANCE_BACKGROUNDCOMPOSITOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "AgoraRtcKit/AgoraMediaBase.h"
+#include "MaskCache.h"
+
+namespace agora {
+    namespace extension {
+        enum BACKGROUND_MODE {
+            BACKGROUND_NONE = 0,
+            BACKGROUND_BLUR = 1,
+            BACKGROUND_COLOR = 2,
+        };
+
+        /**
+         * Virtual background on I420 frames, driven by a low resolution portrait
+         * alpha mask (255 = person).
+         *
+         * The mask comes from the MaskCache (first region, single channel). It is
+         * inferred from the processor's RGBA copy, which spans the whole luma
+         * stride, so it is upsampled bilinearly to the stride rather than the
+         * visible width of each plane, and only when a new one is set: frames
+         * between two matting runs reuse it as is. The
+         * background is either blurred (at half resolution, separable two-pass box
+         * filter, bilinear upscale) or replaced by a solid color, and blended with
+         * the original planes in place.
+         * All scratch memory is kept between frames.
+         */
+        class BackgroundCompositor {
+        public:
+            static const int kMaxBlurRadius = 32;
+
+            BackgroundCompositor() { setColor(0x00B140); }
+
+            void setMode(BACKGROUND_MODE mode) { mode_ = mode; }
+
+            BACKGROUND_MODE mode() const { return mode_; }
+
+            void setBlurRadius(int radius);
+
+            // 0xRRGGBB
+            void setColor(uint32_t rgb);
+
+            void setMask(const agora_refptr<SegmentationMask>& mask);
+
+            bool hasMask() const { return mask_ && mask_->regionCount() > 0; }
+
+            void reset();
+
+            void apply(const agora::media::base::VideoFrame &frame);
+
+        private:
+            struct Plane {
+                uint8_t* data;
+                int stride;
+                int width;
+                int height;
+                // row length of the plane's upsampled mask
+                int maskStride;
+            };
+
+            void blurPlane(const Plane& plane, int radius);
+            void compositeBlurred(const Plane& plane, const std::vector<uint8_t>& mask);
+            void compositeColor(const Plane& plane, const std::vector<uint8_t>& mask, uint8_t value);
+
+            BACKGROUND_MODE mode_ = BACKGROUND_NONE;
+            int blurRadius_ = 12;
+            uint8_t colorY_ = 0;
+            uint8_t colorU_ = 0;
+            uint8_t colorV_ = 0;
+
+            agora_refptr<SegmentationMask> mask_;
+            bool maskDirty_ = false;
+
+            std::vector<uint8_t> lumaMask_;
+            std::vector<uint8_t> chromaMask_;
+            int maskedStride_ = 0;
+            int maskedHeight_ = 0;
+
+            // blur scratch: half resolution plane, horizontal pass output,
+            // blurred full resolution plane, column sums
+            std::vector<uint8_t> reduced_;
+            std::vector<uint8_t> horizontal_;
+            std::vector<uint8_t> blurred_;
+            std::vector<uint32_t> columnSums_;
+            std::vector<int> sampleIndex_;
+            std::vector<int> sampleWeight_;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_BACKGROUNDCOMPOSITOR_H
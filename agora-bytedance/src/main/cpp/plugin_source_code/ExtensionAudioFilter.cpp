@@ -4,7 +4,6 @@
 
 #include "ExtensionAudioFilter.h"
 #include "../logutils.h"
-#include <sstream>
 
 namespace agora {
     namespace extension {
@@ -22,14 +21,11 @@ namespace agora {
         }
 
         int ExtensionAudioFilter::setProperty(const char* key, const void* buf, int buf_size) {
-            std::string str_volume = "100";
-            if (std::string(key) == "volume") {
-                str_volume = std::string(static_cast<const char*>(buf), buf_size);
-            }
+            return audioProcessor_->parameters().set(key, buf, buf_size);
+        }
 
-            int int_volume_ = atoi(str_volume.c_str());
-            audioProcessor_->setVolume(int_volume_);
-            return ERR_OK;
+        int ExtensionAudioFilter::getProperty(const char* key, void* buf, int buf_size) const {
+            return audioProcessor_->parameters().get(key, buf, buf_size);
         }
     }
 }
@@ -5,6 +5,7 @@
 #ifndef AGORAWITHBYTEDANCE_EXTENSIONAUDIOFILTER_H
 #define AGORAWITHBYTEDANCE_EXTENSIONAUDIOFILTER_H
 
+#include <atomic>
 #include "AgoraRtcKit/NGIAgoraMediaNode.h"
 #include <AgoraRtcKit/AgoraRefCountedObject.h>
 #include "AgoraRtcKit/AgoraRefPtr.h"
@@ -21,7 +22,7 @@ namespace agora {
             void setEnabled(bool enable) override { enabled_ = enable; }
             bool isEnabled() const override { return enabled_; }
             int setProperty(const char* key, const void* buf, int buf_size) override;
-            int getProperty(const char* key, void* buf, int buf_size) const override { return ERR_OK; }
+            int getProperty(const char* key, void* buf, int buf_size) const override;
             const char* getName() const override { return audioProcessor_->getVendorName(); }
         private:
             std::atomic_bool enabled_ = {true};
@@ -4,6 +4,7 @@
 
 #include "ExtensionAudioProvider.h"
 #include "../logutils.h"
+#include "LogRing.h"
 #include "AudioProcessor.h"
 
 namespace agora {
@@ -44,6 +45,7 @@ namespace agora {
         }
 
         void ExtensionAudioProvider::setExtensionControl(rtc::IExtensionControl* control){
+            LogRing::getInstance().setExtensionControl(control);
             audioProcessor_->setExtensionControl(control);
         }
     }
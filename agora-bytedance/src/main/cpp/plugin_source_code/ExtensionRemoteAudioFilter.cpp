@@ -0,0 +1,34 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "ExtensionRemoteAudioFilter.h"
+#include "../logutils.h"
+
+namespace agora {
+    namespace extension {
+        ExtensionRemoteAudioFilter::ExtensionRemoteAudioFilter(agora_refptr<RemoteAudioProcessor> remoteAudioProcessor) {
+            audioProcessor_ = remoteAudioProcessor;
+            if (!audioProcessor_->acquireStream(stream_)) {
+                PRINTF_ERROR("ExtensionRemoteAudioFilter stream table full, passing through");
+            }
+        }
+
+        ExtensionRemoteAudioFilter::~ExtensionRemoteAudioFilter() {
+            audioProcessor_->releaseStream(stream_);
+        }
+
+        bool ExtensionRemoteAudioFilter::adaptAudioFrame(const media::base::AudioPcmFrame& inAudioPcmFrame,
+                                                         media::base::AudioPcmFrame& adaptedPcmFrame) {
+            return audioProcessor_->processFrame(stream_, inAudioPcmFrame, adaptedPcmFrame) == 0;
+        }
+
+        int ExtensionRemoteAudioFilter::setProperty(const char* key, const void* buf, int buf_size) {
+            return audioProcessor_->parameters().set(key, buf, buf_size);
+        }
+
+        int ExtensionRemoteAudioFilter::getProperty(const char* key, void* buf, int buf_size) const {
+            return audioProcessor_->parameters().get(key, buf, buf_size);
+        }
+    }
+}
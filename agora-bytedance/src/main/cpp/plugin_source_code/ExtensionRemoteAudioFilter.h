@@ -0,0 +1,38 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_EXTENSIONREMOTEAUDIOFILTER_H
+#define AGORAWITHBYTEDANCE_EXTENSIONREMOTEAUDIOFILTER_H
+
+#include <atomic>
+#include "AgoraRtcKit/NGIAgoraMediaNode.h"
+#include <AgoraRtcKit/AgoraRefCountedObject.h>
+#include "AgoraRtcKit/AgoraRefPtr.h"
+#include "RemoteAudioProcessor.h"
+
+namespace agora {
+    namespace extension {
+        class ExtensionRemoteAudioFilter : public agora::rtc::IAudioFilter {
+        public:
+            ExtensionRemoteAudioFilter(agora_refptr<RemoteAudioProcessor> remoteAudioProcessor);
+            ~ExtensionRemoteAudioFilter();
+            bool adaptAudioFrame(const media::base::AudioPcmFrame& inAudioPcmFrame,
+                                 media::base::AudioPcmFrame& adaptedPcmFrame) override;
+            void setEnabled(bool enable) override { enabled_ = enable; }
+            bool isEnabled() const override { return enabled_; }
+            int setProperty(const char* key, const void* buf, int buf_size) override;
+            int getProperty(const char* key, void* buf, int buf_size) const override;
+            const char* getName() const override { return audioProcessor_->getVendorName(); }
+        private:
+            std::atomic_bool enabled_ = {true};
+            agora_refptr<RemoteAudioProcessor> audioProcessor_;
+            RemoteAudioStreamHandle stream_;
+        protected:
+            ExtensionRemoteAudioFilter() = default;
+        };
+    }
+}
+
+
+#endif //AGORAWITHBYTEDANCE_EXTENSIONREMOTEAUDIOFILTER_H
@@ -0,0 +1,52 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "ExtensionRemoteAudioProvider.h"
+#include "../logutils.h"
+#include "LogRing.h"
+#include "RemoteAudioProcessor.h"
+
+namespace agora {
+    namespace extension {
+        ExtensionRemoteAudioProvider* ExtensionRemoteAudioProvider::instance_;
+        ExtensionRemoteAudioProvider::ExtensionRemoteAudioProvider() {
+            PRINTF_INFO("ExtensionRemoteAudioProvider create");
+            audioProcessor_ = new agora::RefCountedObject<RemoteAudioProcessor>();
+        }
+
+        ExtensionRemoteAudioProvider::~ExtensionRemoteAudioProvider() {
+            PRINTF_INFO("ExtensionRemoteAudioProvider destroy");
+            instance_ = nullptr;
+        }
+
+        int ExtensionRemoteAudioProvider::setExtensionVendor(std::string vendor) {
+            PRINTF_INFO("ExtensionRemoteAudioProvider vendor %s", vendor.c_str());
+            audioProcessor_->setVendorName(vendor.c_str());
+            return 0;
+        }
+
+        agora_refptr<agora::rtc::IVideoFilter> ExtensionRemoteAudioProvider::createVideoFilter() {
+            return nullptr;
+        }
+
+        agora_refptr<agora::rtc::IAudioFilter> ExtensionRemoteAudioProvider::createAudioFilter() {
+            PRINTF_INFO("ExtensionRemoteAudioProvider::createAudioFilter");
+            auto audioFilter = new agora::RefCountedObject<agora::extension::ExtensionRemoteAudioFilter>(audioProcessor_);
+            return audioFilter;
+        }
+
+        agora_refptr<agora::rtc::IVideoSinkBase> ExtensionRemoteAudioProvider::createVideoSink() {
+            return nullptr;
+        }
+
+        ExtensionRemoteAudioProvider::PROVIDER_TYPE ExtensionRemoteAudioProvider::getProviderType() {
+            return agora::rtc::IExtensionProvider::REMOTE_AUDIO_FILTER;
+        }
+
+        void ExtensionRemoteAudioProvider::setExtensionControl(rtc::IExtensionControl* control){
+            LogRing::getInstance().setExtensionControl(control);
+            audioProcessor_->setExtensionControl(control);
+        }
+    }
+}
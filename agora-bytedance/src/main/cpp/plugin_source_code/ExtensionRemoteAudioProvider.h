@@ -0,0 +1,46 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_EXTENSION_REMOTEAUDIOPROVIDER_H
+#define AGORAWITHBYTEDANCE_EXTENSION_REMOTEAUDIOPROVIDER_H
+
+#include "AgoraRtcKit/NGIAgoraExtensionProvider.h"
+#include "ExtensionRemoteAudioFilter.h"
+
+namespace agora {
+    namespace extension {
+        class ExtensionRemoteAudioProvider : public agora::rtc::IExtensionProvider {
+        private:
+            static ExtensionRemoteAudioProvider* instance_;
+            agora_refptr<RemoteAudioProcessor> audioProcessor_;
+        public:
+            static void create() {
+                if (instance_ == nullptr){
+                    instance_ = new agora::RefCountedObject<ExtensionRemoteAudioProvider>();
+                }
+            }
+
+            static ExtensionRemoteAudioProvider* getInstance(){
+                return instance_;
+            };
+
+            ExtensionRemoteAudioProvider();
+
+            ~ExtensionRemoteAudioProvider();
+
+            PROVIDER_TYPE getProviderType() override;
+
+            virtual void setExtensionControl(rtc::IExtensionControl* control) override;
+
+            virtual agora_refptr<rtc::IAudioFilter> createAudioFilter() override;
+
+            virtual agora_refptr<rtc::IVideoFilter> createVideoFilter() override;
+
+            virtual agora_refptr<rtc::IVideoSinkBase> createVideoSink() override;
+
+            int setExtensionVendor(std::string vendor);
+        };
+    }
+}
+#endif //AGORAWITHBYTEDANCE_EXTENSION_REMOTEAUDIOPROVIDER_H
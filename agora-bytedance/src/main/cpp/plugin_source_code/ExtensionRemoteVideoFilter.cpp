@@ -0,0 +1,37 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "ExtensionRemoteVideoFilter.h"
+#include "../logutils.h"
+
+#include <cstring>
+
+namespace agora {
+    namespace extension {
+        ExtensionRemoteVideoFilter::ExtensionRemoteVideoFilter(agora_refptr<RemoteVideoProcessor> remoteVideoProcessor) {
+            videoProcessor_ = remoteVideoProcessor;
+        }
+
+        bool ExtensionRemoteVideoFilter::adaptVideoFrame(const agora::media::base::VideoFrame &capturedFrame,
+                                                         agora::media::base::VideoFrame &adaptedFrame) {
+            if (enabled_) {
+                videoProcessor_->processFrame(stream_, capturedFrame);
+            }
+            adaptedFrame = capturedFrame;
+            return true;
+        }
+
+        size_t ExtensionRemoteVideoFilter::setProperty(const char *key, const void *buf, size_t buf_size) {
+            // the SDK does not promise a terminated buffer
+            std::string stringParameter((const char*)buf, strnlen((const char*)buf, buf_size));
+            PRINTF_INFO("setProperty  %s  %s", key, stringParameter.c_str());
+            videoProcessor_->setParameters(stringParameter);
+            return 0;
+        }
+
+        size_t ExtensionRemoteVideoFilter::getProperty(const char *, void *, size_t) {
+            return 0;
+        }
+    }
+}
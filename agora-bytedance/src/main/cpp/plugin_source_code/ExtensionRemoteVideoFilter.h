@@ -0,0 +1,43 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_EXTENSIONREMOTEVIDEOFILTER_H
+#define AGORAWITHBYTEDANCE_EXTENSIONREMOTEVIDEOFILTER_H
+
+#include <atomic>
+#include "AgoraRtcKit/NGIAgoraMediaNode.h"
+#include <AgoraRtcKit/AgoraRefCountedObject.h>
+#include "AgoraRtcKit/AgoraRefPtr.h"
+#include "RemoteVideoProcessor.h"
+
+namespace agora {
+    namespace extension {
+        class ExtensionRemoteVideoFilter : public agora::rtc::IVideoFilter {
+        public:
+            ExtensionRemoteVideoFilter(agora_refptr<RemoteVideoProcessor> remoteVideoProcessor);
+
+            bool adaptVideoFrame(const agora::media::base::VideoFrame &capturedFrame,
+                                 agora::media::base::VideoFrame &adaptedFrame) override;
+
+            void setEnabled(bool enable) override { enabled_ = enable; }
+
+            bool isEnabled() override { return enabled_; }
+
+            size_t setProperty(const char *key, const void *buf, size_t buf_size) override;
+
+            size_t getProperty(const char *key, void *buf, size_t buf_size) override;
+
+        private:
+            std::atomic_bool enabled_ = {true};
+            agora_refptr<RemoteVideoProcessor> videoProcessor_;
+            // state of this filter's stream, only touched on its video thread
+            VideoEnhancer stream_;
+        protected:
+            ExtensionRemoteVideoFilter() = default;
+        };
+    }
+}
+
+
+#endif //AGORAWITHBYTEDANCE_EXTENSIONREMOTEVIDEOFILTER_H
@@ -0,0 +1,53 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "ExtensionRemoteVideoProvider.h"
+#include "../logutils.h"
+#include "LogRing.h"
+#include "RemoteVideoProcessor.h"
+
+namespace agora {
+    namespace extension {
+        ExtensionRemoteVideoProvider* ExtensionRemoteVideoProvider::instance_;
+        ExtensionRemoteVideoProvider::ExtensionRemoteVideoProvider() {
+            PRINTF_INFO("ExtensionRemoteVideoProvider create");
+            resources_ = std::make_shared<SharedVideoResources>();
+            videoProcessor_ = new agora::RefCountedObject<RemoteVideoProcessor>(resources_);
+        }
+
+        ExtensionRemoteVideoProvider::~ExtensionRemoteVideoProvider() {
+            PRINTF_INFO("ExtensionRemoteVideoProvider destroy");
+            instance_ = nullptr;
+        }
+
+        int ExtensionRemoteVideoProvider::setExtensionVendor(std::string vendor) {
+            PRINTF_INFO("ExtensionRemoteVideoProvider vendor %s", vendor.c_str());
+            resources_->setVendor(vendor);
+            return 0;
+        }
+
+        agora_refptr<agora::rtc::IVideoFilter> ExtensionRemoteVideoProvider::createVideoFilter() {
+            PRINTF_INFO("ExtensionRemoteVideoProvider::createVideoFilter");
+            auto videoFilter = new agora::RefCountedObject<agora::extension::ExtensionRemoteVideoFilter>(videoProcessor_);
+            return videoFilter;
+        }
+
+        agora_refptr<agora::rtc::IAudioFilter> ExtensionRemoteVideoProvider::createAudioFilter() {
+            return nullptr;
+        }
+
+        agora_refptr<agora::rtc::IVideoSinkBase> ExtensionRemoteVideoProvider::createVideoSink() {
+            return nullptr;
+        }
+
+        ExtensionRemoteVideoProvider::PROVIDER_TYPE ExtensionRemoteVideoProvider::getProviderType() {
+            return agora::rtc::IExtensionProvider::REMOTE_VIDEO_FILTER;
+        }
+
+        void ExtensionRemoteVideoProvider::setExtensionControl(rtc::IExtensionControl* control){
+            LogRing::getInstance().setExtensionControl(control);
+            resources_->setExtensionControl(control);
+        }
+    }
+}
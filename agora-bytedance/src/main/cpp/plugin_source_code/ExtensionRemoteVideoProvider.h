@@ -0,0 +1,48 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_EXTENSION_REMOTEVIDEOPROVIDER_H
+#define AGORAWITHBYTEDANCE_EXTENSION_REMOTEVIDEOPROVIDER_H
+
+#include "AgoraRtcKit/NGIAgoraExtensionProvider.h"
+#include "ExtensionRemoteVideoFilter.h"
+#include "SharedVideoResources.h"
+
+namespace agora {
+    namespace extension {
+        class ExtensionRemoteVideoProvider : public agora::rtc::IExtensionProvider {
+        private:
+            static ExtensionRemoteVideoProvider* instance_;
+            std::shared_ptr<SharedVideoResources> resources_;
+            agora_refptr<RemoteVideoProcessor> videoProcessor_;
+        public:
+            static void create() {
+                if (instance_ == nullptr){
+                    instance_ = new agora::RefCountedObject<ExtensionRemoteVideoProvider>();
+                }
+            }
+
+            static ExtensionRemoteVideoProvider* getInstance(){
+                return instance_;
+            };
+
+            ExtensionRemoteVideoProvider();
+
+            ~ExtensionRemoteVideoProvider();
+
+            PROVIDER_TYPE getProviderType() override;
+
+            virtual void setExtensionControl(rtc::IExtensionControl* control) override;
+
+            virtual agora_refptr<rtc::IAudioFilter> createAudioFilter() override;
+
+            virtual agora_refptr<rtc::IVideoFilter> createVideoFilter() override;
+
+            virtual agora_refptr<rtc::IVideoSinkBase> createVideoSink() override;
+
+            int setExtensionVendor(std::string vendor);
+        };
+    }
+}
+#endif //AGORAWITHBYTEDANCE_EXTENSION_REMOTEVIDEOPROVIDER_H
@@ -5,6 +5,7 @@
 #include "ExtensionVideoFilter.h"
 #include "../logutils.h"
 #include <sstream>
+#include <cstring>
 
 namespace agora {
     namespace extension {
@@ -20,17 +21,25 @@ namespace agora {
         bool ExtensionVideoFilter::adaptVideoFrame(const agora::media::base::VideoFrame &capturedFrame,
                              agora::media::base::VideoFrame &adaptedFrame) {
 //            PRINTF_INFO("adaptVideoFrame %d %d", capturedFrame.width, capturedFrame.height);
-            if (!isInitOpenGL) {
-                isInitOpenGL = byteDanceProcessor_->initOpenGL();
-            }
             byteDanceProcessor_->processFrame(capturedFrame);
+            if (!byteDanceProcessor_->hasOutput()) {
+                // the pipelined readback is still filling up
+                return false;
+            }
             adaptedFrame = capturedFrame;
+            adaptedFrame.renderTimeMs = byteDanceProcessor_->outputTimestampMs();
             return true;
         }
 
         size_t ExtensionVideoFilter::setProperty(const char *key, const void *buf,
                                                  size_t buf_size) {
-            PRINTF_INFO("setProperty  %s  %s", key, buf);
+            if (strcmp(key, "plugin.bytedance.headSegModel") == 0) {
+                // binary model, not a JSON document
+                PRINTF_INFO("setProperty  %s  %zu bytes", key, buf_size);
+                byteDanceProcessor_->setHeadSegModel(buf, buf_size);
+                return 0;
+            }
+            PRINTF_INFO("setProperty  %s  %s", key, (const char*)buf);
             std::string stringParameter((char*)buf);
             byteDanceProcessor_->setParameters(stringParameter);
             return 0;
@@ -40,6 +49,10 @@ namespace agora {
             return 0;
         }
 
+        void ExtensionVideoFilter::onDataStreamWillStop() {
+            byteDanceProcessor_->releaseOpenGL();
+        }
+
         void ExtensionVideoFilter::setEnabled(bool enable) {
         }
 
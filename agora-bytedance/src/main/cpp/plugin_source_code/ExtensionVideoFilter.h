@@ -29,9 +29,10 @@ namespace agora {
 
             size_t getProperty(const char *key, void *buf, size_t buf_size) override;
 
+            void onDataStreamWillStop() override;
+
         private:
             agora_refptr<ByteDanceProcessor> byteDanceProcessor_;
-            bool isInitOpenGL = false;
         protected:
             ExtensionVideoFilter() = default;
 
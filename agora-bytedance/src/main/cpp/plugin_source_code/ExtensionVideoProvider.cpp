@@ -4,6 +4,7 @@
 
 #include "ExtensionVideoProvider.h"
 #include "../logutils.h"
+#include "LogRing.h"
 #include "VideoProcessor.h"
 
 namespace agora {
@@ -11,7 +12,7 @@ namespace agora {
         ExtensionVideoProvider* ExtensionVideoProvider::instance_;
         ExtensionVideoProvider::ExtensionVideoProvider() {
             PRINTF_INFO("ExtensionVideoProvider create");
-            byteDanceProcessor_ = new agora::RefCountedObject<ByteDanceProcessor>();
+            resources_ = std::make_shared<SharedVideoResources>();
         }
 
         ExtensionVideoProvider::~ExtensionVideoProvider() {
@@ -21,13 +22,14 @@ namespace agora {
 
         int ExtensionVideoProvider::setExtensionVendor(std::string vendor) {
             PRINTF_INFO("ExtensionVideoProvider vendor %s", vendor.c_str());
-            byteDanceProcessor_->setExtensionVendor(vendor.c_str());
+            resources_->setVendor(vendor);
             return 0;
         }
 
         agora_refptr<agora::rtc::IVideoFilter> ExtensionVideoProvider::createVideoFilter() {
             PRINTF_INFO("ExtensionVideoProvider::createVideoFilter");
-            auto videoFilter = new agora::RefCountedObject<agora::extension::ExtensionVideoFilter>(byteDanceProcessor_);
+            agora_refptr<ByteDanceProcessor> byteDanceProcessor = new agora::RefCountedObject<ByteDanceProcessor>(resources_);
+            auto videoFilter = new agora::RefCountedObject<agora::extension::ExtensionVideoFilter>(byteDanceProcessor);
             return videoFilter;
         }
 
@@ -44,7 +46,8 @@ namespace agora {
         }
 
         void ExtensionVideoProvider::setExtensionControl(rtc::IExtensionControl* control){
-            byteDanceProcessor_->setExtensionControl(control);
+            LogRing::getInstance().setExtensionControl(control);
+            resources_->setExtensionControl(control);
         }
     }
 }
@@ -7,16 +7,16 @@
 
 #include "AgoraRtcKit/NGIAgoraExtensionProvider.h"
 #include "ExtensionVideoFilter.h"
+#include "SharedVideoResources.h"
 
 namespace agora {
     namespace extension {
 
-        class ByteDanceProcessor;
-
         class ExtensionVideoProvider : public agora::rtc::IExtensionProvider {
         private:
             static ExtensionVideoProvider* instance_;
-            agora_refptr<ByteDanceProcessor> byteDanceProcessor_;
+            // every filter gets its own processor, these are what they share
+            std::shared_ptr<SharedVideoResources> resources_;
         public:
             static void create() {
                 if (instance_ == nullptr){
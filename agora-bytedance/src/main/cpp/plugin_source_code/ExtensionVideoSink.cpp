@@ -0,0 +1,143 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "ExtensionVideoSink.h"
+#include "../logutils.h"
+#include "JniHelper.h"
+#include <cstring>
+
+namespace agora {
+    namespace extension {
+        namespace {
+            void copyPlane(uint8_t* dst, const uint8_t* src, int srcStride, int width, int height) {
+                for (int y = 0; y < height; y++) {
+                    memcpy(dst + y * width, src + y * srcStride, width);
+                }
+            }
+        }
+
+        ExtensionVideoSink::ExtensionVideoSink(agora_refptr<ByteDanceProcessor> byteDanceProcessor) {
+            byteDanceProcessor_ = byteDanceProcessor;
+        }
+
+        ExtensionVideoSink::~ExtensionVideoSink() {
+            stop();
+        }
+
+        bool ExtensionVideoSink::onDataStreamWillStart() {
+            start();
+            return true;
+        }
+
+        void ExtensionVideoSink::onDataStreamWillStop() {
+            stop();
+        }
+
+        int ExtensionVideoSink::onFrame(const agora::media::base::VideoFrame& videoFrame) {
+            if (videoFrame.type != agora::media::base::VIDEO_PIXEL_I420 || !videoFrame.yBuffer ||
+                !videoFrame.uBuffer || !videoFrame.vBuffer) {
+                return 0;
+            }
+            start();
+
+            int slot = 0;
+            {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                // at most two slots are taken, by the waiting frame and the one being read
+                while (slot == pending_ || slot == reading_) {
+                    slot++;
+                }
+            }
+            // the free slot belongs to this thread alone, copy without the lock
+            copyFrame(videoFrame, slots_[slot]);
+            {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                pending_ = slot;
+            }
+            pendingChanged_.notify_one();
+            return 0;
+        }
+
+        void ExtensionVideoSink::copyFrame(const agora::media::base::VideoFrame& src, FrameSlot& slot) {
+            int width = src.width;
+            int height = src.height;
+            int chromaWidth = (width + 1) / 2;
+            int chromaHeight = (height + 1) / 2;
+            size_t ySize = (size_t)width * height;
+            size_t chromaSize = (size_t)chromaWidth * chromaHeight;
+            // grows to the largest frame seen and stays, no allocation per frame
+            if (slot.data.size() < ySize + 2 * chromaSize) {
+                slot.data.resize(ySize + 2 * chromaSize);
+            }
+
+            agora::media::base::VideoFrame& frame = slot.frame;
+            frame = src;
+            frame.yBuffer = slot.data.data();
+            frame.uBuffer = frame.yBuffer + ySize;
+            frame.vBuffer = frame.uBuffer + chromaSize;
+            frame.yStride = width;
+            frame.uStride = chromaWidth;
+            frame.vStride = chromaWidth;
+            copyPlane(frame.yBuffer, src.yBuffer, src.yStride, width, height);
+            copyPlane(frame.uBuffer, src.uBuffer, src.uStride, chromaWidth, chromaHeight);
+            copyPlane(frame.vBuffer, src.vBuffer, src.vStride, chromaWidth, chromaHeight);
+        }
+
+        void ExtensionVideoSink::start() {
+            if (thread_.joinable()) {
+                return;
+            }
+            stopping_ = false;
+            thread_ = std::thread(&ExtensionVideoSink::analysisLoop, this);
+        }
+
+        void ExtensionVideoSink::stop() {
+            if (!thread_.joinable()) {
+                return;
+            }
+            {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+                pending_ = -1;
+            }
+            pendingChanged_.notify_one();
+            thread_.join();
+        }
+
+        void ExtensionVideoSink::analysisLoop() {
+            PRINTF_INFO("ExtensionVideoSink analysis thread start");
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    reading_ = -1;
+                    pendingChanged_.wait(lock, [this] { return stopping_ || pending_ >= 0; });
+                    if (stopping_) {
+                        break;
+                    }
+                    reading_ = pending_;
+                    pending_ = -1;
+                }
+                byteDanceProcessor_->processFrame(slots_[reading_].frame);
+            }
+
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+            // license checks attach the thread to the JVM, it must not exit attached
+            if (JniHelper::getJniHelper()) {
+                JniHelper::getJniHelper()->detachWorkerThread();
+            }
+#endif
+            PRINTF_INFO("ExtensionVideoSink analysis thread stop");
+        }
+
+        int ExtensionVideoSink::setProperty(const char* key, const void* buf, int buf_size) {
+            if (strcmp(key, "plugin.bytedance.headSegModel") == 0) {
+                PRINTF_INFO("setProperty  %s  %d bytes", key, buf_size);
+                return byteDanceProcessor_->setHeadSegModel(buf, buf_size);
+            }
+            PRINTF_INFO("setProperty  %s  %s", key, (const char*)buf);
+            std::string stringParameter((const char*)buf);
+            return byteDanceProcessor_->setParameters(stringParameter);
+        }
+    }
+}
@@ -0,0 +1,74 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_EXTENSIONVIDEOSINK_H
+#define AGORAWITHBYTEDANCE_EXTENSIONVIDEOSINK_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "AgoraRtcKit/NGIAgoraMediaNode.h"
+#include <AgoraRtcKit/AgoraRefCountedObject.h>
+#include "AgoraRtcKit/AgoraRefPtr.h"
+#include "VideoProcessor.h"
+
+namespace agora {
+    namespace extension {
+        /**
+         * Runs the analyzers on frames handed to a video sink, off the media path.
+         *
+         * onFrame() only copies the frame into one of three pooled buffers and
+         * returns; an analysis thread of its own picks up the newest copy. A
+         * frame that arrives while the previous one is still waiting replaces it,
+         * so a slow analyzer drops frames instead of queueing them. Events go out
+         * through the provider's extension control like the filter's.
+         */
+        class ExtensionVideoSink : public agora::rtc::IVideoSinkBase {
+        public:
+            ExtensionVideoSink(agora_refptr<ByteDanceProcessor> byteDanceProcessor);
+
+            ~ExtensionVideoSink();
+
+            int onFrame(const agora::media::base::VideoFrame& videoFrame) override;
+
+            bool onDataStreamWillStart() override;
+
+            void onDataStreamWillStop() override;
+
+            int setProperty(const char* key, const void* buf, int buf_size) override;
+
+        private:
+            static const int kSlotCount = 3;
+
+            struct FrameSlot {
+                std::vector<uint8_t> data;
+                agora::media::base::VideoFrame frame;
+            };
+
+            void copyFrame(const agora::media::base::VideoFrame& src, FrameSlot& slot);
+
+            void start();
+
+            void stop();
+
+            void analysisLoop();
+
+            agora_refptr<ByteDanceProcessor> byteDanceProcessor_;
+            FrameSlot slots_[kSlotCount];
+            std::mutex mutex_;
+            std::condition_variable pendingChanged_;
+            // slot waiting for the analysis thread, slot it is reading, -1 if none
+            int pending_ = -1;
+            int reading_ = -1;
+            bool stopping_ = false;
+            std::thread thread_;
+        protected:
+            ExtensionVideoSink() = default;
+        };
+    }
+}
+
+
+#endif //AGORAWITHBYTEDANCE_EXTENSIONVIDEOSINK_H
@@ -0,0 +1,60 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "ExtensionVideoSinkProvider.h"
+#include "../logutils.h"
+#include "LogRing.h"
+#include "VideoProcessor.h"
+
+namespace agora {
+    namespace extension {
+        ExtensionVideoSinkProvider* ExtensionVideoSinkProvider::localInstance_;
+        ExtensionVideoSinkProvider* ExtensionVideoSinkProvider::remoteInstance_;
+        ExtensionVideoSinkProvider::ExtensionVideoSinkProvider(PROVIDER_TYPE type) : type_(type) {
+            PRINTF_INFO("ExtensionVideoSinkProvider create %d", type);
+            resources_ = std::make_shared<SharedVideoResources>();
+        }
+
+        ExtensionVideoSinkProvider::~ExtensionVideoSinkProvider() {
+            PRINTF_INFO("ExtensionVideoSinkProvider destroy %d", type_);
+            if (localInstance_ == this) {
+                localInstance_ = nullptr;
+            }
+            if (remoteInstance_ == this) {
+                remoteInstance_ = nullptr;
+            }
+        }
+
+        int ExtensionVideoSinkProvider::setExtensionVendor(std::string vendor) {
+            PRINTF_INFO("ExtensionVideoSinkProvider vendor %s", vendor.c_str());
+            resources_->setVendor(vendor);
+            return 0;
+        }
+
+        agora_refptr<agora::rtc::IVideoSinkBase> ExtensionVideoSinkProvider::createVideoSink() {
+            PRINTF_INFO("ExtensionVideoSinkProvider::createVideoSink");
+            agora_refptr<ByteDanceProcessor> byteDanceProcessor = new agora::RefCountedObject<ByteDanceProcessor>(resources_);
+            byteDanceProcessor->setAnalysisOnly(true);
+            auto videoSink = new agora::RefCountedObject<agora::extension::ExtensionVideoSink>(byteDanceProcessor);
+            return videoSink;
+        }
+
+        agora_refptr<agora::rtc::IVideoFilter> ExtensionVideoSinkProvider::createVideoFilter() {
+            return nullptr;
+        }
+
+        agora_refptr<agora::rtc::IAudioFilter> ExtensionVideoSinkProvider::createAudioFilter() {
+            return nullptr;
+        }
+
+        ExtensionVideoSinkProvider::PROVIDER_TYPE ExtensionVideoSinkProvider::getProviderType() {
+            return type_;
+        }
+
+        void ExtensionVideoSinkProvider::setExtensionControl(rtc::IExtensionControl* control){
+            LogRing::getInstance().setExtensionControl(control);
+            resources_->setExtensionControl(control);
+        }
+    }
+}
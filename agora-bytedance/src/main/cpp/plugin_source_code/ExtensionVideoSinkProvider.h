@@ -0,0 +1,54 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_EXTENSION_VIDEOSINKPROVIDER_H
+#define AGORAWITHBYTEDANCE_EXTENSION_VIDEOSINKPROVIDER_H
+
+#include "AgoraRtcKit/NGIAgoraExtensionProvider.h"
+#include "ExtensionVideoSink.h"
+#include "SharedVideoResources.h"
+
+namespace agora {
+    namespace extension {
+        /**
+         * LOCAL_VIDEO_SINK and REMOTE_VIDEO_SINK provider, one instance per type.
+         * Every sink gets its own analysis-only ByteDanceProcessor.
+         */
+        class ExtensionVideoSinkProvider : public agora::rtc::IExtensionProvider {
+        private:
+            static ExtensionVideoSinkProvider* localInstance_;
+            static ExtensionVideoSinkProvider* remoteInstance_;
+            PROVIDER_TYPE type_;
+            std::shared_ptr<SharedVideoResources> resources_;
+        public:
+            static void create(PROVIDER_TYPE type) {
+                ExtensionVideoSinkProvider*& instance = type == LOCAL_VIDEO_SINK ? localInstance_ : remoteInstance_;
+                if (instance == nullptr){
+                    instance = new agora::RefCountedObject<ExtensionVideoSinkProvider>(type);
+                }
+            }
+
+            static ExtensionVideoSinkProvider* getInstance(PROVIDER_TYPE type){
+                return type == LOCAL_VIDEO_SINK ? localInstance_ : remoteInstance_;
+            };
+
+            explicit ExtensionVideoSinkProvider(PROVIDER_TYPE type);
+
+            ~ExtensionVideoSinkProvider();
+
+            PROVIDER_TYPE getProviderType() override;
+
+            virtual void setExtensionControl(rtc::IExtensionControl* control) override;
+
+            virtual agora_refptr<rtc::IAudioFilter> createAudioFilter() override;
+
+            virtual agora_refptr<rtc::IVideoFilter> createVideoFilter() override;
+
+            virtual agora_refptr<rtc::IVideoSinkBase> createVideoSink() override;
+
+            int setExtensionVendor(std::string vendor);
+        };
+    }
+}
+#endif //AGORAWITHBYTEDANCE_EXTENSION_VIDEOSINKPROVIDER_H
@@ -0,0 +1,105 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "FaceGallery.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace agora {
+    namespace extension {
+        namespace {
+            const int kLanes = 8;
+
+            // independent partial sums keep the loop vectorizable without -ffast-math
+            float dot(const float* a, const float* b, int size) {
+                float lanes[kLanes] = {0};
+                int i = 0;
+                for (; i + kLanes <= size; i += kLanes) {
+                    for (int j = 0; j < kLanes; j++) {
+                        lanes[j] += a[i + j] * b[i + j];
+                    }
+                }
+                float sum = 0;
+                for (; i < size; i++) {
+                    sum += a[i] * b[i];
+                }
+                for (int j = 0; j < kLanes; j++) {
+                    sum += lanes[j];
+                }
+                return sum;
+            }
+
+            void normalize(const float* in, float* out, int size) {
+                float norm = std::sqrt(dot(in, in, size));
+                float scale = norm > 0 ? 1.0f / norm : 0.0f;
+                for (int i = 0; i < size; i++) {
+                    out[i] = in[i] * scale;
+                }
+            }
+        }
+
+        int FaceGallery::find(const std::string& name) const {
+            for (int i = 0; i < (int)names_.size(); i++) {
+                if (names_[i] == name) {
+                    return i;
+                }
+            }
+            return -1;
+        }
+
+        void FaceGallery::enroll(const std::string& name, const float* feature) {
+            int index = find(name);
+            if (index < 0) {
+                index = (int)names_.size();
+                names_.push_back(name);
+                features_.resize(features_.size() + dimension_);
+            }
+            normalize(feature, features_.data() + (size_t)index * dimension_, dimension_);
+        }
+
+        bool FaceGallery::remove(const std::string& name) {
+            int index = find(name);
+            if (index < 0) {
+                return false;
+            }
+            // move the last row into the hole to keep the matrix dense
+            int last = (int)names_.size() - 1;
+            if (index != last) {
+                names_[index] = names_[last];
+                std::copy(features_.begin() + (size_t)last * dimension_,
+                          features_.begin() + (size_t)(last + 1) * dimension_,
+                          features_.begin() + (size_t)index * dimension_);
+            }
+            names_.pop_back();
+            features_.resize((size_t)last * dimension_);
+            return true;
+        }
+
+        void FaceGallery::clear() {
+            names_.clear();
+            features_.clear();
+        }
+
+        int FaceGallery::match(const float* feature, float threshold, float* similarity) const {
+            query_.resize(dimension_);
+            normalize(feature, query_.data(), dimension_);
+
+            int best = -1;
+            float bestScore = threshold;
+            const float* row = features_.data();
+            for (int i = 0; i < (int)names_.size(); i++, row += dimension_) {
+                float score = dot(query_.data(), row, dimension_);
+                if (score >= bestScore) {
+                    best = i;
+                    bestScore = score;
+                }
+            }
+            if (similarity) {
+                *similarity = best >= 0 ? bestScore : 0.0f;
+            }
+            return best;
+        }
+    }
+}
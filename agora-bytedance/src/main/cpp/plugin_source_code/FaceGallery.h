@@ -0,0 +1,52 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_FACEGALLERY_H
+#define AGORAWITHBYTEDANCE_FACEGALLERY_H
+
+#include <string>
+#include <vector>
+
+namespace agora {
+    namespace extension {
+        /**
+         * Enrolled face identities for face verification.
+         *
+         * Feature vectors are L2-normalized on enrollment and stored row by row in
+         * one contiguous float matrix, so matching a query is a single pass of dot
+         * products (cosine similarity) over the matrix that the compiler can
+         * vectorize. Names are kept in a parallel array.
+         */
+        class FaceGallery {
+        public:
+            explicit FaceGallery(int dimension) : dimension_(dimension) {}
+
+            int dimension() const { return dimension_; }
+
+            int size() const { return (int)names_.size(); }
+
+            const std::string& name(int index) const { return names_[index]; }
+
+            // replaces the feature of an existing name
+            void enroll(const std::string& name, const float* feature);
+
+            bool remove(const std::string& name);
+
+            void clear();
+
+            // index of the best match with similarity >= threshold, or -1
+            int match(const float* feature, float threshold, float* similarity) const;
+
+        private:
+            int find(const std::string& name) const;
+
+            int dimension_;
+            std::vector<float> features_;
+            std::vector<std::string> names_;
+            mutable std::vector<float> query_;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_FACEGALLERY_H
@@ -0,0 +1,56 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_FRAMEANALYSISCONTEXT_H
+#define AGORAWITHBYTEDANCE_FRAMEANALYSISCONTEXT_H
+
+#include <cstdint>
+#include "../bytedance/bef_effect_ai_face_detect.h"
+#include "../bytedance/bef_effect_ai_face_attribute.h"
+
+namespace agora {
+    namespace extension {
+        // data the stages of a frame read and write, see AnalysisGraph
+        enum ANALYSIS_RESULT {
+            // planes of the captured frame
+            ANALYSIS_I420 = 1 << 0,
+            // full resolution RGBA copy of the captured frame
+            ANALYSIS_RGBA = 1 << 1,
+            ANALYSIS_FACE = 1 << 2,
+            ANALYSIS_FACE_ATTRIBUTE = 1 << 3,
+            // enrolled identities of the visible faces
+            ANALYSIS_FACE_IDENTITY = 1 << 4,
+            ANALYSIS_PORTRAIT_MASK = 1 << 5,
+        };
+
+        /**
+         * Detector outputs of the frame being processed.
+         *
+         * An analyzer that consumes another one's output declares it as an input
+         * of its stage; the analysis graph runs the producer the first time the
+         * result is required in a frame and hands the cached copy to everyone
+         * after. Results are plain members so the steady state does not allocate.
+         */
+        class FrameAnalysisContext {
+        public:
+            void reset(uint64_t frameIndex, int64_t timestampMs) {
+                frameIndex_ = frameIndex;
+                timestampMs_ = timestampMs;
+            }
+
+            uint64_t frameIndex() const { return frameIndex_; }
+
+            int64_t timestampMs() const { return timestampMs_; }
+
+            bef_ai_face_info faceInfo;
+            bef_ai_face_attribute_result faceAttributes;
+
+        private:
+            uint64_t frameIndex_ = 0;
+            int64_t timestampMs_ = 0;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_FRAMEANALYSISCONTEXT_H
@@ -0,0 +1,60 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "FrameClock.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace agora {
+    namespace extension {
+        int64_t FrameClock::steadyNowMs() {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        FrameTime FrameClock::tick(int64_t renderTimeMs) {
+            FrameTime time;
+            time.fallback = renderTimeMs <= 0;
+            int64_t sourceMs = time.fallback ? steadyNowMs() : renderTimeMs;
+
+            bool first = !started_;
+            if (first) {
+                started_ = true;
+                offsetMs_ = 0;
+                time.discontinuity = true;
+            } else if (time.fallback != last_.fallback) {
+                time.discontinuity = true;
+                offsetMs_ = last_.timestampMs + intervalMs_ - sourceMs;
+            } else {
+                int64_t stepMs = sourceMs - lastSourceMs_;
+                if (stepMs == 0 && !time.fallback) {
+                    time.duplicate = true;
+                } else if (stepMs < 0) {
+                    // a looped or seeked source
+                    time.discontinuity = true;
+                    offsetMs_ = last_.timestampMs + intervalMs_ - sourceMs;
+                } else if (stepMs > kMaxIntervalMs) {
+                    time.discontinuity = true;
+                } else if (stepMs > 0) {
+                    intervalMs_ = std::max((int64_t)1, (intervalMs_ * 7 + stepMs) / 8);
+                }
+            }
+
+            time.timestampMs = time.duplicate ? last_.timestampMs : sourceMs + offsetMs_;
+            time.intervalMs = first ? 0 : time.timestampMs - last_.timestampMs;
+            lastSourceMs_ = sourceMs;
+            last_ = time;
+            return time;
+        }
+
+        void FrameClock::reset() {
+            started_ = false;
+            lastSourceMs_ = 0;
+            offsetMs_ = 0;
+            intervalMs_ = kDefaultIntervalMs;
+            last_ = FrameTime();
+        }
+    }
+}
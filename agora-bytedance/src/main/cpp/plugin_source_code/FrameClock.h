@@ -0,0 +1,63 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_FRAMECLOCK_H
+#define AGORAWITHBYTEDANCE_FRAMECLOCK_H
+
+#include <cstdint>
+
+namespace agora {
+    namespace extension {
+        struct FrameTime {
+            // media time of the frame, never decreases
+            int64_t timestampMs = 0;
+            // since the previous frame, 0 for the first one and for duplicates
+            int64_t intervalMs = 0;
+            // same renderTimeMs as the previous frame, a repeated or replayed picture
+            bool duplicate = false;
+            // the timeline broke before this frame: first frame, stall, rewind or change of time source
+            bool discontinuity = false;
+            // renderTimeMs was missing, the steady clock stamped the frame
+            bool fallback = false;
+        };
+
+        /**
+         * Media timestamps of one video stream.
+         *
+         * The timeline follows VideoFrame::renderTimeMs, so a stream processed
+         * late or replayed gets the same timestamps, and the steady clock only
+         * stands in for frames that carry none. A rewind, or a switch between
+         * the two sources, restarts the timeline one frame interval after the
+         * last timestamp so it never runs backwards; a step longer than
+         * kMaxIntervalMs is kept as is but reported as a discontinuity.
+         */
+        class FrameClock {
+        public:
+            static const int64_t kDefaultIntervalMs = 33;
+            static const int64_t kMaxIntervalMs = 500;
+
+            // stamps the next frame
+            FrameTime tick(int64_t renderTimeMs);
+
+            const FrameTime& last() const { return last_; }
+
+            // running average of the regular frame interval
+            int64_t intervalMs() const { return intervalMs_; }
+
+            void reset();
+
+        private:
+            static int64_t steadyNowMs();
+
+            bool started_ = false;
+            int64_t lastSourceMs_ = 0;
+            // added to the source time to get the media time
+            int64_t offsetMs_ = 0;
+            int64_t intervalMs_ = kDefaultIntervalMs;
+            FrameTime last_;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_FRAMECLOCK_H
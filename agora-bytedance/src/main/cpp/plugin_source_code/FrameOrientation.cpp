@@ -0,0 +1,81 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "FrameOrientation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace agora {
+    namespace extension {
+        bef_ai_rotate_type toRotateType(int rotation) {
+            int degrees = (rotation % 360 + 360) % 360;
+            return static_cast<bef_ai_rotate_type>((degrees + 45) / 90 % 4);
+        }
+
+        void FrameOrientation::set(int width, int height, int rotation, bool mirror) {
+            width_ = width;
+            height_ = height;
+            rotateType_ = toRotateType(rotation);
+            mirror_ = mirror;
+        }
+
+        int FrameOrientation::displayWidth() const {
+            bool sideways = rotateType_ == BEF_AI_CLOCKWISE_ROTATE_90 || rotateType_ == BEF_AI_CLOCKWISE_ROTATE_270;
+            return sideways ? height_ : width_;
+        }
+
+        int FrameOrientation::displayHeight() const {
+            bool sideways = rotateType_ == BEF_AI_CLOCKWISE_ROTATE_90 || rotateType_ == BEF_AI_CLOCKWISE_ROTATE_270;
+            return sideways ? width_ : height_;
+        }
+
+        void FrameOrientation::toDisplay(float& x, float& y) const {
+            float bufferX = x;
+            float bufferY = y;
+            switch (rotateType_) {
+                case BEF_AI_CLOCKWISE_ROTATE_90:
+                    x = height_ - bufferY;
+                    y = bufferX;
+                    break;
+                case BEF_AI_CLOCKWISE_ROTATE_180:
+                    x = width_ - bufferX;
+                    y = height_ - bufferY;
+                    break;
+                case BEF_AI_CLOCKWISE_ROTATE_270:
+                    x = bufferY;
+                    y = width_ - bufferX;
+                    break;
+                default:
+                    break;
+            }
+            if (mirror_) {
+                x = displayWidth() - x;
+            }
+        }
+
+        void FrameOrientation::toDisplay(float& left, float& top, float& right, float& bottom) const {
+            if (isIdentity()) {
+                return;
+            }
+            toDisplay(left, top);
+            toDisplay(right, bottom);
+            if (left > right) {
+                std::swap(left, right);
+            }
+            if (top > bottom) {
+                std::swap(top, bottom);
+            }
+        }
+
+        bef_ai_rect FrameOrientation::toDisplay(const bef_ai_rect& rect) const {
+            float left = rect.left;
+            float top = rect.top;
+            float right = rect.right;
+            float bottom = rect.bottom;
+            toDisplay(left, top, right, bottom);
+            return {(int)std::lround(left), (int)std::lround(top), (int)std::lround(right), (int)std::lround(bottom)};
+        }
+    }
+}
@@ -0,0 +1,53 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_FRAMEORIENTATION_H
+#define AGORAWITHBYTEDANCE_FRAMEORIENTATION_H
+
+#include "../bytedance/bef_effect_ai_public_define.h"
+
+namespace agora {
+    namespace extension {
+        // VideoFrame::rotation (clockwise degrees) as the detectors take it, rounded to quarter turns
+        bef_ai_rotate_type toRotateType(int rotation);
+
+        /**
+         * How the pixels of a frame relate to the picture on screen.
+         *
+         * The pixels are never rotated: detectors and the effect engine get the
+         * buffer as captured together with its rotation, and their results,
+         * which are in buffer coordinates, are turned into display coordinates
+         * only when they are reported. Display space is the buffer rotated
+         * clockwise by the frame's rotation, then flipped horizontally when the
+         * app shows it mirrored (front camera preview).
+         */
+        class FrameOrientation {
+        public:
+            void set(int width, int height, int rotation, bool mirror);
+
+            bef_ai_rotate_type rotateType() const { return rotateType_; }
+
+            bool isIdentity() const { return rotateType_ == BEF_AI_CLOCKWISE_ROTATE_0 && !mirror_; }
+
+            int displayWidth() const;
+
+            int displayHeight() const;
+
+            void toDisplay(float& x, float& y) const;
+
+            // a box given by two corners, mapped in place and kept left < right, top < bottom
+            void toDisplay(float& left, float& top, float& right, float& bottom) const;
+
+            bef_ai_rect toDisplay(const bef_ai_rect& rect) const;
+
+        private:
+            int width_ = 0;
+            int height_ = 0;
+            bef_ai_rotate_type rotateType_ = BEF_AI_CLOCKWISE_ROTATE_0;
+            bool mirror_ = false;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_FRAMEORIENTATION_H
@@ -0,0 +1,277 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "GlContextManager.h"
+
+#include <algorithm>
+
+#include "../logutils.h"
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+#include <GLES3/gl3.h>
+#include "EGLCore.h"
+#endif
+
+namespace agora {
+    namespace extension {
+        struct GlContextManager::Context {
+            struct PooledObject {
+                GlObjectKey key;
+                unsigned int name;
+                bool inUse;
+                uint64_t lastUsedFrame;
+            };
+
+            std::thread::id owner;
+            void* context = nullptr;
+            void* surface = nullptr;
+            int surfaceWidth = 0;
+            int surfaceHeight = 0;
+            int users = 0;
+            uint64_t frame = 0;
+            std::vector<PooledObject> objects;
+        };
+
+        namespace {
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+            class EglBackend : public GlBackend {
+            public:
+                void* createContext() override {
+                    return new EglCore(NULL, FLAG_TRY_GLES3);
+                }
+
+                void destroyContext(void* context) override {
+                    delete static_cast<EglCore*>(context);
+                }
+
+                void* createSurface(void* context, int width, int height) override {
+                    return static_cast<EglCore*>(context)->createOffscreenSurface(width, height);
+                }
+
+                void destroySurface(void* context, void* surface) override {
+                    static_cast<EglCore*>(context)->releaseSurface(surface);
+                }
+
+                bool isCurrent(void* context, void* surface) override {
+                    return static_cast<EglCore*>(context)->isCurrent(surface);
+                }
+
+                void makeCurrent(void* context, void* surface) override {
+                    static_cast<EglCore*>(context)->makeCurrent(surface);
+                }
+
+                void makeNothingCurrent(void* context) override {
+                    static_cast<EglCore*>(context)->makeNothingCurrent();
+                }
+
+                unsigned int createObject(const GlObjectKey& key) override {
+                    GLuint name = 0;
+                    switch (key.kind) {
+                        case GL_OBJECT_TEXTURE:
+                            glGenTextures(1, &name);
+                            glBindTexture(GL_TEXTURE_2D, name);
+                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                            glTexStorage2D(GL_TEXTURE_2D, 1, key.format, key.width, key.height);
+                            glBindTexture(GL_TEXTURE_2D, 0);
+                            break;
+                        case GL_OBJECT_FRAMEBUFFER:
+                            glGenFramebuffers(1, &name);
+                            break;
+                        case GL_OBJECT_PIXEL_BUFFER:
+                            glGenBuffers(1, &name);
+                            glBindBuffer(GL_PIXEL_PACK_BUFFER, name);
+                            glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)key.width * key.height * 4,
+                                         nullptr, GL_STREAM_READ);
+                            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                            break;
+                    }
+                    return name;
+                }
+
+                void deleteObject(GL_OBJECT_KIND kind, unsigned int name) override {
+                    GLuint glName = name;
+                    switch (kind) {
+                        case GL_OBJECT_TEXTURE:
+                            glDeleteTextures(1, &glName);
+                            break;
+                        case GL_OBJECT_FRAMEBUFFER:
+                            glDeleteFramebuffers(1, &glName);
+                            break;
+                        case GL_OBJECT_PIXEL_BUFFER:
+                            glDeleteBuffers(1, &glName);
+                            break;
+                    }
+                }
+            };
+#endif
+        }
+
+        GlContextManager& GlContextManager::getInstance() {
+            static GlContextManager instance;
+            return instance;
+        }
+
+        GlContextManager::GlContextManager() {
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+            backend_.reset(new EglBackend());
+#endif
+        }
+
+        void GlContextManager::setBackend(std::unique_ptr<GlBackend> backend) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (!contexts_.empty()) {
+                PRINTF_ERROR("GlContextManager backend replaced while %d contexts are alive", (int)contexts_.size());
+                return;
+            }
+            backend_ = std::move(backend);
+        }
+
+        GlContextManager::Context* GlContextManager::bind(Context* current, int width, int height) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (!backend_) {
+                return nullptr;
+            }
+
+            std::thread::id self = std::this_thread::get_id();
+            Context* context = nullptr;
+            for (const std::unique_ptr<Context>& candidate : contexts_) {
+                if (candidate->owner == self) {
+                    context = candidate.get();
+                    break;
+                }
+            }
+            if (!context) {
+                PRINTF_INFO("GlContextManager create context %dx%d", width, height);
+                std::unique_ptr<Context> created(new Context());
+                created->owner = self;
+                created->context = backend_->createContext();
+                context = created.get();
+                contexts_.push_back(std::move(created));
+            }
+            if (context != current) {
+                context->users++;
+                if (current) {
+                    releaseLocked(current);
+                }
+            }
+
+            if (width > context->surfaceWidth || height > context->surfaceHeight) {
+                // grow only, a smaller frame keeps the surface it has
+                int surfaceWidth = std::max(width, context->surfaceWidth);
+                int surfaceHeight = std::max(height, context->surfaceHeight);
+                if (context->surface) {
+                    backend_->makeNothingCurrent(context->context);
+                    backend_->destroySurface(context->context, context->surface);
+                }
+                context->surface = backend_->createSurface(context->context, surfaceWidth, surfaceHeight);
+                context->surfaceWidth = surfaceWidth;
+                context->surfaceHeight = surfaceHeight;
+            }
+            if (!backend_->isCurrent(context->context, context->surface)) {
+                backend_->makeCurrent(context->context, context->surface);
+            }
+
+            context->frame++;
+            trimIdle(context);
+            return context;
+        }
+
+        bool GlContextManager::isOwner(const Context* context) const {
+            return context && context->owner == std::this_thread::get_id();
+        }
+
+        unsigned int GlContextManager::acquire(Context* context, const GlObjectKey& key) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            for (Context::PooledObject& object : context->objects) {
+                if (!object.inUse && object.key == key) {
+                    object.inUse = true;
+                    object.lastUsedFrame = context->frame;
+                    return object.name;
+                }
+            }
+            unsigned int name = backend_->createObject(key);
+            context->objects.push_back({key, name, true, context->frame});
+            return name;
+        }
+
+        void GlContextManager::recycle(Context* context, GL_OBJECT_KIND kind, unsigned int name) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            for (Context::PooledObject& object : context->objects) {
+                if (object.name == name && object.key.kind == kind) {
+                    object.inUse = false;
+                    object.lastUsedFrame = context->frame;
+                    return;
+                }
+            }
+        }
+
+        void GlContextManager::trimIdle(Context* context) {
+            std::vector<Context::PooledObject>& objects = context->objects;
+            for (size_t i = 0; i < objects.size();) {
+                if (!objects[i].inUse && context->frame - objects[i].lastUsedFrame > kIdleFrames) {
+                    backend_->deleteObject(objects[i].key.kind, objects[i].name);
+                    objects[i] = objects.back();
+                    objects.pop_back();
+                } else {
+                    i++;
+                }
+            }
+        }
+
+        void GlContextManager::release(Context* context) {
+            if (!context) {
+                return;
+            }
+            const std::lock_guard<std::mutex> lock(mutex_);
+            releaseLocked(context);
+        }
+
+        void GlContextManager::releaseLocked(Context* context) {
+            if (--context->users > 0) {
+                return;
+            }
+            destroy(context);
+            contexts_.erase(std::remove_if(contexts_.begin(), contexts_.end(),
+                                           [context](const std::unique_ptr<Context>& candidate) {
+                                               return candidate.get() == context;
+                                           }), contexts_.end());
+        }
+
+        void GlContextManager::destroy(Context* context) {
+            PRINTF_INFO("GlContextManager destroy context, %d pooled objects", (int)context->objects.size());
+            if (context->owner == std::this_thread::get_id()) {
+                if (context->surface && !backend_->isCurrent(context->context, context->surface)) {
+                    backend_->makeCurrent(context->context, context->surface);
+                }
+                for (const Context::PooledObject& object : context->objects) {
+                    backend_->deleteObject(object.key.kind, object.name);
+                }
+                backend_->makeNothingCurrent(context->context);
+            }
+            // elsewhere the objects go with the context once the owner thread lets go of it
+            context->objects.clear();
+            if (context->surface) {
+                backend_->destroySurface(context->context, context->surface);
+                context->surface = nullptr;
+            }
+            backend_->destroyContext(context->context);
+            context->context = nullptr;
+        }
+
+        void GlContextManager::releaseAll() {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            for (const std::unique_ptr<Context>& context : contexts_) {
+                destroy(context.get());
+            }
+            contexts_.clear();
+        }
+
+        int GlContextManager::contextCount() const {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            return (int)contexts_.size();
+        }
+    }
+}
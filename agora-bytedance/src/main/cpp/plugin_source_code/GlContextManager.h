@@ -0,0 +1,127 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_GLCONTEXTMANAGER_H
+#define AGORAWITHBYTEDANCE_GLCONTEXTMANAGER_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace agora {
+    namespace extension {
+        enum GL_OBJECT_KIND {
+            GL_OBJECT_TEXTURE = 0,
+            GL_OBJECT_FRAMEBUFFER = 1,
+            GL_OBJECT_PIXEL_BUFFER = 2,
+        };
+
+        // what makes two pooled objects interchangeable
+        struct GlObjectKey {
+            GL_OBJECT_KIND kind;
+            int width;
+            int height;
+            // GL internal format of textures, 0 for the other kinds
+            unsigned int format;
+
+            bool operator==(const GlObjectKey& other) const {
+                return kind == other.kind && width == other.width && height == other.height &&
+                       format == other.format;
+            }
+        };
+
+        /**
+         * The EGL/GL calls the manager makes. Contexts and surfaces are opaque
+         * handles, so the manager runs against a mock backend on a desktop build.
+         * Object calls are made with the owning context current.
+         */
+        class GlBackend {
+        public:
+            virtual ~GlBackend() {}
+
+            virtual void* createContext() = 0;
+
+            virtual void destroyContext(void* context) = 0;
+
+            virtual void* createSurface(void* context, int width, int height) = 0;
+
+            virtual void destroySurface(void* context, void* surface) = 0;
+
+            virtual bool isCurrent(void* context, void* surface) = 0;
+
+            virtual void makeCurrent(void* context, void* surface) = 0;
+
+            virtual void makeNothingCurrent(void* context) = 0;
+
+            virtual unsigned int createObject(const GlObjectKey& key) = 0;
+
+            virtual void deleteObject(GL_OBJECT_KIND kind, unsigned int name) = 0;
+        };
+
+        /**
+         * GL contexts of the processing threads and the objects cached in them.
+         *
+         * Every thread that renders gets one context, created on its first
+         * bind() and kept current from then on, so a frame never pays for a
+         * context switch. The offscreen surface grows to the largest frame bound
+         * on the thread. Textures, framebuffers and pixel buffers are handed out
+         * from a per-context pool keyed by kind, size and format; objects nobody
+         * acquired for kIdleFrames frames are deleted.
+         *
+         * A context lives as long as somebody uses it. The last release() on the
+         * owning thread destroys it on the spot; from another thread the EGL
+         * objects are destroyed and the driver frees them once the owner lets go.
+         */
+        class GlContextManager {
+        public:
+            static const int kIdleFrames = 120;
+
+            // opaque per-thread context, valid until its last release()
+            struct Context;
+
+            static GlContextManager& getInstance();
+
+            // replaces the EGL backend, only while no context exists
+            void setBackend(std::unique_ptr<GlBackend> backend);
+
+            /**
+             * Makes the calling thread's context current with a surface of at
+             * least width x height. `current` is what the caller got last time:
+             * a caller that moved to another thread gives up its old context and
+             * becomes a user of the new one. Null without a GL backend.
+             */
+            Context* bind(Context* current, int width, int height);
+
+            bool isOwner(const Context* context) const;
+
+            unsigned int acquire(Context* context, const GlObjectKey& key);
+
+            void recycle(Context* context, GL_OBJECT_KIND kind, unsigned int name);
+
+            void release(Context* context);
+
+            // drops every context, at library unload
+            void releaseAll();
+
+            int contextCount() const;
+
+        private:
+            GlContextManager();
+
+            void releaseLocked(Context* context);
+
+            void destroy(Context* context);
+
+            void trimIdle(Context* context);
+
+            std::unique_ptr<GlBackend> backend_;
+            mutable std::mutex mutex_;
+            std::vector<std::unique_ptr<Context>> contexts_;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_GLCONTEXTMANAGER_H
@@ -8,14 +8,29 @@
 
 namespace agora {
     namespace extension {
+        namespace {
+            // the key destructor runs on the exiting thread, it only needs the VM
+            JavaVM *attachedVm = nullptr;
+
+            void detachOnExit(void *env) {
+                if (env && attachedVm) {
+                    attachedVm->DetachCurrentThread();
+                }
+            }
+        }
+
         JniHelper *JniHelper::jniHelper = nullptr;
 
         JniHelper::JniHelper(JavaVM *jvm) : javaVm(jvm) {
-
+            attachedVm = jvm;
+            pthread_key_create(&envKey, detachOnExit);
         }
 
         JniHelper::~JniHelper() {
             AndroidContextHelper::releaseContext(getEnv());
+            // threads still attached stay so, the destructor must not outlive the library
+            pthread_key_delete(envKey);
+            attachedVm = nullptr;
             javaVm = nullptr;
         }
 
@@ -44,24 +59,36 @@ namespace agora {
         }
 
         JNIEnv *JniHelper::attachCurrentThread() {
-            JNIEnv *env = nullptr;
+            JNIEnv *env = static_cast<JNIEnv *>(pthread_getspecific(envKey));
+            if (env) {
+                return env;
+            }
             int status = javaVm->GetEnv((void **) &env, JNI_VERSION_1_6);
             if (status == JNI_EDETACHED) {
                 status = javaVm->AttachCurrentThread(&env, nullptr);
                 if (status != 0) {
                     return nullptr;
                 }
-                isAttached = true;
+                pthread_setspecific(envKey, env);
                 return env;
             }
+            // a Java thread, attached by its owner
             return env;
         }
 
         void JniHelper::detachCurrentThread() {
-            if (isAttached) {
+            if (pthread_getspecific(envKey)) {
+                pthread_setspecific(envKey, nullptr);
+                javaVm->DetachCurrentThread();
+            }
+        }
+
+        void JniHelper::detachWorkerThread() {
+            pthread_setspecific(envKey, nullptr);
+            JNIEnv *env = nullptr;
+            if (javaVm->GetEnv((void **) &env, JNI_VERSION_1_6) == JNI_OK) {
                 javaVm->DetachCurrentThread();
             }
-            isAttached = false;
         }
 
         void * AndroidContextHelper::_context = nullptr;
@@ -8,6 +8,7 @@
 #if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
 
 #include <jni.h>
+#include <pthread.h>
 
 namespace agora {
     namespace extension {
@@ -16,10 +17,11 @@ namespace agora {
             JniHelper(JavaVM *jvm);
 
             JavaVM *javaVm;
+            // env of each thread attached here, detached when the thread exits
+            pthread_key_t envKey;
             static JniHelper *jniHelper;
 
         public:
-            bool isAttached = false;
             jclass agoraByteDanceNativeClz;
 
             ~JniHelper();
@@ -32,10 +34,14 @@ namespace agora {
 
             JNIEnv *getEnv();
 
+            // attaches once per thread, later calls are a thread-local lookup
             JNIEnv *attachCurrentThread();
 
             void detachCurrentThread();
 
+            // detaches a thread owned by the extension, whether or not it attached itself
+            void detachWorkerThread();
+
 
         };
 
@@ -0,0 +1,59 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "LicenseCache.h"
+
+#include <sys/stat.h>
+
+#include "../logutils.h"
+
+namespace agora {
+    namespace extension {
+        LicenseCache& LicenseCache::getInstance() {
+            static LicenseCache instance;
+            return instance;
+        }
+
+        bool LicenseCache::isVerdict(bef_effect_result_t result) {
+            // errors about the license itself, anything else may pass on a retry
+            switch (result) {
+                case BEF_RESULT_INVALID_LICENSE:
+                case BEF_RESULT_LICENSE_STATUS_INVALID:
+                case BEF_RESULT_LICENSE_STATUS_EXPIRED:
+                case BEF_RESULT_LICENSE_STATUS_NO_FUNC:
+                case BEF_RESULT_LICENSE_STATUS_ID_NOT_MATCH:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        bef_effect_result_t LicenseCache::check(const char* feature, const std::string& licensePath,
+                                                const std::function<bef_effect_result_t()>& checkLicense) {
+            struct stat info;
+            if (stat(licensePath.c_str(), &info) != 0) {
+                return checkLicense();
+            }
+            int64_t modified = (int64_t)info.st_mtime;
+            int64_t size = (int64_t)info.st_size;
+            {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                for (const Verdict& verdict : rejected_) {
+                    if (verdict.feature == feature && verdict.path == licensePath &&
+                        verdict.modified == modified && verdict.size == size) {
+                        return verdict.result;
+                    }
+                }
+            }
+
+            bef_effect_result_t result = checkLicense();
+            if (isVerdict(result)) {
+                PRINTF_ERROR("LicenseCache %s rejected %s: %d", feature, licensePath.c_str(), result);
+                const std::lock_guard<std::mutex> lock(mutex_);
+                rejected_.push_back({feature, licensePath, modified, size, result});
+            }
+            return result;
+        }
+    }
+}
@@ -0,0 +1,52 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_LICENSECACHE_H
+#define AGORAWITHBYTEDANCE_LICENSECACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../bytedance/bef_effect_ai_public_define.h"
+
+namespace agora {
+    namespace extension {
+        /**
+         * License verdicts of the process.
+         *
+         * The SDK authorizes every handle on its own, so a new handle is still
+         * checked, but a license file the SDK rejected for a feature (invalid,
+         * expired, wrong app id, feature not licensed) is remembered and never
+         * sent through the JVM again. A file replaced on disk is a new license.
+         * Accepted checks are not remembered: a handle that skipped its check
+         * would stay unauthorized.
+         */
+        class LicenseCache {
+        public:
+            static LicenseCache& getInstance();
+
+            bef_effect_result_t check(const char* feature, const std::string& licensePath,
+                                      const std::function<bef_effect_result_t()>& checkLicense);
+
+        private:
+            struct Verdict {
+                std::string feature;
+                std::string path;
+                int64_t modified;
+                int64_t size;
+                bef_effect_result_t result;
+            };
+
+            static bool isVerdict(bef_effect_result_t result);
+
+            std::mutex mutex_;
+            std::vector<Verdict> rejected_;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_LICENSECACHE_H
@@ -0,0 +1,430 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "LogRing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include "../logutils.h"
+#include "AgoraRtcKit/NGIAgoraExtensionControl.h"
+
+namespace agora {
+    namespace extension {
+        namespace {
+            const uint16_t kClippedString = 0x8000;
+
+            struct Arg {
+                char tag = 0;
+                uint64_t bits = 0;
+                const char* string = nullptr;
+                uint16_t length = 0;
+                bool clipped = false;
+            };
+
+            bool readArg(const char* args, size_t used, size_t& offset, Arg& arg) {
+                if (offset >= used) {
+                    return false;
+                }
+                arg.tag = args[offset++];
+                if (arg.tag == 's') {
+                    uint16_t length = 0;
+                    memcpy(&length, args + offset, sizeof(length));
+                    offset += sizeof(length);
+                    arg.clipped = (length & kClippedString) != 0;
+                    arg.length = length & ~kClippedString;
+                    arg.string = args + offset;
+                    offset += arg.length;
+                } else {
+                    memcpy(&arg.bits, args + offset, sizeof(arg.bits));
+                    offset += sizeof(arg.bits);
+                }
+                return true;
+            }
+
+            int64_t asSigned(const Arg& arg) {
+                if (arg.tag == 'd') {
+                    double value;
+                    memcpy(&value, &arg.bits, sizeof(value));
+                    return (int64_t)value;
+                }
+                return (int64_t)arg.bits;
+            }
+
+            double asDouble(const Arg& arg) {
+                if (arg.tag == 'd') {
+                    double value;
+                    memcpy(&value, &arg.bits, sizeof(value));
+                    return value;
+                }
+                return arg.tag == 'u' ? (double)arg.bits : (double)(int64_t)arg.bits;
+            }
+
+            size_t append(char* out, size_t size, size_t length, const char* text, size_t count) {
+                count = std::min(count, size - 1 - length);
+                memcpy(out + length, text, count);
+                return length + count;
+            }
+        }
+
+        LogRing& LogRing::getInstance() {
+            static LogRing instance;
+            return instance;
+        }
+
+        LogRing::LogRing() : enqueuePosition_(0), dequeuePosition_(0), dropped_(0), started_(false), stopped_(false), idle_(false),
+                             control_(nullptr) {
+            for (int i = 0; i < kSlots; i++) {
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        LogRing::~LogRing() {
+            shutdown();
+            std::lock_guard<std::mutex> lock(fileMutex_);
+            if (file_) {
+                fclose(file_);
+                file_ = nullptr;
+            }
+        }
+
+        int64_t LogRing::monotonicMs() {
+#if defined(CLOCK_MONOTONIC_COARSE)
+            // tick granularity is enough for the rate limit and costs no syscall
+            timespec now;
+            clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+            return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+#else
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+
+        bool LogRing::admit(LogSite& site, int64_t nowMs, uint32_t& suppressed) {
+            int64_t windowStart = site.windowStartMs.load(std::memory_order_relaxed);
+            if (nowMs - windowStart >= kSiteWindowMs &&
+                site.windowStartMs.compare_exchange_strong(windowStart, nowMs, std::memory_order_relaxed)) {
+                site.count.store(0, std::memory_order_relaxed);
+            }
+            if (site.count.fetch_add(1, std::memory_order_relaxed) >= kSiteBurst) {
+                site.suppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        void LogRing::putValue(Record& record, ARG_TAG tag, const void* value, size_t size) {
+            if (record.truncated || record.used + 1 + size > (size_t)kArgBytes) {
+                record.truncated = true;
+                return;
+            }
+            record.args[record.used] = tag;
+            memcpy(record.args + record.used + 1, value, size);
+            record.used += 1 + size;
+        }
+
+        void LogRing::put(Record& record, const char* value) {
+            if (!value) {
+                value = "(null)";
+            }
+            size_t header = 1 + sizeof(uint16_t);
+            if (record.truncated || record.used + header > (size_t)kArgBytes) {
+                record.truncated = true;
+                return;
+            }
+            size_t room = std::min((size_t)kMaxStringBytes, kArgBytes - record.used - header);
+            size_t length = strnlen(value, room + 1);
+            uint16_t encoded = (uint16_t)std::min(length, room);
+            if (length > room) {
+                encoded |= kClippedString;
+                length = room;
+            }
+            char* out = record.args + record.used;
+            out[0] = ARG_STRING;
+            memcpy(out + 1, &encoded, sizeof(encoded));
+            memcpy(out + header, value, length);
+            record.used += header + length;
+        }
+
+        LogRing::Slot* LogRing::claim() {
+            uint64_t position = enqueuePosition_.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = slots_[position % kSlots];
+                uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+                int64_t lag = (int64_t)(sequence - position);
+                if (lag == 0) {
+                    if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        slot.position = position;
+                        return &slot;
+                    }
+                } else if (lag < 0) {
+                    // the consumer has not freed this slot yet, the ring is full
+                    return nullptr;
+                } else {
+                    position = enqueuePosition_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void LogRing::publish(Slot* slot) {
+            slot->sequence.store(slot->position + 1, std::memory_order_release);
+            if (stopped_.load()) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                drainLocked();
+                return;
+            }
+            if (!started_.load(std::memory_order_acquire)) {
+                start();
+            }
+            // the consumer wakes up on its own, it is only hurried when the ring fills up
+            uint64_t backlog = slot->position + 1 - dequeuePosition_.load(std::memory_order_relaxed);
+            if (backlog >= kSlots / 2 && idle_.load(std::memory_order_relaxed) && idle_.exchange(false)) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                wakeup_.notify_one();
+            }
+        }
+
+        bool LogRing::hasPending() const {
+            uint64_t position = dequeuePosition_.load(std::memory_order_relaxed);
+            return slots_[position % kSlots].sequence.load(std::memory_order_acquire) == position + 1;
+        }
+
+        void LogRing::start() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (started_.load(std::memory_order_relaxed) || stopped_.load()) {
+                return;
+            }
+            consumer_ = std::thread(&LogRing::run, this);
+            started_.store(true, std::memory_order_release);
+        }
+
+        void LogRing::run() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;) {
+                drainLocked();
+                drained_.notify_all();
+                if (stopping_) {
+                    return;
+                }
+                idle_.store(true);
+                wakeup_.wait_for(lock, std::chrono::milliseconds((int)kDrainIntervalMs),
+                                 [this] { return stopping_ || !idle_.load(); });
+                idle_.store(false);
+            }
+        }
+
+        void LogRing::drainLocked() {
+            while (hasPending()) {
+                uint64_t position = dequeuePosition_.load(std::memory_order_relaxed);
+                Slot& slot = slots_[position % kSlots];
+                write(slot.record);
+                slot.sequence.store(position + kSlots, std::memory_order_release);
+                dequeuePosition_.store(position + 1, std::memory_order_relaxed);
+            }
+        }
+
+        void LogRing::flush() {
+            if (!started_.load(std::memory_order_acquire) || stopped_.load()) {
+                return;
+            }
+            uint64_t target = enqueuePosition_.load();
+            std::unique_lock<std::mutex> lock(mutex_);
+            idle_.store(false);
+            wakeup_.notify_one();
+            drained_.wait(lock, [this, target] {
+                return stopping_ || dequeuePosition_.load(std::memory_order_relaxed) >= target;
+            });
+        }
+
+        void LogRing::shutdown() {
+            if (stopped_.exchange(true)) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+                wakeup_.notify_one();
+            }
+            if (consumer_.joinable()) {
+                consumer_.join();
+            }
+            // records published while the consumer was exiting, a record racing this drain goes out with the next post
+            std::lock_guard<std::mutex> lock(mutex_);
+            drainLocked();
+        }
+
+        void LogRing::setExtensionControl(rtc::IExtensionControl* control) {
+            control_.store(control, std::memory_order_release);
+            // a record being written to the previous control finishes before the caller may free it
+            std::lock_guard<std::mutex> lock(mutex_);
+        }
+
+        bool LogRing::setLogFile(const std::string& path) {
+            FILE* file = path.empty() ? nullptr : fopen(path.c_str(), "a");
+            std::lock_guard<std::mutex> lock(fileMutex_);
+            if (file_) {
+                fclose(file_);
+            }
+            file_ = file;
+            return path.empty() || file;
+        }
+
+        size_t LogRing::format(const char* format, const char* args, size_t used, char* out, size_t size) {
+            if (size == 0) {
+                return 0;
+            }
+            size_t length = 0;
+            size_t offset = 0;
+            const char* p = format ? format : "";
+            while (*p && length + 1 < size) {
+                if (*p != '%') {
+                    const char* next = strchr(p, '%');
+                    size_t count = next ? (size_t)(next - p) : strlen(p);
+                    length = append(out, size, length, p, count);
+                    p += count;
+                    continue;
+                }
+                if (p[1] == '%') {
+                    length = append(out, size, length, "%", 1);
+                    p += 2;
+                    continue;
+                }
+                // rebuild the conversion with our own length modifier, the caller's one no longer applies
+                char spec[32];
+                size_t specLength = 0;
+                spec[specLength++] = *p++;
+                while (*p && strchr("-+ #0123456789.*", *p) && specLength < sizeof(spec) - 4) {
+                    spec[specLength++] = *p++;
+                }
+                while (*p && strchr("hljztLq", *p)) {
+                    p++;
+                }
+                char conversion = *p;
+                if (!conversion) {
+                    break;
+                }
+                p++;
+                if (memchr(spec, '*', specLength)) {
+                    // widths taken from the arguments are not supported, they would shift every argument after
+                    specLength = 1;
+                }
+
+                Arg arg;
+                if (!readArg(args, used, offset, arg)) {
+                    length = append(out, size, length, "?", 1);
+                    continue;
+                }
+                char* target = out + length;
+                size_t room = size - length;
+                int written = 0;
+                switch (conversion) {
+                    case 'd':
+                    case 'i':
+                        memcpy(spec + specLength, "lld", 4);
+                        written = arg.tag == 's' ? -1 : snprintf(target, room, spec, (long long)asSigned(arg));
+                        break;
+                    case 'u':
+                    case 'o':
+                    case 'x':
+                    case 'X':
+                        spec[specLength] = 'l';
+                        spec[specLength + 1] = 'l';
+                        spec[specLength + 2] = conversion;
+                        spec[specLength + 3] = 0;
+                        written = arg.tag == 's' ? -1 : snprintf(target, room, spec, (unsigned long long)asSigned(arg));
+                        break;
+                    case 'c':
+                        memcpy(spec + specLength, "c", 2);
+                        written = arg.tag == 's' ? -1 : snprintf(target, room, spec, (int)asSigned(arg));
+                        break;
+                    case 'f':
+                    case 'F':
+                    case 'e':
+                    case 'E':
+                    case 'g':
+                    case 'G':
+                    case 'a':
+                    case 'A':
+                        spec[specLength] = conversion;
+                        spec[specLength + 1] = 0;
+                        written = arg.tag == 's' ? -1 : snprintf(target, room, spec, asDouble(arg));
+                        break;
+                    case 's': {
+                        if (arg.tag != 's') {
+                            written = -1;
+                            break;
+                        }
+                        char text[kMaxStringBytes + 4];
+                        memcpy(text, arg.string, arg.length);
+                        size_t textLength = arg.length;
+                        if (arg.clipped) {
+                            memcpy(text + textLength, "...", 3);
+                            textLength += 3;
+                        }
+                        text[textLength] = 0;
+                        memcpy(spec + specLength, "s", 2);
+                        written = snprintf(target, room, spec, text);
+                        break;
+                    }
+                    case 'p':
+                        written = arg.tag == 's' ? -1 : snprintf(target, room, "%p", (void*)(uintptr_t)arg.bits);
+                        break;
+                    default:
+                        written = -1;
+                        break;
+                }
+                if (written < 0) {
+                    length = append(out, size, length, "?", 1);
+                } else {
+                    length += std::min((size_t)written, room - 1);
+                }
+            }
+            out[length] = 0;
+            return length;
+        }
+
+        void LogRing::write(const Record& record) {
+            char line[1024];
+            size_t length = format(record.format, record.args, record.used, line, sizeof(line));
+            if (record.suppressed) {
+                snprintf(line + length, sizeof(line) - length, " (%u more suppressed)", record.suppressed);
+            }
+
+            rtc::IExtensionControl* control = control_.load(std::memory_order_acquire);
+            if (control) {
+                control->log(record.level, line);
+            } else {
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+                int priority = ANDROID_LOG_DEBUG;
+                if (record.level == commons::LOG_LEVEL::LOG_LEVEL_WARN) {
+                    priority = ANDROID_LOG_WARN;
+                } else if (record.level >= commons::LOG_LEVEL::LOG_LEVEL_ERROR) {
+                    priority = ANDROID_LOG_ERROR;
+                }
+                __android_log_print(priority, LOG_TAG, "%s", line);
+#else
+                bool error = record.level >= commons::LOG_LEVEL::LOG_LEVEL_ERROR;
+                fprintf(error ? stderr : stdout, LOG_TAG " %s: %s\n", error ? "E" : "D", line);
+#endif
+            }
+
+            std::lock_guard<std::mutex> lock(fileMutex_);
+            if (file_) {
+                int64_t ageMs = monotonicMs() - record.timeMs;
+                int64_t timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count() - ageMs;
+                time_t seconds = (time_t)(timeMs / 1000);
+                tm local;
+                localtime_r(&seconds, &local);
+                const char* level = record.level >= commons::LOG_LEVEL::LOG_LEVEL_ERROR ? "E"
+                        : record.level == commons::LOG_LEVEL::LOG_LEVEL_WARN ? "W" : "I";
+                fprintf(file_, "%02d-%02d %02d:%02d:%02d.%03d %s %s\n", local.tm_mon + 1, local.tm_mday,
+                        local.tm_hour, local.tm_min, local.tm_sec, (int)(timeMs % 1000), level, line);
+                fflush(file_);
+            }
+        }
+    }
+}
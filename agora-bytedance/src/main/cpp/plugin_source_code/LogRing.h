@@ -0,0 +1,203 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_LOGRING_H
+#define AGORAWITHBYTEDANCE_LOGRING_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <AgoraRtcKit/IAgoraLog.h>
+
+namespace agora {
+    namespace rtc {
+        class IExtensionControl;
+    }
+
+    namespace extension {
+        // rate limit of one PRINTF_* call site, a function-local static (zero-initialized, no guard)
+        struct LogSite {
+            std::atomic<int64_t> windowStartMs;
+            std::atomic<uint32_t> count;
+            std::atomic<uint32_t> suppressed;
+        };
+
+        /**
+         * Asynchronous log of the extension.
+         *
+         * post() copies the format pointer and the arguments, strings included,
+         * into a slot of a fixed ring and returns without a syscall; a consumer
+         * thread wakes up every kDrainIntervalMs, or early when the ring is half
+         * full, formats the records and hands them to the engine log (IExtensionControl::log)
+         * once the SDK provided it, else to logcat, or stdout/stderr on a host
+         * build, and optionally to a file. Every call site may post kSiteBurst
+         * records per second, the rest is counted and reported with the next
+         * record that gets through. A full ring drops the record.
+         */
+        class LogRing {
+        public:
+            static const int kSlots = 256;
+            static const int kArgBytes = 480;
+            // longer strings are cut and end in "..."
+            static const int kMaxStringBytes = 384;
+            static const uint32_t kSiteBurst = 10;
+            static const int64_t kSiteWindowMs = 1000;
+            static const int kDrainIntervalMs = 20;
+
+            static LogRing& getInstance();
+
+            ~LogRing();
+
+            template <typename... Args>
+            void post(LogSite& site, commons::LOG_LEVEL level, const char* format, Args... args) {
+                uint32_t suppressed = 0;
+                int64_t nowMs = monotonicMs();
+                if (!admit(site, nowMs, suppressed)) {
+                    return;
+                }
+                Slot* slot = claim();
+                if (!slot) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                Record& record = slot->record;
+                record.level = level;
+                record.suppressed = suppressed;
+                record.timeMs = nowMs;
+                record.format = format;
+                record.used = 0;
+                record.truncated = false;
+                int expand[] = {0, (put(record, args), 0)...};
+                (void)expand;
+                publish(slot);
+            }
+
+            void setExtensionControl(rtc::IExtensionControl* control);
+
+            // every line also goes to this file, an empty path closes it
+            bool setLogFile(const std::string& path);
+
+            // blocks until every record posted so far is written
+            void flush();
+
+            // drains and stops the consumer, records posted later are written by the caller
+            void shutdown();
+
+            uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+            // the line of a record, exposed for the off-device tests
+            static size_t format(const char* format, const char* args, size_t used, char* out, size_t size);
+
+        private:
+            enum ARG_TAG : char {
+                ARG_SIGNED = 'i',
+                ARG_UNSIGNED = 'u',
+                ARG_DOUBLE = 'd',
+                ARG_STRING = 's',
+                ARG_POINTER = 'p',
+            };
+
+            struct Record {
+                commons::LOG_LEVEL level;
+                uint32_t suppressed;
+                // monotonic, turned into wall clock time by the consumer
+                int64_t timeMs;
+                const char* format;
+                uint16_t used;
+                // an argument did not fit, it and the ones after it print as "?"
+                bool truncated;
+                char args[kArgBytes];
+            };
+
+            struct Slot {
+                std::atomic<uint64_t> sequence;
+                uint64_t position;
+                Record record;
+            };
+
+            LogRing();
+
+            static int64_t monotonicMs();
+
+            static bool admit(LogSite& site, int64_t nowMs, uint32_t& suppressed);
+
+            static void putValue(Record& record, ARG_TAG tag, const void* value, size_t size);
+
+            template <typename T>
+            static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+            put(Record& record, T value) {
+                int64_t wide = value;
+                putValue(record, ARG_SIGNED, &wide, sizeof(wide));
+            }
+
+            template <typename T>
+            static typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+            put(Record& record, T value) {
+                uint64_t wide = value;
+                putValue(record, ARG_UNSIGNED, &wide, sizeof(wide));
+            }
+
+            template <typename T>
+            static typename std::enable_if<std::is_enum<T>::value>::type put(Record& record, T value) {
+                int64_t wide = static_cast<int64_t>(value);
+                putValue(record, ARG_SIGNED, &wide, sizeof(wide));
+            }
+
+            template <typename T>
+            static typename std::enable_if<std::is_floating_point<T>::value>::type put(Record& record, T value) {
+                double wide = value;
+                putValue(record, ARG_DOUBLE, &wide, sizeof(wide));
+            }
+
+            static void put(Record& record, const char* value);
+
+            static void put(Record& record, char* value) { put(record, (const char*)value); }
+
+            static void put(Record& record, const void* value) {
+                putValue(record, ARG_POINTER, &value, sizeof(value));
+            }
+
+            Slot* claim();
+
+            void publish(Slot* slot);
+
+            bool hasPending() const;
+
+            void start();
+
+            void run();
+
+            // drains the ring on the calling thread, under mutex_
+            void drainLocked();
+
+            void write(const Record& record);
+
+            Slot slots_[kSlots];
+            std::atomic<uint64_t> enqueuePosition_;
+            std::atomic<uint64_t> dequeuePosition_;
+            std::atomic<uint64_t> dropped_;
+
+            std::atomic<bool> started_;
+            std::atomic<bool> stopped_;
+            // set while the consumer sleeps, cleared by the producer that wakes it early
+            std::atomic<bool> idle_;
+            bool stopping_ = false;
+            std::mutex mutex_;
+            std::condition_variable wakeup_;
+            std::condition_variable drained_;
+            std::thread consumer_;
+
+            std::atomic<rtc::IExtensionControl*> control_;
+            std::mutex fileMutex_;
+            FILE* file_ = nullptr;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_LOGRING_H
@@ -0,0 +1,167 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "LoudnessNormalizer.h"
+#include "AudioUtils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace agora {
+    namespace extension {
+        namespace {
+            const double kPi = 3.14159265358979323846;
+            const double kS16Scale = 1.0 / 32768.0;
+            const float kMaxGainDb = 12.0f;
+            const float kMinGainDb = -12.0f;
+            const float kAttackSeconds = 0.5f;
+            const float kReleaseSeconds = 3.0f;
+
+            double lufsToMeanSquare(float lufs) {
+                return std::pow(10.0, (lufs + 0.691) / 10.0);
+            }
+        }
+
+        void LoudnessMeter::configure(int sampleRate, int channels) {
+            sampleRate_ = sampleRate;
+            channels_ = std::min(channels, (int)kMaxChannels);
+
+            // K-weighting pre-filter (high shelf), BS.1770 coefficients re-derived for fs
+            double f0 = 1681.974450955533;
+            double gainDb = 3.999843853973347;
+            double q = 0.7071752369554196;
+            double k = std::tan(kPi * f0 / sampleRate);
+            double vh = std::pow(10.0, gainDb / 20.0);
+            double vb = std::pow(vh, 0.4996667741545416);
+            double a0 = 1.0 + k / q + k * k;
+            shelf_.b0 = (vh + vb * k / q + k * k) / a0;
+            shelf_.b1 = 2.0 * (k * k - vh) / a0;
+            shelf_.b2 = (vh - vb * k / q + k * k) / a0;
+            shelf_.a1 = 2.0 * (k * k - 1.0) / a0;
+            shelf_.a2 = (1.0 - k / q + k * k) / a0;
+
+            // RLB high-pass
+            f0 = 38.13547087602444;
+            q = 0.5003270373238773;
+            k = std::tan(kPi * f0 / sampleRate);
+            a0 = 1.0 + k / q + k * k;
+            highPass_.b0 = 1.0;
+            highPass_.b1 = -2.0;
+            highPass_.b2 = 1.0;
+            highPass_.a1 = 2.0 * (k * k - 1.0) / a0;
+            highPass_.a2 = (1.0 - k / q + k * k) / a0;
+
+            subBlockLength_ = std::max(1, sampleRate * kSubBlockMs / 1000);
+            reset();
+        }
+
+        void LoudnessMeter::reset() {
+            for (int ch = 0; ch < kMaxChannels; ch++) {
+                for (int i = 0; i < 4; i++) {
+                    state_[ch][i] = 0;
+                }
+            }
+            for (int i = 0; i < kShortTermBlocks; i++) {
+                blocks_[i] = 0;
+            }
+            subBlockFill_ = 0;
+            subBlockSum_ = 0;
+            ringPos_ = 0;
+            gatedSum_ = 0;
+            gatedCount_ = 0;
+        }
+
+        bool LoudnessMeter::addSample(const int16_t* samples) {
+            for (int ch = 0; ch < channels_; ch++) {
+                double x = samples[ch] * kS16Scale;
+                double y = filter(highPass_, state_[ch] + 2, filter(shelf_, state_[ch], x));
+                subBlockSum_ += y * y;
+            }
+            if (++subBlockFill_ < subBlockLength_) {
+                return false;
+            }
+
+            double meanSquare = subBlockSum_ / subBlockLength_;
+            subBlockFill_ = 0;
+            subBlockSum_ = 0;
+
+            // blocks_ holds 0 for entries that did not pass the gate
+            static const double kGate = lufsToMeanSquare(kAbsoluteGateLufs);
+            double expired = blocks_[ringPos_];
+            if (expired > 0) {
+                gatedSum_ -= expired;
+                gatedCount_--;
+            }
+            if (meanSquare > kGate) {
+                blocks_[ringPos_] = meanSquare;
+                gatedSum_ += meanSquare;
+                gatedCount_++;
+            } else {
+                blocks_[ringPos_] = 0;
+            }
+            if (gatedCount_ == 0) {
+                // drop accumulated rounding error once the window is empty
+                gatedSum_ = 0;
+            }
+            ringPos_ = (ringPos_ + 1) % kShortTermBlocks;
+            return true;
+        }
+
+        float LoudnessMeter::shortTermLufs() const {
+            if (gatedCount_ <= 0 || gatedSum_ <= 0) {
+                return kAbsoluteGateLufs;
+            }
+            return (float)(-0.691 + 10.0 * std::log10(gatedSum_ / gatedCount_));
+        }
+
+        void LoudnessNormalizer::configure(int sampleRate, int channels) {
+            meter_.configure(sampleRate, channels);
+            attackCoeff_ = std::exp(-1.0f / (kAttackSeconds * sampleRate));
+            releaseCoeff_ = std::exp(-1.0f / (kReleaseSeconds * sampleRate));
+        }
+
+        void LoudnessNormalizer::reset() {
+            meter_.reset();
+            gain_ = 1.0f;
+            targetGain_ = 1.0f;
+        }
+
+        void LoudnessNormalizer::process(const agora::media::base::AudioPcmFrame& in,
+                                         agora::media::base::AudioPcmFrame& out, float volume) {
+            int channels = (int)in.num_channels_;
+            if (in.sample_rate_hz_ <= 0 || channels <= 0) {
+                // nothing to measure, still honour the volume like the plain gain path
+                size_t length = std::min(in.samples_per_channel_ * in.num_channels_,
+                                         (size_t)agora::media::base::AudioPcmFrame::kMaxDataSizeSamples);
+                for (size_t i = 0; i < length; i++) {
+                    out.data_[i] = FloatS16ToS16(in.data_[i] * volume);
+                }
+                return;
+            }
+            if (in.sample_rate_hz_ != meter_.sampleRate() ||
+                std::min(channels, (int)LoudnessMeter::kMaxChannels) != meter_.channels()) {
+                configure(in.sample_rate_hz_, channels);
+                gain_ = 1.0f;
+                targetGain_ = 1.0f;
+            }
+
+            const int16_t* src = in.data_;
+            int16_t* dst = out.data_;
+            for (size_t i = 0; i < in.samples_per_channel_; i++) {
+                if (meter_.addSample(src) && meter_.hasLoudness()) {
+                    float gainDb = targetLufs_ - meter_.shortTermLufs();
+                    gainDb = std::min(kMaxGainDb, std::max(kMinGainDb, gainDb));
+                    targetGain_ = std::pow(10.0f, gainDb / 20.0f);
+                }
+                float coeff = targetGain_ < gain_ ? attackCoeff_ : releaseCoeff_;
+                gain_ = targetGain_ + coeff * (gain_ - targetGain_);
+                float g = gain_ * volume;
+                for (int ch = 0; ch < channels; ch++) {
+                    dst[ch] = FloatS16ToS16(src[ch] * g);
+                }
+                src += channels;
+                dst += channels;
+            }
+        }
+    }
+}
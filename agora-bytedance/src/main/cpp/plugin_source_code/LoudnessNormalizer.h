@@ -0,0 +1,106 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_LOUDNESSNORMALIZER_H
+#define AGORAWITHBYTEDANCE_LOUDNESSNORMALIZER_H
+
+#include <cstdint>
+
+#include "AgoraRtcKit/AgoraMediaBase.h"
+
+namespace agora {
+    namespace extension {
+        /**
+         * Incremental K-weighted loudness meter (ITU-R BS.1770 / EBU R128).
+         *
+         * Samples run through the two K-weighting biquads; their energy is summed
+         * into 100 ms sub-blocks which feed a 3 s ring buffer. Sub-blocks below the
+         * -70 LUFS absolute gate are kept out of the running average, so silence
+         * does not drag the short-term loudness down. Every step is O(1) per sample
+         * and nothing is allocated after configure().
+         */
+        class LoudnessMeter {
+        public:
+            static const int kMaxChannels = 2;
+            static const int kSubBlockMs = 100;
+            static const int kShortTermBlocks = 30;
+            static constexpr float kAbsoluteGateLufs = -70.0f;
+
+            void configure(int sampleRate, int channels);
+
+            void reset();
+
+            // Adds one interleaved sample frame. Returns true when a sub-block completed.
+            bool addSample(const int16_t* samples);
+
+            // Loudness of the gated sub-blocks of the last 3 s.
+            float shortTermLufs() const;
+
+            bool hasLoudness() const { return gatedCount_ > 0; }
+
+            int sampleRate() const { return sampleRate_; }
+
+            int channels() const { return channels_; }
+
+        private:
+            struct Biquad {
+                double b0, b1, b2, a1, a2;
+            };
+
+            static double filter(const Biquad& bq, double* z, double x) {
+                // transposed direct form II
+                double y = bq.b0 * x + z[0];
+                z[0] = bq.b1 * x - bq.a1 * y + z[1];
+                z[1] = bq.b2 * x - bq.a2 * y;
+                return y;
+            }
+
+            Biquad shelf_ = {1, 0, 0, 0, 0};
+            Biquad highPass_ = {1, 0, 0, 0, 0};
+            double state_[kMaxChannels][4] = {};
+            int sampleRate_ = 0;
+            int channels_ = 0;
+            int subBlockLength_ = 0;
+            int subBlockFill_ = 0;
+            double subBlockSum_ = 0;
+            double blocks_[kShortTermBlocks] = {};
+            int ringPos_ = 0;
+            double gatedSum_ = 0;
+            int gatedCount_ = 0;
+        };
+
+        /**
+         * Steers gain toward a target loudness using LoudnessMeter's short-term
+         * value, with separate attack (gain going down) and release (gain going up)
+         * time constants applied per sample.
+         */
+        class LoudnessNormalizer {
+        public:
+            void setTargetLufs(float lufs) { targetLufs_ = lufs; }
+
+            float targetLufs() const { return targetLufs_; }
+
+            void reset();
+
+            void process(const agora::media::base::AudioPcmFrame& in,
+                         agora::media::base::AudioPcmFrame& out, float volume);
+
+            float currentGain() const { return gain_; }
+
+            float shortTermLufs() const { return meter_.shortTermLufs(); }
+
+        private:
+            void configure(int sampleRate, int channels);
+
+            LoudnessMeter meter_;
+            float targetLufs_ = -23.0f;
+            float gain_ = 1.0f;
+            float targetGain_ = 1.0f;
+            float attackCoeff_ = 0.0f;
+            float releaseCoeff_ = 0.0f;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_LOUDNESSNORMALIZER_H
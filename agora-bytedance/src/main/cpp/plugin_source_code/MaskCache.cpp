@@ -0,0 +1,49 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "MaskCache.h"
+
+#include <AgoraRtcKit/AgoraRefCountedObject.h>
+
+namespace agora {
+    namespace extension {
+        agora_refptr<SegmentationMask> MaskCache::acquire(MASK_KIND kind) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            for (int i = 0; i < kPoolSize; i++) {
+                agora_refptr<SegmentationMask>& entry = pool_[kind][i];
+                if (!entry) {
+                    entry = new RefCountedObject<SegmentationMask>();
+                    return entry;
+                }
+                // only the pool holds it: not published, not read by anyone
+                if (entry->HasOneRef()) {
+                    entry->resetRegions(0);
+                    return entry;
+                }
+            }
+            // every pooled mask is still in use, fall back to a one-off
+            return new RefCountedObject<SegmentationMask>();
+        }
+
+        void MaskCache::publish(MASK_KIND kind, const agora_refptr<SegmentationMask>& mask) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            latest_[kind] = mask;
+        }
+
+        agora_refptr<SegmentationMask> MaskCache::latest(MASK_KIND kind) const {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            return latest_[kind];
+        }
+
+        void MaskCache::clear() {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            for (int kind = 0; kind < MASK_KIND_COUNT; kind++) {
+                latest_[kind] = nullptr;
+                for (int i = 0; i < kPoolSize; i++) {
+                    pool_[kind][i] = nullptr;
+                }
+            }
+        }
+    }
+}
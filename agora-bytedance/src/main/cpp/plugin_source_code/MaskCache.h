@@ -0,0 +1,93 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_MASKCACHE_H
+#define AGORAWITHBYTEDANCE_MASKCACHE_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <AgoraRtcKit/AgoraRefPtr.h>
+
+namespace agora {
+    namespace extension {
+        enum MASK_KIND {
+            MASK_PORTRAIT = 0,
+            MASK_HAIR = 1,
+            MASK_HEAD = 2,
+            MASK_KIND_COUNT = 3,
+        };
+
+        /**
+         * One alpha map of a segmentation result. Portrait and hair masks cover the
+         * whole frame; head masks cover one face crop each, placed in the frame by
+         * the affine matrix the head segmentation SDK returns.
+         */
+        struct MaskRegion {
+            int id = 0;
+            int width = 0;
+            int height = 0;
+            int channels = 1;
+            double matrix[6] = {1, 0, 0, 0, 1, 0};
+            std::vector<uint8_t> alpha;
+        };
+
+        class SegmentationMask : public RefCountInterface {
+        public:
+            // renderTimeMs of the frame the mask was inferred from
+            int64_t timestampMs = 0;
+
+            int regionCount() const { return regionCount_; }
+
+            const MaskRegion& region(int index) const { return regions_[index]; }
+
+            // keeps the region buffers of earlier use, only their contents change;
+            // fill region(0) to region(count - 1) afterwards
+            void resetRegions(int count) {
+                if ((int)regions_.size() < count) {
+                    regions_.resize(count);
+                }
+                regionCount_ = count;
+            }
+
+            MaskRegion& region(int index) { return regions_[index]; }
+
+        protected:
+            ~SegmentationMask() {}
+
+        private:
+            std::vector<MaskRegion> regions_;
+            int regionCount_ = 0;
+        };
+
+        /**
+         * Latest segmentation result of each analyzer, shared by every consumer.
+         *
+         * Producers fill a mask from acquire() and publish() it; consumers keep a
+         * reference to the published mask for as long as they use it, so a slow
+         * consumer never sees the buffer change underneath. acquire() hands out a
+         * pooled mask that nobody references any more, which makes the steady
+         * state allocation free.
+         */
+        class MaskCache {
+        public:
+            static const int kPoolSize = 3;
+
+            agora_refptr<SegmentationMask> acquire(MASK_KIND kind);
+
+            void publish(MASK_KIND kind, const agora_refptr<SegmentationMask>& mask);
+
+            agora_refptr<SegmentationMask> latest(MASK_KIND kind) const;
+
+            void clear();
+
+        private:
+            mutable std::mutex mutex_;
+            agora_refptr<SegmentationMask> pool_[MASK_KIND_COUNT][kPoolSize];
+            agora_refptr<SegmentationMask> latest_[MASK_KIND_COUNT];
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_MASKCACHE_H
@@ -0,0 +1,161 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "ReadbackRing.h"
+
+#include <algorithm>
+
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+#include <GLES3/gl3.h>
+#endif
+
+namespace agora {
+    namespace extension {
+        namespace {
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+            class GlReadbackBackend : public ReadbackBackend {
+            public:
+                explicit GlReadbackBackend(GlContextManager::Context* context) : context_(context) {}
+
+                unsigned int acquireBuffer(int width, int height) override {
+                    return GlContextManager::getInstance().acquire(context_, {GL_OBJECT_PIXEL_BUFFER, width, height, 0});
+                }
+
+                void recycleBuffer(unsigned int buffer) override {
+                    GlContextManager::getInstance().recycle(context_, GL_OBJECT_PIXEL_BUFFER, buffer);
+                }
+
+                void readPixels(unsigned int framebuffer, int width, int height, unsigned int buffer) override {
+                    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+                    // with a pack buffer bound the last argument is an offset, the copy stays on the GPU
+                    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+                }
+
+                void* insertFence() override {
+                    return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                }
+
+                bool waitFence(void* fence, uint64_t timeoutNs) override {
+                    GLenum status = glClientWaitSync(static_cast<GLsync>(fence), GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNs);
+                    return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+                }
+
+                void deleteFence(void* fence) override {
+                    glDeleteSync(static_cast<GLsync>(fence));
+                }
+
+                const void* map(unsigned int buffer, size_t size) override {
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+                    return glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+                }
+
+                void unmap(unsigned int buffer) override {
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+                    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+                }
+
+            private:
+                GlContextManager::Context* context_;
+            };
+#endif
+        }
+
+        std::unique_ptr<ReadbackBackend> createGlReadbackBackend(GlContextManager::Context* context) {
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+            if (context) {
+                return std::unique_ptr<ReadbackBackend>(new GlReadbackBackend(context));
+            }
+#else
+            (void)context;
+#endif
+            return nullptr;
+        }
+
+        ReadbackRing::ReadbackRing(std::unique_ptr<ReadbackBackend> backend) : backend_(std::move(backend)) {
+        }
+
+        ReadbackRing::~ReadbackRing() {
+            clear();
+        }
+
+        void ReadbackRing::setDepth(int depth) {
+            // frames already in flight beyond the new depth are collected by the caller
+            depth_ = std::max(1, std::min(depth, (int)kMaxDepth));
+        }
+
+        bool ReadbackRing::submit(unsigned int framebuffer, int width, int height, int64_t timestampMs) {
+            if (pending_ >= kMaxDepth) {
+                return false;
+            }
+            Slot& slot = slots_[(oldest_ + pending_) % kMaxDepth];
+            slot.buffer = backend_->acquireBuffer(width, height);
+            slot.width = width;
+            slot.height = height;
+            slot.timestampMs = timestampMs;
+            backend_->readPixels(framebuffer, width, height, slot.buffer);
+            slot.fence = backend_->insertFence();
+            pending_++;
+            return true;
+        }
+
+        bool ReadbackRing::acquireOldest(ReadbackFrame& frame) {
+            if (pending_ == 0) {
+                return false;
+            }
+            Slot& slot = slots_[oldest_];
+            if (slot.fence) {
+                backend_->waitFence(slot.fence, kFenceTimeoutNs);
+                backend_->deleteFence(slot.fence);
+                slot.fence = nullptr;
+            }
+            const void* pixels = backend_->map(slot.buffer, (size_t)slot.width * slot.height * 4);
+            if (!pixels) {
+                return false;
+            }
+            slot.mapped = true;
+            frame.pixels = static_cast<const uint8_t*>(pixels);
+            frame.width = slot.width;
+            frame.height = slot.height;
+            frame.timestampMs = slot.timestampMs;
+            return true;
+        }
+
+        void ReadbackRing::releaseOldest() {
+            if (pending_ == 0) {
+                return;
+            }
+            Slot& slot = slots_[oldest_];
+            if (slot.mapped) {
+                backend_->unmap(slot.buffer);
+                slot.mapped = false;
+            }
+            if (slot.fence) {
+                backend_->deleteFence(slot.fence);
+                slot.fence = nullptr;
+            }
+            backend_->recycleBuffer(slot.buffer);
+            slot.buffer = 0;
+            oldest_ = (oldest_ + 1) % kMaxDepth;
+            pending_--;
+        }
+
+        void ReadbackRing::clear() {
+            while (pending_ > 0) {
+                releaseOldest();
+            }
+        }
+
+        void ReadbackRing::detach() {
+            for (Slot& slot : slots_) {
+                slot = Slot();
+            }
+            oldest_ = 0;
+            pending_ = 0;
+        }
+    }
+}
@@ -0,0 +1,113 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_READBACKRING_H
+#define AGORAWITHBYTEDANCE_READBACKRING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "GlContextManager.h"
+
+namespace agora {
+    namespace extension {
+        /**
+         * GL calls of an asynchronous readback, behind an interface so the ring
+         * runs against a fake on a desktop build. All calls are made on the
+         * thread whose context the backend was created for.
+         */
+        class ReadbackBackend {
+        public:
+            virtual ~ReadbackBackend() {}
+
+            virtual unsigned int acquireBuffer(int width, int height) = 0;
+
+            virtual void recycleBuffer(unsigned int buffer) = 0;
+
+            // queues a copy of the framebuffer's RGBA pixels into the buffer, returns at once
+            virtual void readPixels(unsigned int framebuffer, int width, int height, unsigned int buffer) = 0;
+
+            virtual void* insertFence() = 0;
+
+            // true once the GPU passed the fence
+            virtual bool waitFence(void* fence, uint64_t timeoutNs) = 0;
+
+            virtual void deleteFence(void* fence) = 0;
+
+            virtual const void* map(unsigned int buffer, size_t size) = 0;
+
+            virtual void unmap(unsigned int buffer) = 0;
+        };
+
+        // pixel buffers and fences of the context, null where there is no GLES3
+        std::unique_ptr<ReadbackBackend> createGlReadbackBackend(GlContextManager::Context* context);
+
+        struct ReadbackFrame {
+            const uint8_t* pixels;
+            int width;
+            int height;
+            // renderTimeMs of the frame the pixels were rendered for
+            int64_t timestampMs;
+        };
+
+        /**
+         * Ring of pixel buffers a rendered frame is read back through.
+         *
+         * submit() only queues the copy and a fence; the pixels are collected
+         * once `depth` frames are in flight, so with depth k the CPU gets frame
+         * N-k+1 while the GPU renders frame N and glReadPixels never waits for
+         * the frame it was issued for. Depth 1 is a plain synchronous readback.
+         * Every slot carries the timestamp of its frame.
+         */
+        class ReadbackRing {
+        public:
+            static const int kMaxDepth = 4;
+            // after this long the map below waits on its own
+            static const uint64_t kFenceTimeoutNs = 50 * 1000 * 1000;
+
+            explicit ReadbackRing(std::unique_ptr<ReadbackBackend> backend);
+
+            ~ReadbackRing();
+
+            void setDepth(int depth);
+
+            int depth() const { return depth_; }
+
+            int pending() const { return pending_; }
+
+            // false while every slot is in flight
+            bool submit(unsigned int framebuffer, int width, int height, int64_t timestampMs);
+
+            // waits for the oldest frame and maps it, valid until releaseOldest()
+            bool acquireOldest(ReadbackFrame& frame);
+
+            void releaseOldest();
+
+            // drops the frames in flight
+            void clear();
+
+            // forgets the frames in flight without a GL call, their context is gone
+            void detach();
+
+        private:
+            struct Slot {
+                unsigned int buffer = 0;
+                void* fence = nullptr;
+                int width = 0;
+                int height = 0;
+                int64_t timestampMs = 0;
+                bool mapped = false;
+            };
+
+            std::unique_ptr<ReadbackBackend> backend_;
+            Slot slots_[kMaxDepth];
+            int depth_ = 1;
+            int oldest_ = 0;
+            int pending_ = 0;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_READBACKRING_H
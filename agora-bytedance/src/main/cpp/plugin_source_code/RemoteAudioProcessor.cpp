@@ -0,0 +1,125 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "RemoteAudioProcessor.h"
+#include "AudioUtils.h"
+#include <chrono>
+#include "../logutils.h"
+
+namespace agora {
+    namespace extension {
+        namespace {
+            int64_t nowMs() {
+                return std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+        }
+
+        namespace {
+            AudioParameters remoteDefaults() {
+                AudioParameters params;
+                params.loudnessEnabled = 1;
+                return params;
+            }
+        }
+
+        RemoteAudioProcessor::RemoteAudioProcessor(Clock clock)
+                : clock_(clock ? clock : nowMs), parameters_(remoteDefaults()) {
+        }
+
+        void RemoteAudioProcessor::resetSlot(StreamSlot& slot) {
+            slot.normalizer.reset();
+        }
+
+        bool RemoteAudioProcessor::acquireStream(RemoteAudioStreamHandle& handle) {
+            for (int i = 0; i < kMaxStreams; i++) {
+                StreamSlot& slot = slots_[i];
+                uint32_t tag = slot.tag.load();
+                if ((tag & 3) != SLOT_FREE) {
+                    continue;
+                }
+                uint32_t generation = (tag >> 2) + 1;
+                if (slot.tag.compare_exchange_strong(tag, makeTag(generation, SLOT_BUSY))) {
+                    resetSlot(slot);
+                    slot.lastActiveMs = clock_();
+                    slot.tag = makeTag(generation, SLOT_IDLE);
+                    handle.index = i;
+                    handle.generation = generation;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void RemoteAudioProcessor::releaseStream(const RemoteAudioStreamHandle& handle) {
+            if (handle.index < 0 || handle.index >= kMaxStreams) {
+                return;
+            }
+            uint32_t expected = makeTag(handle.generation, SLOT_IDLE);
+            slots_[handle.index].tag.compare_exchange_strong(expected,
+                                                             makeTag(handle.generation, SLOT_FREE));
+        }
+
+        int RemoteAudioProcessor::activeStreamCount() const {
+            int count = 0;
+            for (int i = 0; i < kMaxStreams; i++) {
+                if ((slots_[i].tag.load() & 3) != SLOT_FREE) {
+                    count++;
+                }
+            }
+            return count;
+        }
+
+        void RemoteAudioProcessor::sweepIdleSlot(int64_t now) {
+            StreamSlot& slot = slots_[sweepCursor_++ % kMaxStreams];
+            uint32_t tag = slot.tag.load();
+            if ((tag & 3) != SLOT_IDLE || now - slot.lastActiveMs.load() < kIdleTimeoutMs) {
+                return;
+            }
+            // fails harmlessly if the owner started processing in the meantime
+            slot.tag.compare_exchange_strong(tag, makeTag(tag >> 2, SLOT_FREE));
+        }
+
+        int RemoteAudioProcessor::processFrame(RemoteAudioStreamHandle& handle,
+                                               const agora::media::base::AudioPcmFrame &in,
+                                               media::base::AudioPcmFrame& out) {
+            int64_t now = clock_();
+            sweepIdleSlot(now);
+
+            size_t length = in.samples_per_channel_ * in.num_channels_;
+            if (handle.index >= 0) {
+                uint32_t expected = makeTag(handle.generation, SLOT_IDLE);
+                if (!slots_[handle.index].tag.compare_exchange_strong(
+                        expected, makeTag(handle.generation, SLOT_BUSY))) {
+                    // evicted while idle, start over with fresh state
+                    handle.index = -1;
+                }
+            }
+            if (handle.index < 0) {
+                if (!acquireStream(handle)) {
+                    if (&out != &in) {
+                        memcpy(out.data_, in.data_, length * sizeof(int16_t));
+                    }
+                    return 0;
+                }
+                slots_[handle.index].tag = makeTag(handle.generation, SLOT_BUSY);
+            }
+
+            StreamSlot& slot = slots_[handle.index];
+            slot.lastActiveMs = now;
+            AudioParameters params = parameters_.snapshot();
+            float volume = params.volume / 100.0f;
+            if (params.loudnessEnabled) {
+                slot.normalizer.setTargetLufs(params.loudnessTarget);
+                slot.normalizer.process(in, out, volume);
+            } else {
+                for (size_t idx = 0; idx < length; idx++) {
+                    out.data_[idx] = FloatS16ToS16(in.data_[idx] * volume);
+                }
+            }
+            slot.tag = makeTag(handle.generation, SLOT_IDLE);
+            return 0;
+        }
+    }
+}
@@ -0,0 +1,110 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_REMOTEAUDIOPROCESSOR_H
+#define AGORAWITHBYTEDANCE_REMOTEAUDIOPROCESSOR_H
+
+#include <atomic>
+#include <string>
+#include <AgoraRtcKit/AgoraRefPtr.h>
+#include <AgoraRtcKit/NGIAgoraExtensionControl.h>
+
+#include "AgoraRtcKit/AgoraMediaBase.h"
+#include "AudioParameters.h"
+#include "LoudnessNormalizer.h"
+
+namespace agora {
+    namespace extension {
+        /**
+         * Handle of a remote stream inside RemoteAudioProcessor's stream table.
+         * The generation makes a handle go stale once its slot has been evicted.
+         */
+        struct RemoteAudioStreamHandle {
+            int index = -1;
+            uint32_t generation = 0;
+        };
+
+        /**
+         * Per-speaker loudness normalization for remote audio filters.
+         *
+         * Each remote filter owns one slot of a fixed-size table, so the per-frame
+         * lookup is a direct index and the memory footprint does not grow with the
+         * number of streams. Slots that have not seen a frame for kIdleTimeoutMs are
+         * reclaimed by an incremental sweep (one slot per processed frame); their
+         * filter transparently re-acquires a fresh slot on its next frame. When the
+         * table is full, extra streams pass through unprocessed.
+         */
+        class RemoteAudioProcessor : public RefCountInterface {
+        public:
+            static const int kMaxStreams = 64;
+            static const int64_t kIdleTimeoutMs = 5000;
+
+            // milliseconds on a monotonic clock
+            typedef int64_t (*Clock)();
+
+            // the steady clock unless a test passes its own
+            explicit RemoteAudioProcessor(Clock clock = nullptr);
+
+            bool acquireStream(RemoteAudioStreamHandle& handle);
+
+            void releaseStream(const RemoteAudioStreamHandle& handle);
+
+            int processFrame(RemoteAudioStreamHandle& handle,
+                             const agora::media::base::AudioPcmFrame &audioPcmFrame,
+                             media::base::AudioPcmFrame& adaptedPcmFrame);
+
+            AudioParameterBlock& parameters() { return parameters_; }
+
+            int activeStreamCount() const;
+
+            int setExtensionControl(agora::rtc::IExtensionControl* control){
+                control_ = control;
+                return 0;
+            };
+
+            int setVendorName(const char* id){
+                int len = std::string(id).length() + 1;
+                id_ = static_cast<char *>(malloc(len));
+                memset(id_, 0, len);
+                strcpy(id_, id);
+                return 0;
+            };
+
+            char* getVendorName() {
+                return id_;
+            }
+        protected:
+            ~RemoteAudioProcessor() {}
+        private:
+            enum SLOT_STATE {
+                SLOT_FREE = 0,
+                SLOT_IDLE = 1,
+                SLOT_BUSY = 2,
+            };
+
+            struct StreamSlot {
+                // generation << 2 | SLOT_STATE
+                std::atomic<uint32_t> tag = {0};
+                std::atomic<int64_t> lastActiveMs = {0};
+                LoudnessNormalizer normalizer;
+            };
+
+            static uint32_t makeTag(uint32_t generation, SLOT_STATE state) {
+                return (generation << 2) | state;
+            }
+
+            void resetSlot(StreamSlot& slot);
+            void sweepIdleSlot(int64_t nowMs);
+
+            StreamSlot slots_[kMaxStreams];
+            std::atomic<uint32_t> sweepCursor_ = {0};
+            Clock clock_;
+            AudioParameterBlock parameters_;
+            agora::rtc::IExtensionControl* control_ = nullptr;
+            char* id_ = nullptr;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_REMOTEAUDIOPROCESSOR_H
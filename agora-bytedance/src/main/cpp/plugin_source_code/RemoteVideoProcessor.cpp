@@ -0,0 +1,91 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "RemoteVideoProcessor.h"
+
+#include <algorithm>
+
+#include "error_code.h"
+#include "rapidjson/document.h"
+
+namespace agora {
+    namespace extension {
+        using namespace rapidjson;
+
+        RemoteVideoProcessor::RemoteVideoProcessor(std::shared_ptr<SharedVideoResources> shared)
+                : shared_(std::move(shared)) {
+        }
+
+        int RemoteVideoProcessor::processFrame(VideoEnhancer& stream, const agora::media::base::VideoFrame &frame) {
+            EnhanceParameters params = params_.load();
+            std::shared_ptr<WorkerPool> workers = shared_->workers();
+            stream.process(frame, params, workers.get());
+            return 0;
+        }
+
+        int RemoteVideoProcessor::setParameters(std::string parameter) {
+            Document d;
+            d.Parse(parameter.c_str());
+            if (d.HasParseError()) {
+                return -ERROR_INVALID_JSON;
+            }
+
+            const std::lock_guard<std::mutex> lock(writeMutex_);
+            if (d.HasMember("plugin.bytedance.remoteEnhance")) {
+                Value& enhance = d["plugin.bytedance.remoteEnhance"];
+                if (!enhance.IsObject()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                // applied as a whole or not at all
+                EnhanceParameters params = params_.load();
+                if (enhance.HasMember("enabled")) {
+                    if (!enhance["enabled"].IsBool()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    params.enabled = enhance["enabled"].GetBool();
+                }
+                if (enhance.HasMember("denoise")) {
+                    if (!enhance["denoise"].IsNumber()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    params.denoise = std::max(0.0f, std::min(1.0f, enhance["denoise"].GetFloat()));
+                }
+                if (enhance.HasMember("sharpen")) {
+                    if (!enhance["sharpen"].IsNumber()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    params.sharpen = std::max(0.0f, std::min(2.0f, enhance["sharpen"].GetFloat()));
+                }
+                if (enhance.HasMember("lowLight")) {
+                    if (!enhance["lowLight"].IsNumber()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    params.lowLight = std::max(0.0f, std::min(1.0f, enhance["lowLight"].GetFloat()));
+                }
+                if (enhance.HasMember("minWidth")) {
+                    if (!enhance["minWidth"].IsInt()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    params.minWidth = std::max(0, enhance["minWidth"].GetInt());
+                }
+                if (enhance.HasMember("minHeight")) {
+                    if (!enhance["minHeight"].IsInt()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    params.minHeight = std::max(0, enhance["minHeight"].GetInt());
+                }
+                params_.store(params);
+            }
+
+            if (d.HasMember("plugin.bytedance.analysisThreadCap")) {
+                Value& cap = d["plugin.bytedance.analysisThreadCap"];
+                if (!cap.IsInt()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                shared_->setAnalysisThreadCap(cap.GetInt());
+            }
+            return 0;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_REMOTEVIDEOPROCESSOR_H
+#define AGORAWITHBYTEDANCE_REMOTEVIDEOPROCESSOR_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <AgoraRtcKit/AgoraRefPtr.h>
+
+#include "AgoraRtcKit/AgoraMediaBase.h"
+#include "SeqLock.h"
+#include "SharedVideoResources.h"
+#include "VideoEnhancer.h"
+
+namespace agora {
+    namespace extension {
+        /**
+         * Receive-side enhancement shared by all remote video filters.
+         *
+         * Each filter keeps the state of its own stream in a VideoEnhancer;
+         * the parameters and the worker pool the bands run on are common to
+         * every stream. Parameters are published through a SeqLock, so a
+         * decoding thread never waits on setParameters().
+         */
+        class RemoteVideoProcessor : public RefCountInterface {
+        public:
+            explicit RemoteVideoProcessor(std::shared_ptr<SharedVideoResources> shared);
+
+            int processFrame(VideoEnhancer& stream, const agora::media::base::VideoFrame &frame);
+
+            int setParameters(std::string parameter);
+
+        protected:
+            ~RemoteVideoProcessor() {}
+
+        private:
+            std::shared_ptr<SharedVideoResources> shared_;
+            std::mutex writeMutex_;
+            SeqLock<EnhanceParameters> params_;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_REMOTEVIDEOPROCESSOR_H
@@ -0,0 +1,66 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "RoiTracker.h"
+
+#include <algorithm>
+
+namespace agora {
+    namespace extension {
+        bef_ai_rect RoiTracker::next(int width, int height) {
+            if (width != width_ || height != height_) {
+                width_ = width;
+                height_ = height;
+                tracking_ = false;
+            }
+            if (!tracking_ || fullScanInterval_ <= 1 || ++framesSinceFullScan_ >= fullScanInterval_) {
+                framesSinceFullScan_ = 0;
+                roi_ = {0, 0, width, height};
+            }
+            return roi_;
+        }
+
+        void RoiTracker::update(const bef_ai_rect* boxes, int count) {
+            // an empty region means the track is lost, look everywhere next frame
+            if (count <= 0) {
+                tracking_ = false;
+                return;
+            }
+
+            bef_ai_rect bounds = boxes[0];
+            for (int i = 1; i < count; i++) {
+                bounds.left = std::min(bounds.left, boxes[i].left);
+                bounds.top = std::min(bounds.top, boxes[i].top);
+                bounds.right = std::max(bounds.right, boxes[i].right);
+                bounds.bottom = std::max(bounds.bottom, boxes[i].bottom);
+            }
+            int boxWidth = std::max(1, bounds.right - bounds.left);
+            int boxHeight = std::max(1, bounds.bottom - bounds.top);
+
+            // keep the current region while the boxes stay a quarter box clear of its edges
+            bool isFullFrame = roi_.left == 0 && roi_.top == 0 && roi_.right == width_ && roi_.bottom == height_;
+            if (tracking_ && !isFullFrame &&
+                bounds.left - roi_.left >= boxWidth / 4 && roi_.right - bounds.right >= boxWidth / 4 &&
+                bounds.top - roi_.top >= boxHeight / 4 && roi_.bottom - bounds.bottom >= boxHeight / 4) {
+                return;
+            }
+
+            // pad by the box size on every side: room for a frame or two of motion
+            int padX = std::max(boxWidth, (kMinSide - boxWidth) / 2);
+            int padY = std::max(boxHeight, (kMinSide - boxHeight) / 2);
+            roi_.left = std::max(0, bounds.left - padX);
+            roi_.top = std::max(0, bounds.top - padY);
+            roi_.right = std::min(width_, bounds.right + padX);
+            roi_.bottom = std::min(height_, bounds.bottom + padY);
+            tracking_ = true;
+        }
+
+        void RoiTracker::reset() {
+            tracking_ = false;
+            framesSinceFullScan_ = 0;
+            width_ = 0;
+            height_ = 0;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_ROITRACKER_H
+#define AGORAWITHBYTEDANCE_ROITRACKER_H
+
+#include "../bytedance/bef_effect_ai_public_define.h"
+
+namespace agora {
+    namespace extension {
+        /**
+         * Region of the frame a detector needs to look at.
+         *
+         * While objects are tracked the detector runs on the padded union of
+         * their last boxes instead of the whole frame. The region is kept as
+         * long as the boxes stay clear of its border, so the crop origin (and
+         * with it the detector's own tracking) is stable for most frames. A full
+         * frame scan runs every fullScanInterval frames to find new objects, and
+         * right after a region came back empty.
+         */
+        class RoiTracker {
+        public:
+            // smallest crop side handed to a detector, in pixels
+            static const int kMinSide = 160;
+
+            void setFullScanInterval(int interval) { fullScanInterval_ = interval; }
+
+            // the region to detect in for the coming frame
+            bef_ai_rect next(int width, int height);
+
+            // boxes found in the region returned by next(), in frame coordinates
+            void update(const bef_ai_rect* boxes, int count);
+
+            void reset();
+
+        private:
+            int fullScanInterval_ = 30;
+            int framesSinceFullScan_ = 0;
+            int width_ = 0;
+            int height_ = 0;
+            bool tracking_ = false;
+            bef_ai_rect roi_ = {0, 0, 0, 0};
+        };
+
+        // byte offset of the region's top left pixel in an RGBA image
+        inline int roiOffset(const bef_ai_rect& roi, int stride) {
+            return roi.top * stride + roi.left * 4;
+        }
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_ROITRACKER_H
@@ -0,0 +1,69 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_SEQLOCK_H
+#define AGORAWITHBYTEDANCE_SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace agora {
+    namespace extension {
+        /**
+         * Sequence lock for publishing a small trivially copyable struct to a
+         * real-time reader. load() never blocks and always returns a snapshot that
+         * was published as a whole; it only retries while a store is in flight.
+         * There must be a single writer at a time (callers serialize store()).
+         */
+        template <typename T>
+        class SeqLock {
+            static_assert(std::is_trivially_copyable<T>::value,
+                          "SeqLock payload must be trivially copyable");
+        public:
+            explicit SeqLock(const T& initial = T()) {
+                store(initial);
+            }
+
+            void store(const T& value) {
+                uint32_t words[kWords] = {};
+                memcpy(words, &value, sizeof(T));
+
+                uint32_t seq = seq_.load(std::memory_order_relaxed);
+                seq_.store(seq + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                for (size_t i = 0; i < kWords; i++) {
+                    words_[i].store(words[i], std::memory_order_relaxed);
+                }
+                seq_.store(seq + 2, std::memory_order_release);
+            }
+
+            T load() const {
+                uint32_t words[kWords];
+                uint32_t before, after;
+                do {
+                    before = seq_.load(std::memory_order_acquire);
+                    for (size_t i = 0; i < kWords; i++) {
+                        words[i] = words_[i].load(std::memory_order_relaxed);
+                    }
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    after = seq_.load(std::memory_order_relaxed);
+                } while ((before & 1) != 0 || before != after);
+
+                T value;
+                memcpy(&value, words, sizeof(T));
+                return value;
+            }
+
+        private:
+            static const size_t kWords = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+            std::atomic<uint32_t> seq_ = {0};
+            std::atomic<uint32_t> words_[kWords];
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_SEQLOCK_H
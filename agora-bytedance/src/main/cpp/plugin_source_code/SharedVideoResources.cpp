@@ -0,0 +1,56 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "SharedVideoResources.h"
+
+#include <algorithm>
+
+namespace agora {
+    namespace extension {
+        void SharedVideoResources::setVendor(const std::string& vendor) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            vendor_ = vendor;
+        }
+
+        std::string SharedVideoResources::vendor() const {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            return vendor_;
+        }
+
+        void SharedVideoResources::setHeadSegModel(const void* data, size_t size) {
+            // copied outside the lock, processors only ever see a complete buffer
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            ModelBuffer model = std::make_shared<const std::vector<unsigned char>>(bytes, bytes + size);
+            const std::lock_guard<std::mutex> lock(mutex_);
+            headSegModel_ = model;
+        }
+
+        ModelBuffer SharedVideoResources::headSegModel() const {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            return headSegModel_;
+        }
+
+        void SharedVideoResources::setAnalysisThreadCap(int cap) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (cap != analysisThreadCap_) {
+                analysisThreadCap_ = cap;
+                // rebuilt with the new size on the next frame
+                workers_.reset();
+            }
+        }
+
+        std::shared_ptr<WorkerPool> SharedVideoResources::workers() {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (!workers_) {
+                // leave one big core to the calling thread
+                int threads = analysisThreadCap_;
+                if (threads < 0) {
+                    threads = std::min((int)kAnalysisWorkers, (int)WorkerPool::bigCores().size() - 1);
+                }
+                workers_ = std::make_shared<WorkerPool>(std::max(0, threads), true);
+            }
+            return workers_;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_SHAREDVIDEORESOURCES_H
+#define AGORAWITHBYTEDANCE_SHAREDVIDEORESOURCES_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <AgoraRtcKit/NGIAgoraExtensionControl.h>
+
+#include "WorkerPool.h"
+
+namespace agora {
+    namespace extension {
+        typedef std::shared_ptr<const std::vector<unsigned char>> ModelBuffer;
+
+        /**
+         * What the video filters of one provider have in common.
+         *
+         * Every filter owns its ByteDanceProcessor: frame buffers, detector
+         * handles (they keep tracking state) and parameters are per track, so
+         * tracks run in parallel. Shared here is only what is process wide or
+         * read-only once published: the engine callback, models handed over in
+         * memory and the analysis worker pool.
+         */
+        class SharedVideoResources {
+        public:
+            void setExtensionControl(agora::rtc::IExtensionControl* control) { control_ = control; }
+
+            agora::rtc::IExtensionControl* extensionControl() const { return control_; }
+
+            void setVendor(const std::string& vendor);
+
+            std::string vendor() const;
+
+            // replaces the head segmentation model of every filter
+            void setHeadSegModel(const void* data, size_t size);
+
+            ModelBuffer headSegModel() const;
+
+            // -1 picks a default from the big core count, 0 runs every stage on the caller
+            void setAnalysisThreadCap(int cap);
+
+            // a running frame keeps its pool alive while the cap changes
+            std::shared_ptr<WorkerPool> workers();
+
+        private:
+            static const int kAnalysisWorkers = 2;
+
+            std::atomic<agora::rtc::IExtensionControl*> control_ = {nullptr};
+            mutable std::mutex mutex_;
+            std::string vendor_;
+            ModelBuffer headSegModel_;
+            int analysisThreadCap_ = -1;
+            std::shared_ptr<WorkerPool> workers_;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_SHAREDVIDEORESOURCES_H
@@ -0,0 +1,282 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "TexturePipeline.h"
+
+#include "../logutils.h"
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+#include <GLES3/gl3.h>
+#include <GLES2/gl2ext.h>
+#endif
+
+namespace agora {
+    namespace extension {
+        namespace {
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+            // row 0 of every 2D texture here is the top of the image, as uploaded from CPU memory
+            const char* kOesVertexShader =
+                    "attribute vec2 aPosition;\n"
+                    "uniform mat4 uTransform;\n"
+                    "varying vec2 vTexCoord;\n"
+                    "void main() {\n"
+                    "    vec2 uv = (aPosition + 1.0) * 0.5;\n"
+                    "    vTexCoord = (uTransform * vec4(uv.x, 1.0 - uv.y, 0.0, 1.0)).xy;\n"
+                    "    gl_Position = vec4(aPosition, 0.0, 1.0);\n"
+                    "}\n";
+
+            const char* kOesFragmentShader =
+                    "#extension GL_OES_EGL_image_external : require\n"
+                    "precision mediump float;\n"
+                    "uniform samplerExternalOES uTexture;\n"
+                    "varying vec2 vTexCoord;\n"
+                    "void main() {\n"
+                    "    gl_FragColor = texture2D(uTexture, vTexCoord);\n"
+                    "}\n";
+
+            const GLfloat kQuad[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+
+            const GLfloat kIdentity[] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+            GLuint compileShader(GLenum type, const char* source) {
+                GLuint shader = glCreateShader(type);
+                glShaderSource(shader, 1, &source, nullptr);
+                glCompileShader(shader);
+                GLint compiled = 0;
+                glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+                if (!compiled) {
+                    char log[512] = {0};
+                    glGetShaderInfoLog(shader, sizeof(log) - 1, nullptr, log);
+                    PRINTF_ERROR("TexturePipeline shader compile failed: %s", log);
+                    glDeleteShader(shader);
+                    return 0;
+                }
+                return shader;
+            }
+
+            class GlTextureFrameSource : public TextureFrameSource {
+            public:
+                unsigned int toTexture2D(const TextureFrame& frame) override {
+                    if (frame.type != agora::media::base::VIDEO_TEXTURE_OES) {
+                        return frame.textureId;
+                    }
+                    if (!program_ && !createProgram()) {
+                        return frame.textureId;
+                    }
+                    GLuint target = acquireTexture(frame.width, frame.height);
+
+                    GLint framebuffer = 0;
+                    GLint viewport[4] = {0};
+                    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+                    glGetIntegerv(GL_VIEWPORT, viewport);
+
+                    bindFramebuffer(target);
+                    glViewport(0, 0, frame.width, frame.height);
+                    glUseProgram(program_);
+                    glActiveTexture(GL_TEXTURE0);
+                    glBindTexture(GL_TEXTURE_EXTERNAL_OES, frame.textureId);
+                    glUniform1i(textureLocation_, 0);
+                    glUniformMatrix4fv(transformLocation_, 1, GL_FALSE,
+                                       frame.transform ? frame.transform : kIdentity);
+                    glVertexAttribPointer(positionLocation_, 2, GL_FLOAT, GL_FALSE, 0, kQuad);
+                    glEnableVertexAttribArray(positionLocation_);
+                    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+                    glDisableVertexAttribArray(positionLocation_);
+                    glBindTexture(GL_TEXTURE_EXTERNAL_OES, 0);
+                    glUseProgram(0);
+
+                    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+                    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+                    return target;
+                }
+
+                unsigned int acquireTexture(int width, int height) override {
+                    for (PooledTexture& texture : textures_) {
+                        if (!texture.inUse && texture.width == width && texture.height == height) {
+                            texture.inUse = true;
+                            return texture.name;
+                        }
+                    }
+                    // a size change leaves the old textures unused, drop them first
+                    for (size_t i = 0; i < textures_.size();) {
+                        if (!textures_[i].inUse) {
+                            glDeleteTextures(1, &textures_[i].name);
+                            textures_[i] = textures_.back();
+                            textures_.pop_back();
+                        } else {
+                            i++;
+                        }
+                    }
+                    GLuint name = 0;
+                    glGenTextures(1, &name);
+                    glBindTexture(GL_TEXTURE_2D, name);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+                    glBindTexture(GL_TEXTURE_2D, 0);
+                    textures_.push_back({name, width, height, true});
+                    return name;
+                }
+
+                void recycleTexture(unsigned int texture) override {
+                    for (PooledTexture& pooled : textures_) {
+                        if (pooled.name == texture) {
+                            pooled.inUse = false;
+                            return;
+                        }
+                    }
+                }
+
+                void readPixels(unsigned int texture, int width, int height, uint8_t* rgba) override {
+                    GLint framebuffer = 0;
+                    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+                    bindFramebuffer(texture);
+                    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+                    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+                    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+                }
+
+                void uploadPixels(unsigned int texture, int width, int height, const uint8_t* rgba) override {
+                    glBindTexture(GL_TEXTURE_2D, texture);
+                    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+                    glBindTexture(GL_TEXTURE_2D, 0);
+                }
+
+                void release() override {
+                    for (PooledTexture& texture : textures_) {
+                        glDeleteTextures(1, &texture.name);
+                    }
+                    textures_.clear();
+                    if (framebuffer_) {
+                        glDeleteFramebuffers(1, &framebuffer_);
+                        framebuffer_ = 0;
+                    }
+                    if (program_) {
+                        glDeleteProgram(program_);
+                        program_ = 0;
+                    }
+                }
+
+            private:
+                struct PooledTexture {
+                    GLuint name;
+                    int width;
+                    int height;
+                    bool inUse;
+                };
+
+                bool createProgram() {
+                    GLuint vertex = compileShader(GL_VERTEX_SHADER, kOesVertexShader);
+                    GLuint fragment = compileShader(GL_FRAGMENT_SHADER, kOesFragmentShader);
+                    if (vertex && fragment) {
+                        program_ = glCreateProgram();
+                        glAttachShader(program_, vertex);
+                        glAttachShader(program_, fragment);
+                        glLinkProgram(program_);
+                        GLint linked = 0;
+                        glGetProgramiv(program_, GL_LINK_STATUS, &linked);
+                        if (!linked) {
+                            PRINTF_ERROR("TexturePipeline program link failed");
+                            glDeleteProgram(program_);
+                            program_ = 0;
+                        }
+                    }
+                    // the program keeps them alive as long as it needs them
+                    glDeleteShader(vertex);
+                    glDeleteShader(fragment);
+                    if (!program_) {
+                        return false;
+                    }
+                    positionLocation_ = glGetAttribLocation(program_, "aPosition");
+                    transformLocation_ = glGetUniformLocation(program_, "uTransform");
+                    textureLocation_ = glGetUniformLocation(program_, "uTexture");
+                    return true;
+                }
+
+                void bindFramebuffer(GLuint texture) {
+                    if (!framebuffer_) {
+                        glGenFramebuffers(1, &framebuffer_);
+                    }
+                    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+                    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+                }
+
+                std::vector<PooledTexture> textures_;
+                GLuint framebuffer_ = 0;
+                GLuint program_ = 0;
+                GLint positionLocation_ = 0;
+                GLint transformLocation_ = 0;
+                GLint textureLocation_ = 0;
+            };
+#endif
+        }
+
+        std::unique_ptr<TextureFrameSource> createGlTextureFrameSource() {
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+            return std::unique_ptr<TextureFrameSource>(new GlTextureFrameSource());
+#else
+            return nullptr;
+#endif
+        }
+
+        TEXTURE_ROUTE chooseTextureRoute(const TextureNeeds& needs) {
+            if (needs.cpuWriters) {
+                return TEXTURE_ROUTE_CPU;
+            }
+            if (needs.analysis) {
+                return TEXTURE_ROUTE_GPU_ANALYSIS;
+            }
+            return needs.effect ? TEXTURE_ROUTE_GPU : TEXTURE_ROUTE_PASS_THROUGH;
+        }
+
+        unsigned int TexturePipeline::run(const TextureFrame& frame, const TextureNeeds& needs, const Stages& stages) {
+            reset();
+            route_ = chooseTextureRoute(needs);
+            if (route_ == TEXTURE_ROUTE_PASS_THROUGH || frame.width <= 0 || frame.height <= 0) {
+                return frame.textureId;
+            }
+
+            int width = frame.width;
+            int height = frame.height;
+            unsigned int input = source_->toTexture2D(frame);
+            bool converted = input != frame.textureId;
+            if (route_ != TEXTURE_ROUTE_GPU) {
+                rgba_.resize((size_t)width * height * 4);
+                source_->readPixels(input, width, height, rgba_.data());
+            }
+
+            if (route_ == TEXTURE_ROUTE_CPU) {
+                stages.cpu(rgba_.data(), width, height, false);
+                output_ = converted ? input : source_->acquireTexture(width, height);
+                source_->uploadPixels(output_, width, height, rgba_.data());
+                return output_;
+            }
+
+            // the effect is only queued here, the analyzers below run while the GPU renders it
+            output_ = converted ? input : 0;
+            if (needs.effect) {
+                unsigned int target = source_->acquireTexture(width, height);
+                if (stages.effect(input, target)) {
+                    reset();
+                    output_ = target;
+                } else {
+                    source_->recycleTexture(target);
+                }
+            }
+            if (route_ == TEXTURE_ROUTE_GPU_ANALYSIS) {
+                stages.cpu(rgba_.data(), width, height, true);
+            }
+            return output_ ? output_ : frame.textureId;
+        }
+
+        void TexturePipeline::reset() {
+            if (output_) {
+                source_->recycleTexture(output_);
+                output_ = 0;
+            }
+        }
+    }
+}
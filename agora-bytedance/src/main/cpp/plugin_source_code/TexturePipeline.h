@@ -0,0 +1,115 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_TEXTUREPIPELINE_H
+#define AGORAWITHBYTEDANCE_TEXTUREPIPELINE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "AgoraRtcKit/AgoraMediaBase.h"
+
+namespace agora {
+    namespace extension {
+        // a frame that lives in GPU memory of the caller's GL context
+        struct TextureFrame {
+            unsigned int textureId = 0;
+            // VIDEO_TEXTURE_2D or VIDEO_TEXTURE_OES (camera SurfaceTexture)
+            agora::media::base::VIDEO_PIXEL_FORMAT type = agora::media::base::VIDEO_TEXTURE_2D;
+            int width = 0;
+            int height = 0;
+            int64_t renderTimeMs = 0;
+            // clockwise degrees the picture is rotated by for display, as VideoFrame::rotation
+            int rotation = 0;
+            // column-major SurfaceTexture transform of an OES frame, null for identity
+            const float* transform = nullptr;
+        };
+
+        enum TEXTURE_ROUTE {
+            // nothing enabled, the input texture is the output
+            TEXTURE_ROUTE_PASS_THROUGH = 0,
+            // effect from texture to texture, no pixel touches CPU memory
+            TEXTURE_ROUTE_GPU = 1,
+            // effect on the GPU, one RGBA copy for the analyzers
+            TEXTURE_ROUTE_GPU_ANALYSIS = 2,
+            // a stage writes pixels on the CPU: read back, run the frame pipeline, upload
+            TEXTURE_ROUTE_CPU = 3,
+        };
+
+        struct TextureNeeds {
+            bool effect = false;
+            // analyzers reading RGBA pixels
+            bool analysis = false;
+            // stages writing the frame on the CPU (virtual background, beauty on enrolled faces)
+            bool cpuWriters = false;
+        };
+
+        TEXTURE_ROUTE chooseTextureRoute(const TextureNeeds& needs);
+
+        /**
+         * GL side of a texture frame, a stub on a desktop build. Calls are made
+         * on the caller's thread with its context current; textures handed out
+         * are GL_TEXTURE_2D RGBA of the requested size.
+         */
+        class TextureFrameSource {
+        public:
+            virtual ~TextureFrameSource() {}
+
+            // a 2D texture is returned as is, an OES one is drawn into an acquired texture
+            virtual unsigned int toTexture2D(const TextureFrame& frame) = 0;
+
+            virtual unsigned int acquireTexture(int width, int height) = 0;
+
+            virtual void recycleTexture(unsigned int texture) = 0;
+
+            virtual void readPixels(unsigned int texture, int width, int height, uint8_t* rgba) = 0;
+
+            virtual void uploadPixels(unsigned int texture, int width, int height, const uint8_t* rgba) = 0;
+
+            // deletes every GL object, on the thread that created them
+            virtual void release() = 0;
+        };
+
+        // GLES implementation, null off Android
+        std::unique_ptr<TextureFrameSource> createGlTextureFrameSource();
+
+        /**
+         * Texture-in/texture-out processing of one frame.
+         *
+         * The route is picked per frame from what is enabled: the beauty effect
+         * alone never leaves the GPU, analyzers get a single RGBA readback that
+         * they work on while the GPU renders the effect, and only stages that
+         * write CPU pixels make the frame take the full round trip. The output
+         * texture belongs to the pipeline until the next run().
+         */
+        class TexturePipeline {
+        public:
+            struct Stages {
+                // renders the effect from source into target, false leaves target untouched
+                std::function<bool(unsigned int source, unsigned int target)> effect;
+                // the CPU frame pipeline on a tightly packed RGBA copy, written back unless analysisOnly
+                std::function<void(uint8_t* rgba, int width, int height, bool analysisOnly)> cpu;
+            };
+
+            explicit TexturePipeline(TextureFrameSource* source) : source_(source) {}
+
+            unsigned int run(const TextureFrame& frame, const TextureNeeds& needs, const Stages& stages);
+
+            TEXTURE_ROUTE lastRoute() const { return route_; }
+
+            // hands the last output back to the source
+            void reset();
+
+        private:
+            TextureFrameSource* source_;
+            TEXTURE_ROUTE route_ = TEXTURE_ROUTE_PASS_THROUGH;
+            unsigned int output_ = 0;
+            std::vector<uint8_t> rgba_;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_TEXTUREPIPELINE_H
@@ -0,0 +1,120 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "TrackSmoother.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace agora {
+    namespace extension {
+        namespace {
+            const float kPi = 3.14159265f;
+            // used when two updates carry the same timestamp
+            const float kFallbackDtSec = 1.0f / 30;
+
+            float smoothingFactor(float cutoff, float dtSec) {
+                float tau = 1.0f / (2 * kPi * cutoff);
+                return 1.0f / (1.0f + tau / dtSec);
+            }
+        }
+
+        float OneEuroFilter::filter(float value, float dtSec, const OneEuroParams& params) {
+            if (!initialized_) {
+                initialized_ = true;
+                value_ = value;
+                speed_ = 0;
+                return value;
+            }
+            float speed = (value - value_) / dtSec;
+            speed_ += smoothingFactor(params.derivativeCutoff, dtSec) * (speed - speed_);
+            float cutoff = params.minCutoff + params.beta * std::fabs(speed_);
+            value_ += smoothingFactor(cutoff, dtSec) * (value - value_);
+            return value_;
+        }
+
+        TrackSmoother::TrackSmoother(int valueCount, int heldCount)
+                : valueCount_(std::min(valueCount, (int)kMaxValues)),
+                  heldCount_(std::min(heldCount, (int)kMaxHeld)) {
+        }
+
+        TrackSmoother::Track* TrackSmoother::find(int id) {
+            for (int i = 0; i < kMaxTracks; i++) {
+                if (tracks_[i].used && tracks_[i].sample.id == id) {
+                    return &tracks_[i];
+                }
+            }
+            return nullptr;
+        }
+
+        void TrackSmoother::update(int64_t timestampMs, Sample* samples, int count) {
+            bool seen[kMaxTracks] = {false};
+            for (int s = 0; s < count; s++) {
+                Sample& sample = samples[s];
+                Track* track = find(sample.id);
+                if (!track) {
+                    for (int i = 0; i < kMaxTracks && !track; i++) {
+                        if (!tracks_[i].used) {
+                            track = &tracks_[i];
+                            track->used = true;
+                            for (int v = 0; v < valueCount_; v++) {
+                                track->filters[v].reset();
+                            }
+                        }
+                    }
+                    // more objects than tracks: the rest goes out unsmoothed
+                    if (!track) {
+                        continue;
+                    }
+                } else if (seen[track - tracks_]) {
+                    // duplicate id in one update, keep the first
+                    continue;
+                }
+                seen[track - tracks_] = true;
+
+                float dtSec = (timestampMs - track->lastMs) / 1000.0f;
+                if (dtSec <= 0) {
+                    dtSec = kFallbackDtSec;
+                }
+                for (int v = 0; v < valueCount_; v++) {
+                    sample.values[v] = track->filters[v].filter(sample.values[v], dtSec, params_);
+                }
+                track->sample = sample;
+                track->lastMs = timestampMs;
+            }
+
+            for (int i = 0; i < kMaxTracks; i++) {
+                if (!seen[i]) {
+                    tracks_[i].used = false;
+                }
+            }
+        }
+
+        int TrackSmoother::predict(int64_t timestampMs, Sample* samples, int capacity) const {
+            int count = 0;
+            for (int i = 0; i < kMaxTracks && count < capacity; i++) {
+                const Track& track = tracks_[i];
+                if (!track.used) {
+                    continue;
+                }
+                int64_t aheadMs = std::max((int64_t)0, std::min(timestampMs - track.lastMs, (int64_t)kMaxPredictionMs));
+                Sample& sample = samples[count++];
+                sample.id = track.sample.id;
+                for (int v = 0; v < valueCount_; v++) {
+                    sample.values[v] = track.filters[v].predict(aheadMs / 1000.0f);
+                }
+                for (int h = 0; h < heldCount_; h++) {
+                    sample.held[h] = track.sample.held[h];
+                }
+            }
+            return count;
+        }
+
+        void TrackSmoother::clear() {
+            for (int i = 0; i < kMaxTracks; i++) {
+                tracks_[i].used = false;
+            }
+        }
+    }
+}
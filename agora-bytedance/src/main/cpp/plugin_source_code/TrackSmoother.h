@@ -0,0 +1,91 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_TRACKSMOOTHER_H
+#define AGORAWITHBYTEDANCE_TRACKSMOOTHER_H
+
+#include <cstdint>
+
+namespace agora {
+    namespace extension {
+        struct OneEuroParams {
+            // cutoff in Hz at rest; lower removes more jitter but adds lag
+            float minCutoff = 1.0f;
+            // cutoff increase per unit/s of speed; higher follows fast motion closer
+            float beta = 0.1f;
+            float derivativeCutoff = 1.0f;
+        };
+
+        /**
+         * One Euro filter of a single value: a low-pass filter whose cutoff rises
+         * with the speed of the signal. The filtered speed is kept, so the value
+         * can be extrapolated to frames the detector did not run on.
+         */
+        class OneEuroFilter {
+        public:
+            float filter(float value, float dtSec, const OneEuroParams& params);
+
+            float predict(float aheadSec) const { return value_ + speed_ * aheadSec; }
+
+            void reset() { initialized_ = false; }
+
+        private:
+            bool initialized_ = false;
+            float value_ = 0;
+            float speed_ = 0;
+        };
+
+        /**
+         * Smoothed results of one detector, one track per detector id.
+         *
+         * A sample holds the values to smooth (angles, box corners, ...) and
+         * values that are only carried along (action, expression, ...). Tracks
+         * that are missing from an update are dropped, tracks live in a fixed
+         * array, nothing is allocated.
+         */
+        class TrackSmoother {
+        public:
+            static const int kMaxTracks = 16;
+            static const int kMaxValues = 8;
+            static const int kMaxHeld = 4;
+            // extrapolation stops this long after the last detection
+            static const int64_t kMaxPredictionMs = 500;
+
+            struct Sample {
+                int id;
+                float values[kMaxValues];
+                float held[kMaxHeld];
+            };
+
+            TrackSmoother(int valueCount, int heldCount);
+
+            void setParams(const OneEuroParams& params) { params_ = params; }
+
+            // smooths the values of every sample in place
+            void update(int64_t timestampMs, Sample* samples, int count);
+
+            // the tracks extrapolated to timestampMs, returns the sample count
+            int predict(int64_t timestampMs, Sample* samples, int capacity) const;
+
+            void clear();
+
+        private:
+            struct Track {
+                bool used = false;
+                int64_t lastMs = 0;
+                Sample sample;
+                OneEuroFilter filters[kMaxValues];
+            };
+
+            Track* find(int id);
+
+            int valueCount_;
+            int heldCount_;
+            OneEuroParams params_;
+            Track tracks_[kMaxTracks];
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_TRACKSMOOTHER_H
@@ -0,0 +1,185 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "VideoEnhancer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <AgoraRtcKit/AgoraRefCountedObject.h>
+
+namespace agora {
+    namespace extension {
+        namespace {
+            // frames darker than this average luma get lifted
+            const float kDarkLuma = 90.0f;
+            const float kTargetLuma = 120.0f;
+            // the largest frame difference the denoiser still treats as noise
+            const int kMaxDenoiseRange = 16;
+            // every n-th pixel of every n-th row feeds the brightness estimate
+            const int kLumaSampleStep = 8;
+
+            uint8_t clampPixel(int v) {
+                return (uint8_t)std::min(255, std::max(0, v));
+            }
+        }
+
+        VideoEnhancer::VideoEnhancer() : job_(new RefCountedObject<Job>()) {
+        }
+
+        void VideoEnhancer::reset() {
+            hasPrevious_ = false;
+            meanLuma_ = -1;
+        }
+
+        void VideoEnhancer::prepareTables(const EnhanceParameters& params) {
+            Job& job = *job_.get();
+
+            float gamma = 1.0f;
+            if (params.lowLight > 0 && meanLuma_ < kDarkLuma) {
+                float mean = std::max(8.0f, meanLuma_);
+                float target = mean + (kTargetLuma - mean) * std::min(1.0f, params.lowLight);
+                gamma = std::log(target / 255.0f) / std::log(mean / 255.0f);
+            }
+            for (int v = 0; v < 256; v++) {
+                job.lut[v] = gamma == 1.0f ? (uint8_t)v
+                                           : clampPixel((int)(255.0f * std::pow(v / 255.0f, gamma) + 0.5f));
+            }
+
+            job.sharpen = (int)(std::max(0.0f, std::min(2.0f, params.sharpen)) * 4096 / 9 + 0.5f);
+
+            // small differences are pulled towards the previous output, motion passes through
+            float strength = std::max(0.0f, std::min(1.0f, params.denoise));
+            int range = (int)(kMaxDenoiseRange * strength);
+            for (int d = 0; d < 256; d++) {
+                job.denoiseGain[d] = d < range ? (uint16_t)(256 - (int)(256 * strength * (range - d) / range))
+                                               : 256;
+            }
+        }
+
+        bool VideoEnhancer::process(const agora::media::base::VideoFrame& frame, const EnhanceParameters& params,
+                                    WorkerPool* pool) {
+            if (!params.enabled || frame.type != agora::media::base::VIDEO_PIXEL_I420 || !frame.yBuffer ||
+                frame.width * frame.height < params.minWidth * params.minHeight) {
+                reset();
+                return false;
+            }
+
+            int width = frame.width;
+            int height = frame.height;
+            if (width != width_ || height != height_) {
+                width_ = width;
+                height_ = height;
+                output_.assign(width * height, 0);
+                previous_.assign(width * height, 0);
+                reset();
+            }
+
+            long lumaSum = 0;
+            int samples = 0;
+            for (int y = 0; y < height; y += kLumaSampleStep) {
+                const uint8_t* row = frame.yBuffer + y * frame.yStride;
+                for (int x = 0; x < width; x += kLumaSampleStep) {
+                    lumaSum += row[x];
+                    samples++;
+                }
+            }
+            float mean = (float)lumaSum / samples;
+            meanLuma_ = meanLuma_ < 0 ? mean : meanLuma_ * 0.9f + mean * 0.1f;
+            prepareTables(params);
+
+            Job& job = *job_.get();
+            int bandCount = (height + kBandRows - 1) / kBandRows;
+            job.src = frame.yBuffer;
+            job.srcStride = frame.yStride;
+            job.dst = output_.data();
+            job.prev = previous_.data();
+            job.width = width;
+            job.height = height;
+            job.hasPrev = hasPrevious_;
+            job.lit.resize((size_t)bandCount * (kBandRows + 2) * width);
+            job.sums.resize((size_t)bandCount * width);
+            job.done = 0;
+
+            uint32_t generation = ++generation_;
+            job.ticket.store(((uint64_t)generation << 32) | ((uint64_t)bandCount << 16), std::memory_order_release);
+            int helpers = pool ? std::min(pool->size(), bandCount - 1) : 0;
+            for (int i = 0; i < helpers; i++) {
+                agora_refptr<Job> shared = job_;
+                pool->submit([shared, generation] { shared->runBands(generation); });
+            }
+            job.runBands(generation);
+            {
+                std::unique_lock<std::mutex> lock(job.mutex);
+                job.finished.wait(lock, [&job, bandCount] { return job.done.load() == bandCount; });
+            }
+
+            for (int y = 0; y < height; y++) {
+                memcpy(frame.yBuffer + y * frame.yStride, output_.data() + y * width, width);
+            }
+            output_.swap(previous_);
+            hasPrevious_ = true;
+            return true;
+        }
+
+        void VideoEnhancer::Job::runBands(uint32_t generation) {
+            for (;;) {
+                uint64_t ticketValue = ticket.load(std::memory_order_acquire);
+                int count = (int)((ticketValue >> 16) & 0xffff);
+                int band = (int)(ticketValue & 0xffff);
+                // a task left over from an earlier frame finds another generation
+                if ((uint32_t)(ticketValue >> 32) != generation || band >= count) {
+                    return;
+                }
+                if (!ticket.compare_exchange_weak(ticketValue, ticketValue + 1, std::memory_order_acq_rel)) {
+                    continue;
+                }
+                runBand(band);
+                if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished.notify_all();
+                }
+            }
+        }
+
+        void VideoEnhancer::Job::runBand(int band) {
+            int top = band * kBandRows;
+            int bottom = std::min(height, top + kBandRows);
+            uint8_t* lifted = lit.data() + (size_t)band * (kBandRows + 2) * width;
+            uint16_t* columns = sums.data() + (size_t)band * width;
+
+            // the band's rows plus one above and below, edges repeated
+            for (int y = top - 1; y <= bottom; y++) {
+                const uint8_t* in = src + std::min(height - 1, std::max(0, y)) * srcStride;
+                uint8_t* out = lifted + (y - top + 1) * width;
+                for (int x = 0; x < width; x++) {
+                    out[x] = lut[in[x]];
+                }
+            }
+
+            for (int y = top; y < bottom; y++) {
+                const uint8_t* up = lifted + (y - top) * width;
+                const uint8_t* mid = up + width;
+                const uint8_t* down = mid + width;
+                for (int x = 0; x < width; x++) {
+                    columns[x] = up[x] + mid[x] + down[x];
+                }
+
+                uint8_t* out = dst + y * width;
+                const uint8_t* last = prev + y * width;
+                for (int x = 0; x < width; x++) {
+                    int box = columns[std::max(0, x - 1)] + columns[x] + columns[std::min(width - 1, x + 1)];
+                    int v = mid[x] + (((9 * mid[x] - box) * sharpen) >> 12);
+                    v = std::min(255, std::max(0, v));
+                    if (hasPrev) {
+                        int diff = v - last[x];
+                        v = last[x] + ((diff * denoiseGain[std::abs(diff)]) >> 8);
+                    }
+                    out[x] = (uint8_t)v;
+                }
+            }
+        }
+    }
+}
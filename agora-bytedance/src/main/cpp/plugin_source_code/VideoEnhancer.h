@@ -0,0 +1,102 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_VIDEOENHANCER_H
+#define AGORAWITHBYTEDANCE_VIDEOENHANCER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <AgoraRtcKit/AgoraRefPtr.h>
+
+#include "AgoraRtcKit/AgoraMediaBase.h"
+#include "WorkerPool.h"
+
+namespace agora {
+    namespace extension {
+        struct EnhanceParameters {
+            bool enabled = true;
+            // temporal denoise strength, 0 - 1
+            float denoise = 0.5f;
+            // unsharp mask amount, 0 - 2
+            float sharpen = 0.3f;
+            // how far a dark frame is lifted towards normal brightness, 0 - 1
+            float lowLight = 0.6f;
+            // smaller frames (thumbnails) pass through untouched
+            int minWidth = 320;
+            int minHeight = 180;
+        };
+
+        /**
+         * Lightweight enhancement of one decoded I420 stream: low-light lift,
+         * unsharp mask and motion adaptive temporal denoise, all on the luma
+         * plane in a single pass.
+         *
+         * The frame is cut into row bands. The calling thread and the pool's
+         * workers take bands until none is left, so one stream can use several
+         * cores while many streams share the same few threads. The only state
+         * kept between frames is the previous output, used by the denoiser.
+         */
+        class VideoEnhancer {
+        public:
+            static const int kBandRows = 32;
+
+            VideoEnhancer();
+
+            // false when the frame was passed through unchanged
+            bool process(const agora::media::base::VideoFrame& frame, const EnhanceParameters& params,
+                         WorkerPool* pool);
+
+            void reset();
+
+        private:
+            // everything a band needs; bands may run on pool threads after the stream is gone
+            class Job : public RefCountInterface {
+            public:
+                // generation << 32 | band count << 16 | next band
+                std::atomic<uint64_t> ticket = {0};
+                std::atomic<int> done = {0};
+                std::mutex mutex;
+                std::condition_variable finished;
+
+                const uint8_t* src = nullptr;
+                int srcStride = 0;
+                // output and previous output are packed, stride == width
+                uint8_t* dst = nullptr;
+                const uint8_t* prev = nullptr;
+                int width = 0;
+                int height = 0;
+                bool hasPrev = false;
+                // unsharp mask amount in Q12, divided by the 9 pixels of the box
+                int sharpen = 0;
+                // low-light curve, applied before everything else
+                uint8_t lut[256];
+                // Q8 weight of the new value by its distance to the previous output
+                uint16_t denoiseGain[256];
+                // kBandRows + 2 lifted rows and one row of vertical sums per band
+                std::vector<uint8_t> lit;
+                std::vector<uint16_t> sums;
+
+                void runBands(uint32_t generation);
+
+                void runBand(int band);
+            };
+
+            void prepareTables(const EnhanceParameters& params);
+
+            agora_refptr<Job> job_;
+            uint32_t generation_ = 0;
+            std::vector<uint8_t> output_;
+            std::vector<uint8_t> previous_;
+            bool hasPrevious_ = false;
+            int width_ = 0;
+            int height_ = 0;
+            float meanLuma_ = -1;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_VIDEOENHANCER_H
@@ -6,7 +6,8 @@
 
 #include "VideoProcessor.h"
 
-#include <chrono>
+#include <algorithm>
+#include <cmath>
 
 
 #include "../logutils.h"
@@ -16,47 +17,134 @@
 
 #include "../bytedance/bef_effect_ai_yuv_process.h"
 #include "error_code.h"
+#include "ActivityBus.h"
+#include "LicenseCache.h"
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+#include <GLES3/gl3.h>
+#endif
 
 #define CHECK_BEF_AI_RET_SUCCESS(ret, ...) \
 if(ret != 0){\
     PRINTF_ERROR(__VA_ARGS__);\
 }
 
+// every handle is authorized on its own, the env is the thread's cached one, see LicenseCache
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+#define CHECK_LICENSE(ret, checkLicense, handle) \
+ret = LicenseCache::getInstance().check(#checkLicense, licensePath_, [&] {\
+    return checkLicense(JniHelper::getJniHelper()->attachCurrentThread(),\
+                        reinterpret_cast<jobject>(AndroidContextHelper::getContext()), handle,\
+                        licensePath_.c_str());\
+})
+#elif defined __APPLE__
+#define CHECK_LICENSE(ret, checkLicense, handle) \
+ret = LicenseCache::getInstance().check(#checkLicense, licensePath_, [&] {\
+    return checkLicense(handle, licensePath_.c_str());\
+})
+#else
+#define CHECK_LICENSE(ret, checkLicense, handle)
+#endif
+
 namespace agora {
     namespace extension {
         using namespace rapidjson;
-        bool ByteDanceProcessor::initOpenGL() {
-            const std::lock_guard<std::mutex> lock(mutex_);
 
-#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
-            if (!eglCore_) {
-                eglCore_ = new EglCore();
-                offscreenSurface_ = eglCore_->createOffscreenSurface(640, 320);
+        namespace {
+            // JSON of an event, one per thread since stages emit in parallel; kept
+            // between frames so emitting does not allocate once the buffers have grown
+            struct EventJson {
+                rapidjson::StringBuffer buffer;
+                rapidjson::Writer<rapidjson::StringBuffer> writer;
+
+                static EventJson& begin() {
+                    static thread_local EventJson event;
+                    event.buffer.Clear();
+                    event.writer.Reset(event.buffer);
+                    event.writer.SetMaxDecimalPlaces(rapidjson::Writer<rapidjson::StringBuffer>::kDefaultMaxDecimalPlaces);
+                    return event;
+                }
+            };
+
+            // copy src over dst inside [left, right) x [top, bottom), fading in over `feather` pixels
+            void blendRegion(uint8_t* dst, int dstStride, const uint8_t* src, int srcStride,
+                             int left, int top, int right, int bottom, int feather) {
+                feather = std::max(1, feather);
+                for (int y = top; y < bottom; y++) {
+                    int wy = std::min(y - top + 1, bottom - y);
+                    uint8_t* d = dst + y * dstStride;
+                    const uint8_t* s = src + y * srcStride;
+                    for (int x = left; x < right; x++) {
+                        int w = std::min(wy, std::min(x - left + 1, right - x));
+                        if (w >= feather) {
+                            d[x] = s[x];
+                        } else {
+                            d[x] = (uint8_t)((s[x] * w + d[x] * (feather - w)) / feather);
+                        }
+                    }
+                }
+            }
+        }
 
+        ByteDanceProcessor::ByteDanceProcessor(std::shared_ptr<SharedVideoResources> shared)
+                : shared_(std::move(shared)), vendor_(shared_->vendor()) {
+        }
 
+        ByteDanceProcessor::~ByteDanceProcessor() {
+            if (texturePipeline_ && std::this_thread::get_id() == textureThread_) {
+                releaseTextureResources();
             }
-            if  (!eglCore_->isCurrent(offscreenSurface_)) {
-                eglCore_->makeCurrent(offscreenSurface_);
+            GlContextManager& manager = GlContextManager::getInstance();
+            if (manager.isOwner(glContext_)) {
+                releaseGlOnOwner();
+            } else {
+                // the effect handle's GL objects go with the context
+                if (readback_) {
+                    readback_->detach();
+                }
+                manager.release(glContext_);
             }
-#endif
-            return true;
+            // every filter has its own processor, its handles and buffers go with it
+            releaseEffectEngine();
         }
 
         bool ByteDanceProcessor::releaseOpenGL() {
             const std::lock_guard<std::mutex> lock(mutex_);
-
-#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
-            if (eglCore_) {
-                if (offscreenSurface_) {
-                    eglCore_->releaseSurface(offscreenSurface_);
+            if (texturePipeline_) {
+                if (std::this_thread::get_id() == textureThread_) {
+                    releaseTextureResources();
+                } else {
+                    // its objects stay in the caller's context until that context goes
+                    PRINTF_INFO("ByteDanceProcessor texture path released off its GL thread");
+                    texturePipeline_.reset();
+                    textureSource_.reset();
                 }
-                delete eglCore_;
-                eglCore_ = nullptr;
             }
-#endif
+            if (!glContext_) {
+                return true;
+            }
+            if (GlContextManager::getInstance().isOwner(glContext_)) {
+                releaseGlOnOwner();
+            } else {
+                glReleasePending_ = true;
+            }
             return true;
         }
 
+        void ByteDanceProcessor::releaseGlOnOwner() {
+            // the effect handle owns GL objects, destroy it while its context is current
+            if (byteEffectHandler_) {
+                bef_effect_ai_destroy(byteEffectHandler_);
+                byteEffectHandler_ = nullptr;
+                aiEffectNeedUpdate_ = true;
+            }
+            // hands its buffers back to the pool before the context goes
+            readback_.reset();
+            readbackContext_ = nullptr;
+            GlContextManager::getInstance().release(glContext_);
+            glContext_ = nullptr;
+            glReleasePending_ = false;
+        }
+
         void ByteDanceProcessor::prepareCachedVideoFrame(const agora::media::base::VideoFrame &capturedFrame) {
             int ysize = capturedFrame.yStride * capturedFrame.height;
             int usize = capturedFrame.uStride * capturedFrame.height / 2;
@@ -86,30 +174,27 @@ namespace agora {
             memcpy(yuvBuffer_ + ysize + usize, capturedFrame.vBuffer, vsize);
 
             // update RGBA buffer
-            cvt_yuv2rgba(yuvBuffer_, rgbaBuffer_, BEF_AI_PIX_FMT_YUV420P, capturedFrame.width,
-                         capturedFrame.height, capturedFrame.width, capturedFrame.height,
-                         BEF_AI_CLOCKWISE_ROTATE_0,
-                         false);
+            if (textureRgba_) {
+                memcpy(rgbaBuffer_, textureRgba_, capturedFrame.yStride * capturedFrame.height * 4);
+            } else {
+                // kept as captured, the detectors are told the rotation instead
+                cvt_yuv2rgba(yuvBuffer_, rgbaBuffer_, BEF_AI_PIX_FMT_YUV420P, capturedFrame.yStride,
+                             capturedFrame.height, capturedFrame.yStride, capturedFrame.height,
+                             BEF_AI_CLOCKWISE_ROTATE_0,
+                             false);
+            }
             prevFrame_ = capturedFrame;
 
         }
 
-        void ByteDanceProcessor::processEffect(const agora::media::base::VideoFrame &capturedFrame) {
+        void ByteDanceProcessor::prepareEffect(int width, int height) {
             if (!byteEffectHandler_) {
                 bef_effect_result_t ret;
                 ret = bef_effect_ai_create(&byteEffectHandler_);
                 CHECK_BEF_AI_RET_SUCCESS(ret,
                                          "ByteDanceProcessor::processEffect create effect handle failed ! %d",
                                          ret);
-#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
-                void *context = AndroidContextHelper::getContext();
-                ret = bef_effect_ai_check_license(
-                        JniHelper::getJniHelper()->attachCurrentThread(),
-                        reinterpret_cast<jobject>(context), byteEffectHandler_,
-                        licensePath_.c_str());
-#elif defined __APPLE__
-                ret = bef_effect_ai_check_license(byteEffectHandler_, licensePath_.c_str());
-#endif
+                CHECK_LICENSE(ret, bef_effect_ai_check_license, byteEffectHandler_);
                 CHECK_BEF_AI_RET_SUCCESS(ret,
                                          "ByteDanceProcessor::processEffect check license failed, %d path: %s",
                                          ret, licensePath_.c_str());
@@ -154,10 +239,8 @@ namespace agora {
                 aiEffectNeedUpdate_ = false;
             }
 
-            uint64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::system_clock::now().time_since_epoch()).count();
-            bef_effect_ai_set_width_height(byteEffectHandler_, capturedFrame.width,
-                                           capturedFrame.height);
+            bef_effect_ai_set_width_height(byteEffectHandler_, width, height);
+            bef_effect_ai_set_orientation(byteEffectHandler_, orientation_.rotateType());
 
             bef_effect_result_t ret;
             if (faceStickerEnabled_) {
@@ -171,7 +254,18 @@ namespace agora {
                                          "ByteDanceProcessor::updateEffect clear sticker effect failed %d",
                                          ret);
             }
+        }
+
+        void ByteDanceProcessor::processEffect(const agora::media::base::VideoFrame &capturedFrame) {
+            prepareEffect(capturedFrame.width, capturedFrame.height);
+            double timestamp = frameTimestampMs_;
+
+            if (gpuReadbackEnabled_ && glContext_) {
+                processEffectOnGpu(capturedFrame, timestamp);
+                return;
+            }
 
+            bef_effect_result_t ret;
             ret = bef_effect_ai_algorithm_buffer(byteEffectHandler_, rgbaBuffer_,
                                                  BEF_AI_PIX_FMT_RGBA8888, capturedFrame.width,
                                                  capturedFrame.height, capturedFrame.yStride * 4,
@@ -190,34 +284,145 @@ namespace agora {
             cvt_rgba2yuv(rgbaBuffer_, yuvBuffer_, BEF_AI_PIX_FMT_YUV420P, capturedFrame.yStride,
                          capturedFrame.height);
 
+            writeBackEffect(capturedFrame);
+        }
+
+        void ByteDanceProcessor::processEffectOnGpu(const agora::media::base::VideoFrame &capturedFrame,
+                                                    double timestamp) {
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+            GlContextManager& manager = GlContextManager::getInstance();
+            if (!readback_) {
+                std::unique_ptr<ReadbackBackend> backend = createGlReadbackBackend(glContext_);
+                if (!backend) {
+                    return;
+                }
+                readback_.reset(new ReadbackRing(std::move(backend)));
+                readbackContext_ = glContext_;
+            }
+            // The background stage composites this frame's mask, and beauty on
+            // enrolled faces blends this frame's face boxes, into whatever frame
+            // the ring hands back, so with either on it has to be this one.
+            readback_->setDepth(background_.mode() != BACKGROUND_NONE || beautyEnrolledOnly_ ? 1 : gpuReadbackDepth_);
+
+            int width = capturedFrame.yStride;
+            int height = capturedFrame.height;
+            GLuint source = manager.acquire(glContext_, {GL_OBJECT_TEXTURE, width, height, GL_RGBA8});
+            GLuint target = manager.acquire(glContext_, {GL_OBJECT_TEXTURE, width, height, GL_RGBA8});
+            GLuint framebuffer = manager.acquire(glContext_, {GL_OBJECT_FRAMEBUFFER, 0, 0, 0});
+
+            glBindTexture(GL_TEXTURE_2D, source);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgbaBuffer_);
+            glBindTexture(GL_TEXTURE_2D, 0);
+
+            bef_effect_result_t ret = bef_effect_ai_algorithm_texture(byteEffectHandler_, source, timestamp);
+            CHECK_BEF_AI_RET_SUCCESS(ret,
+                                     "ByteDanceProcessor::processEffectOnGpu ai algorithm texture failed %d",
+                                     ret);
+            ret = bef_effect_ai_process_texture(byteEffectHandler_, source, target, timestamp);
+            CHECK_BEF_AI_RET_SUCCESS(ret,
+                                     "ByteDanceProcessor::processEffectOnGpu ai process texture failed %d",
+                                     ret);
+
+            // the readback is only queued, the GPU catches up while the next frames are analyzed
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+            readback_->submit(framebuffer, width, height, capturedFrame.renderTimeMs);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+            // commands on one context run in order, the next frame may draw into them again
+            manager.recycle(glContext_, GL_OBJECT_FRAMEBUFFER, framebuffer);
+            manager.recycle(glContext_, GL_OBJECT_TEXTURE, target);
+            manager.recycle(glContext_, GL_OBJECT_TEXTURE, source);
+
+            // a lowered depth drops the surplus frames once
+            while (readback_->pending() > readback_->depth()) {
+                readback_->releaseOldest();
+            }
+            if (readback_->pending() < readback_->depth()) {
+                hasOutput_ = false;
+                return;
+            }
+
+            ReadbackFrame frame;
+            // a frame of another size was in flight across a resolution change
+            if (!readback_->acquireOldest(frame) || frame.width != width || frame.height != height) {
+                readback_->releaseOldest();
+                hasOutput_ = false;
+                return;
+            }
+            cvt_rgba2yuv(frame.pixels, yuvBuffer_, BEF_AI_PIX_FMT_YUV420P, width, height);
+            readback_->releaseOldest();
+            outputTimestampMs_ = frame.timestampMs;
+            writeBackEffect(capturedFrame);
+#else
+            // no GL context outside Android, processEffect() never gets here
+            (void)capturedFrame;
+            (void)timestamp;
+#endif
+        }
+
+        void ByteDanceProcessor::dropReadback() {
+            if (readback_ && readback_->pending() > 0 && GlContextManager::getInstance().isOwner(readbackContext_)) {
+                readback_->clear();
+            }
+        }
+
+        void ByteDanceProcessor::writeBackEffect(const agora::media::base::VideoFrame &capturedFrame) {
             int ysize = capturedFrame.yStride * capturedFrame.height;
             int usize = capturedFrame.uStride * capturedFrame.height / 2;
             int vsize = capturedFrame.vStride * capturedFrame.height / 2;
-            memcpy(capturedFrame.yBuffer, yuvBuffer_, ysize);
-            memcpy(capturedFrame.uBuffer, yuvBuffer_ + ysize, usize);
-            memcpy(capturedFrame.vBuffer, yuvBuffer_ + ysize + usize, vsize);
+            if (!beautyEnrolledOnly_) {
+                memcpy(capturedFrame.yBuffer, yuvBuffer_, ysize);
+                memcpy(capturedFrame.uBuffer, yuvBuffer_ + ysize, usize);
+                memcpy(capturedFrame.vBuffer, yuvBuffer_ + ysize + usize, vsize);
+                return;
+            }
+
+            // only the (padded) face boxes of enrolled people take the effect
+            for (const FaceIdentity &identity : faceIdentities_) {
+                if (identity.galleryIndex < 0) {
+                    continue;
+                }
+                for (int i = 0; i < analysis_.faceInfo.face_count; i++) {
+                    const bef_ai_face_106 &face = analysis_.faceInfo.base_infos[i];
+                    if (face.ID != identity.faceId) {
+                        continue;
+                    }
+                    int padX = (face.rect.right - face.rect.left) / 2;
+                    int padY = (face.rect.bottom - face.rect.top) / 2;
+                    int left = std::max(0, face.rect.left - padX) & ~1;
+                    int top = std::max(0, face.rect.top - padY) & ~1;
+                    int right = std::min(capturedFrame.width, face.rect.right + padX) & ~1;
+                    int bottom = std::min(capturedFrame.height, face.rect.bottom + padY) & ~1;
+                    if (right <= left || bottom <= top) {
+                        continue;
+                    }
+                    int feather = std::max(2, (right - left) / 8);
+                    blendRegion(capturedFrame.yBuffer, capturedFrame.yStride, yuvBuffer_,
+                                capturedFrame.yStride, left, top, right, bottom, feather);
+                    blendRegion(capturedFrame.uBuffer, capturedFrame.uStride, yuvBuffer_ + ysize,
+                                capturedFrame.uStride, left / 2, top / 2, right / 2, bottom / 2,
+                                feather / 2);
+                    blendRegion(capturedFrame.vBuffer, capturedFrame.vStride, yuvBuffer_ + ysize + usize,
+                                capturedFrame.vStride, left / 2, top / 2, right / 2, bottom / 2,
+                                feather / 2);
+                }
+            }
         }
     
-        void ByteDanceProcessor::processFaceDetect() {
+        void ByteDanceProcessor::detectFaces() {
+            bef_ai_face_info &faceInfo = analysis_.faceInfo;
             if (!faceDetectHandler_) {
                 bef_effect_result_t ret;
                 ret = bef_effect_ai_face_detect_create(
                         BEF_DETECT_SMALL_MODEL | BEF_DETECT_FULL | BEF_DETECT_MODE_VIDEO,
                         faceDetectModelPath_.c_str(), &faceDetectHandler_);
                 CHECK_BEF_AI_RET_SUCCESS(ret,
-                                         "ByteDanceProcessor::processFaceDetect create face detect handle failed ! %d",
+                                         "ByteDanceProcessor::detectFaces create face detect handle failed ! %d",
                                          ret);
-#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
-                void *context = AndroidContextHelper::getContext();
-                ret = bef_effect_ai_face_check_license(
-                        JniHelper::getJniHelper()->attachCurrentThread(),
-                        reinterpret_cast<jobject>(context), faceDetectHandler_,
-                        licensePath_.c_str());
-#elif defined __APPLE__
-                ret = bef_effect_ai_face_check_license(faceDetectHandler_, licensePath_.c_str());
-#endif
+                CHECK_LICENSE(ret, bef_effect_ai_face_check_license, faceDetectHandler_);
                 CHECK_BEF_AI_RET_SUCCESS(ret,
-                                         "ByteDanceProcessor::processFaceDetect check_license face detect failed ! %d",
+                                         "ByteDanceProcessor::detectFaces check_license face detect failed ! %d",
                                          ret);
 
                 ret = bef_effect_ai_face_detect_setparam(faceDetectHandler_,
@@ -227,36 +432,63 @@ namespace agora {
                                                          BEF_FACE_PARAM_MAX_FACE_NUM,
                                                          BEF_MAX_FACE_NUM);
             }
+            memset(&faceInfo, 0, sizeof(bef_ai_face_info));
+            // a crop is a view into rgbaBuffer_: offset origin, full frame stride
+            int stride = rgbaStride();
+            bef_ai_rect roi = {0, 0, rgbaWidth(), prevFrame_.height};
+            if (roiTrackingEnabled_) {
+                roi = faceRoi_.next(rgbaWidth(), prevFrame_.height);
+            }
+            bef_effect_result_t ret;
+            ret = bef_effect_ai_face_detect(faceDetectHandler_, rgbaBuffer_ + roiOffset(roi, stride), BEF_AI_PIX_FMT_RGBA8888, roi.right - roi.left, roi.bottom - roi.top, stride, orientation_.rotateType(), BEF_DETECT_MODE_VIDEO | BEF_DETECT_FULL, &faceInfo);
+            CHECK_BEF_AI_RET_SUCCESS(ret, "ByteDanceProcessor::detectFaces face info detect failed ! %d", ret);
+            if (ret != BEF_RESULT_SUC) {
+                faceInfo.face_count = 0;
+            }
+            if (!roiTrackingEnabled_) {
+                return;
+            }
+
+            // back to frame coordinates; extra_infos are not requested by BEF_DETECT_FULL
+            bef_ai_rect boxes[BEF_MAX_FACE_NUM];
+            int count = std::min(faceInfo.face_count, BEF_MAX_FACE_NUM);
+            for (int i = 0; i < count; i++) {
+                bef_ai_face_106 &face = faceInfo.base_infos[i];
+                face.rect.left += roi.left;
+                face.rect.right += roi.left;
+                face.rect.top += roi.top;
+                face.rect.bottom += roi.top;
+                for (int p = 0; p < 106; p++) {
+                    face.points_array[p].x += roi.left;
+                    face.points_array[p].y += roi.top;
+                }
+                boxes[i] = face.rect;
+            }
+            faceRoi_.update(boxes, count);
+        }
+
+        void ByteDanceProcessor::detectFaceAttributes() {
+            bef_ai_face_attribute_result &attributeResult = analysis_.faceAttributes;
+            attributeResult.face_count = 0;
+
             if (!faceAttributesHandler_) {
                 bef_effect_result_t ret;
                 ret = bef_effect_ai_face_attribute_create(0, faceAttributeModelPath_.c_str(),
                                                           &faceAttributesHandler_);
                 CHECK_BEF_AI_RET_SUCCESS(ret,
-                                         "ByteDanceProcessor::processFaceDetect create face attribute handle failed ! %d",
+                                         "ByteDanceProcessor::detectFaceAttributes create face attribute handle failed ! %d",
                                          ret);
                 
-#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
-                void *context = AndroidContextHelper::getContext();
-                ret = bef_effect_ai_face_attribute_check_license(
-                        JniHelper::getJniHelper()->attachCurrentThread(),
-                        reinterpret_cast<jobject>(context), faceAttributesHandler_,
-                        licensePath_.c_str());
-#elif defined __APPLE__
-                ret = bef_effect_ai_face_attribute_check_license(faceAttributesHandler_, licensePath_.c_str());
-#endif
+                CHECK_LICENSE(ret, bef_effect_ai_face_attribute_check_license, faceAttributesHandler_);
                 
                 CHECK_BEF_AI_RET_SUCCESS(ret,
-                                         "ByteDanceProcessor::processFaceDetect check_license face attribute failed ! %d",
+                                         "ByteDanceProcessor::detectFaceAttributes check_license face attribute failed ! %d",
                                          ret);
             }
 
-            bef_ai_face_info faceInfo;
-            memset(&faceInfo, 0, sizeof(bef_ai_face_info));
-            bef_effect_result_t ret;
-            ret = bef_effect_ai_face_detect(faceDetectHandler_, rgbaBuffer_, BEF_AI_PIX_FMT_RGBA8888, prevFrame_.yStride, prevFrame_.height, prevFrame_.yStride * 4, BEF_AI_CLOCKWISE_ROTATE_0, BEF_DETECT_MODE_VIDEO | BEF_DETECT_FULL, &faceInfo);
-            CHECK_BEF_AI_RET_SUCCESS(ret, "ByteDanceProcessor::processFaceDetect face info detect failed ! %d", ret);
-            bef_ai_face_attribute_result attributeResult;
+            const bef_ai_face_info &faceInfo = analysis_.faceInfo;
             if (faceInfo.face_count > 0) {
+                bef_effect_result_t ret;
                 unsigned long long attriConfig =
                         BEF_FACE_ATTRIBUTE_AGE | BEF_FACE_ATTRIBUTE_HAPPINESS |
                         BEF_FACE_ATTRIBUTE_EXPRESSION | BEF_FACE_ATTRIBUTE_GENDER
@@ -264,34 +496,174 @@ namespace agora {
 
                 ret = bef_effect_ai_face_attribute_detect_batch(faceAttributesHandler_, rgbaBuffer_,
                                                                 BEF_AI_PIX_FMT_RGBA8888,
-                                                                prevFrame_.yStride,
+                                                                rgbaWidth(),
                                                                 prevFrame_.height,
-                                                                prevFrame_.yStride * 4,
+                                                                rgbaStride(),
                                                                 faceInfo.base_infos,
                                                                 faceInfo.face_count, attriConfig,
                                                                 &attributeResult);
                 CHECK_BEF_AI_RET_SUCCESS(ret, "face attribute detect failed ! %d", ret);
+                if (ret != BEF_RESULT_SUC) {
+                    attributeResult.face_count = 0;
+                }
+            }
+        }
+
+        void ByteDanceProcessor::processFaceDetect() {
+            const bef_ai_face_info &faceInfo = analysis_.faceInfo;
+            const bef_ai_face_attribute_result &attributeResult = analysis_.faceAttributes;
+            TrackSmoother::Sample faces[BEF_MAX_FACE_NUM];
+            int count = std::min(faceInfo.face_count, BEF_MAX_FACE_NUM);
+            for (int i = 0; i < count; ++i) {
+                const bef_ai_face_106 &face = faceInfo.base_infos[i];
+                TrackSmoother::Sample &sample = faces[i];
+                sample.id = face.ID;
+                sample.values[FACE_YAW] = face.yaw;
+                sample.values[FACE_ROLL] = face.roll;
+                sample.values[FACE_PITCH] = face.pitch;
+                sample.values[FACE_LEFT] = face.rect.left;
+                sample.values[FACE_TOP] = face.rect.top;
+                sample.values[FACE_RIGHT] = face.rect.right;
+                sample.values[FACE_BOTTOM] = face.rect.bottom;
+                sample.held[FACE_ACTION] = face.action;
+                bool hasAttribute = i < attributeResult.face_count;
+                sample.held[FACE_EXPRESSION] = hasAttribute ? (int)attributeResult.attr_info[i].exp_type : -1;
+                sample.held[FACE_CONFUSED_PROB] = hasAttribute ? attributeResult.attr_info[i].confused_prob : -1;
+            }
+            if (smoothingEnabled_) {
+                if (frameTime_.duplicate) {
+                    // the same instant again, filtering it twice would move the tracks
+                    predictFaces();
+                    return;
+                }
+                faceSmoother_.update(frameTimestampMs_, faces, count);
             }
-            rapidjson::StringBuffer strBuf;
-            rapidjson::Writer<rapidjson::StringBuffer> writer(strBuf);
+            emitFaceEvent(faces, count);
+        }
+
+        void ByteDanceProcessor::predictFaces() {
+            TrackSmoother::Sample faces[TrackSmoother::kMaxTracks];
+            int count = faceSmoother_.predict(frameTimestampMs_, faces, TrackSmoother::kMaxTracks);
+            emitFaceEvent(faces, count);
+        }
+
+        void ByteDanceProcessor::emitFaceEvent(const TrackSmoother::Sample* faces, int count) {
+            EventJson& event = EventJson::begin();
+            rapidjson::StringBuffer& strBuf = event.buffer;
+            rapidjson::Writer<rapidjson::StringBuffer>& writer = event.writer;
             writer.SetMaxDecimalPlaces(3);
             writer.StartObject();
+            writer.Key("timestamp");
+            writer.Int64(frameTimestampMs_);
             writer.Key("plugin.bytedance.face.info");
             writer.StartArray();
-            for (int i = 0; i < faceInfo.face_count; ++i) {
+            for (int i = 0; i < count; ++i) {
+                const TrackSmoother::Sample &face = faces[i];
                 writer.StartObject();
+                writer.Key("id");
+                writer.Int(face.id);
                 writer.Key("yaw");
-                writer.Double(faceInfo.base_infos[i].yaw);
+                writer.Double(face.values[FACE_YAW]);
                 writer.Key("roll");
-                writer.Double(faceInfo.base_infos[i].roll);
+                writer.Double(face.values[FACE_ROLL]);
                 writer.Key("pitch");
-                writer.Double(faceInfo.base_infos[i].pitch);
+                writer.Double(face.values[FACE_PITCH]);
+                float left = face.values[FACE_LEFT];
+                float top = face.values[FACE_TOP];
+                float right = face.values[FACE_RIGHT];
+                float bottom = face.values[FACE_BOTTOM];
+                orientation_.toDisplay(left, top, right, bottom);
+                writer.Key("rect");
+                writer.StartArray();
+                writer.Int((int)std::lround(left));
+                writer.Int((int)std::lround(top));
+                writer.Int((int)std::lround(right));
+                writer.Int((int)std::lround(bottom));
+                writer.EndArray();
                 writer.Key("action");
-                writer.Int(faceInfo.base_infos[i].action);
-                writer.Key("expression");
-                writer.Int((int)attributeResult.attr_info[i].exp_type);
-                writer.Key("confused_prob");
-                writer.Double(attributeResult.attr_info[i].confused_prob);
+                writer.Int((int)face.held[FACE_ACTION]);
+                if (face.held[FACE_EXPRESSION] >= 0) {
+                    writer.Key("expression");
+                    writer.Int((int)face.held[FACE_EXPRESSION]);
+                    writer.Key("confused_prob");
+                    writer.Double(face.held[FACE_CONFUSED_PROB]);
+                }
+                writer.EndObject();
+            }
+            writer.EndArray();
+            writer.EndObject();
+            const char* text = strBuf.GetString();
+            dataCallback(text);
+        }
+
+        void ByteDanceProcessor::processHumanDistance() {
+            if (!humanDistanceHandler_) {
+                bef_effect_result_t ret;
+                ret = bef_effect_ai_human_distance_create(&humanDistanceHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processHumanDistance create human distance handle failed ! %d",
+                                         ret);
+                if (!humanDistanceHandler_) {
+                    return;
+                }
+
+                CHECK_LICENSE(ret, bef_effect_ai_human_distance_check_license, humanDistanceHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processHumanDistance check_license human distance failed ! %d",
+                                         ret);
+
+                ret = bef_effect_ai_human_distance_load_model(humanDistanceHandler_,
+                                                              BEF_HumanDistanceModel1,
+                                                              humanDistanceModelPath_.c_str());
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processHumanDistance load model failed ! %d path: %s",
+                                         ret, humanDistanceModelPath_.c_str());
+
+                if (humanDistanceCameraFov_ > 0) {
+                    ret = bef_effect_ai_human_distance_setparam(humanDistanceHandler_,
+                                                                BEF_HumanDistanceCameraFov,
+                                                                humanDistanceCameraFov_);
+                    CHECK_BEF_AI_RET_SUCCESS(ret,
+                                             "ByteDanceProcessor::processHumanDistance set camera fov failed ! %d",
+                                             ret);
+                }
+            }
+
+            // distance is estimated from the faces and attributes of this frame, never re-detected
+            const bef_ai_face_info &faceInfo = analysis_.faceInfo;
+            bef_ai_human_distance_result distanceResult;
+            distanceResult.face_count = 0;
+            if (faceInfo.face_count > 0) {
+                bef_effect_result_t ret;
+                ret = bef_effect_ai_human_distance_detect(humanDistanceHandler_, rgbaBuffer_,
+                                                          BEF_AI_PIX_FMT_RGBA8888,
+                                                          rgbaWidth(), prevFrame_.height,
+                                                          rgbaStride(),
+                                                          orientation_.rotateType(),
+                                                          &faceInfo, &analysis_.faceAttributes,
+                                                          &distanceResult);
+                CHECK_BEF_AI_RET_SUCCESS(ret, "human distance detect failed ! %d", ret);
+                if (ret != BEF_RESULT_SUC) {
+                    distanceResult.face_count = 0;
+                }
+            }
+            int count = std::min(distanceResult.face_count, faceInfo.face_count);
+
+            EventJson& event = EventJson::begin();
+            rapidjson::StringBuffer& strBuf = event.buffer;
+            rapidjson::Writer<rapidjson::StringBuffer>& writer = event.writer;
+            writer.SetMaxDecimalPlaces(3);
+            writer.StartObject();
+            writer.Key("timestamp");
+            writer.Int64(frameTimestampMs_);
+            writer.Key("plugin.bytedance.humanDistance.info");
+            writer.StartArray();
+            for (int i = 0; i < count; i++) {
+                writer.StartObject();
+                writer.Key("id");
+                writer.Int(faceInfo.base_infos[i].ID);
+                writer.Key("distance");
+                writer.Double(distanceResult.distances[i]);
                 writer.EndObject();
             }
             writer.EndArray();
@@ -309,15 +681,7 @@ namespace agora {
                                          "ByteDanceProcessor::processHandDetect create hand detect handle failed ! %d",
                                          ret);
                 
-#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
-                void *context = AndroidContextHelper::getContext();
-                ret = bef_effect_ai_hand_check_license(
-                        JniHelper::getJniHelper()->attachCurrentThread(),
-                        reinterpret_cast<jobject>(context), handDetectHandler_,
-                        licensePath_.c_str());
-#elif defined __APPLE__
-                ret = bef_effect_ai_hand_check_license(handDetectHandler_, licensePath_.c_str());
-#endif
+                CHECK_LICENSE(ret, bef_effect_ai_hand_check_license, handDetectHandler_);
                 CHECK_BEF_AI_RET_SUCCESS(ret,
                                          "ByteDanceProcessor::processHandDetect check_license hand detect failed ! %d",
                                          ret);
@@ -356,32 +720,111 @@ namespace agora {
                                          "ByteDanceProcessor::processHandDetect set hand enlarge factor failed !");
             }
 
+            int stride = rgbaStride();
+            bef_ai_rect roi = {0, 0, rgbaWidth(), prevFrame_.height};
+            if (roiTrackingEnabled_) {
+                roi = handRoi_.next(rgbaWidth(), prevFrame_.height);
+            }
+
             bef_ai_hand_info handInfo;
             bef_effect_result_t ret;
-            ret = bef_effect_ai_hand_detect(handDetectHandler_, rgbaBuffer_,
-                                            BEF_AI_PIX_FMT_RGBA8888, prevFrame_.yStride,
-                                            prevFrame_.height, prevFrame_.yStride * 4,
-                                            BEF_AI_CLOCKWISE_ROTATE_0,
+            ret = bef_effect_ai_hand_detect(handDetectHandler_, rgbaBuffer_ + roiOffset(roi, stride),
+                                            BEF_AI_PIX_FMT_RGBA8888, roi.right - roi.left,
+                                            roi.bottom - roi.top, stride,
+                                            orientation_.rotateType(),
                                             BEF_AI_HAND_MODEL_DETECT | BEF_AI_HAND_MODEL_BOX_REG |
                                             BEF_AI_HAND_MODEL_GESTURE_CLS |
                                             BEF_AI_HAND_MODEL_KEY_POINT, &handInfo, 0);
             CHECK_BEF_AI_RET_SUCCESS(ret, "hand detect failed ! %d", ret);
 
-            rapidjson::StringBuffer strBuf;
-            rapidjson::Writer<rapidjson::StringBuffer> writer(strBuf);
+            if (ret != BEF_RESULT_SUC) {
+                handInfo.hand_count = 0;
+            }
+
+            int count = std::min(handInfo.hand_count, BEF_MAX_HAND_NUM);
+            if (roiTrackingEnabled_) {
+                bef_ai_rect boxes[BEF_MAX_HAND_NUM];
+                for (int i = 0; i < count; i++) {
+                    bef_ai_hand &hand = handInfo.p_hands[i];
+                    hand.rect.left += roi.left;
+                    hand.rect.right += roi.left;
+                    hand.rect.top += roi.top;
+                    hand.rect.bottom += roi.top;
+                    for (int p = 0; p < BEF_HAND_KEY_POINT_NUM; p++) {
+                        hand.key_points[p].x += roi.left;
+                        hand.key_points[p].y += roi.top;
+                    }
+                    for (int p = 0; p < BEF_HAND_KEY_POINT_NUM_EXTENSION; p++) {
+                        hand.key_points_extension[p].x += roi.left;
+                        hand.key_points_extension[p].y += roi.top;
+                    }
+                    boxes[i] = hand.rect;
+                }
+                handRoi_.update(boxes, count);
+            }
+
+            TrackSmoother::Sample hands[BEF_MAX_HAND_NUM];
+            for (int i = 0; i < count; i++) {
+                const bef_ai_hand &hand = handInfo.p_hands[i];
+                TrackSmoother::Sample &sample = hands[i];
+                sample.id = hand.id;
+                sample.values[HAND_LEFT] = hand.rect.left;
+                sample.values[HAND_TOP] = hand.rect.top;
+                sample.values[HAND_RIGHT] = hand.rect.right;
+                sample.values[HAND_BOTTOM] = hand.rect.bottom;
+                sample.held[HAND_ACTION] = hand.action;
+                sample.held[HAND_SEQ_ACTION] = hand.seq_action;
+            }
+            if (smoothingEnabled_) {
+                if (frameTime_.duplicate) {
+                    // the same instant again, filtering it twice would move the tracks
+                    predictHands();
+                    return;
+                }
+                handSmoother_.update(frameTimestampMs_, hands, count);
+            }
+            emitHandEvent(hands, count);
+        }
+
+        void ByteDanceProcessor::predictHands() {
+            TrackSmoother::Sample hands[TrackSmoother::kMaxTracks];
+            int count = handSmoother_.predict(frameTimestampMs_, hands, TrackSmoother::kMaxTracks);
+            emitHandEvent(hands, count);
+        }
+
+        void ByteDanceProcessor::emitHandEvent(const TrackSmoother::Sample* hands, int count) {
+            EventJson& event = EventJson::begin();
+            rapidjson::StringBuffer& strBuf = event.buffer;
+            rapidjson::Writer<rapidjson::StringBuffer>& writer = event.writer;
             writer.SetMaxDecimalPlaces(3);
             writer.StartObject();
+            writer.Key("timestamp");
+            writer.Int64(frameTimestampMs_);
             writer.Key("plugin.bytedance.hand.info");
 
             writer.StartArray();
-            for (int i = 0; i < handInfo.hand_count; i++) {
-                bef_ai_hand hand = handInfo.p_hands[i];
+            for (int i = 0; i < count; i++) {
+                const TrackSmoother::Sample &hand = hands[i];
                 writer.StartObject();
+                writer.Key("id");
+                writer.Int(hand.id);
+                float left = hand.values[HAND_LEFT];
+                float top = hand.values[HAND_TOP];
+                float right = hand.values[HAND_RIGHT];
+                float bottom = hand.values[HAND_BOTTOM];
+                orientation_.toDisplay(left, top, right, bottom);
+                writer.Key("rect");
+                writer.StartArray();
+                writer.Int((int)std::lround(left));
+                writer.Int((int)std::lround(top));
+                writer.Int((int)std::lround(right));
+                writer.Int((int)std::lround(bottom));
+                writer.EndArray();
                 writer.Key("action");
-                writer.Int(hand.action);
+                writer.Int((int)hand.held[HAND_ACTION]);
 
                 writer.Key("seq_action");
-                writer.Double(hand.seq_action);
+                writer.Double(hand.held[HAND_SEQ_ACTION]);
                 writer.EndObject();
             }
 
@@ -390,7 +833,6 @@ namespace agora {
             writer.EndObject();
             const char* text = strBuf.GetString();
             dataCallback(text);
-
         }
 
         void ByteDanceProcessor::processLightDetect() {
@@ -403,15 +845,7 @@ namespace agora {
                                          "ByteDanceProcessor::processLightDetect create face detect handle failed ! %d",
                                          ret);
                 
-#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
-                void *context = AndroidContextHelper::getContext();
-                ret = bef_effect_ai_lightcls_check_license(
-                        JniHelper::getJniHelper()->attachCurrentThread(),
-                        reinterpret_cast<jobject>(context), lightDetectHandler_,
-                        licensePath_.c_str());
-#elif defined __APPLE__
-                ret = bef_effect_ai_lightcls_check_license(lightDetectHandler_, licensePath_.c_str());
-#endif
+                CHECK_LICENSE(ret, bef_effect_ai_lightcls_check_license, lightDetectHandler_);
                 CHECK_BEF_AI_RET_SUCCESS(ret,
                                          "ByteDanceProcessor::processLightDetect check_license light detect failed ! %d",
                                          ret);
@@ -420,14 +854,17 @@ namespace agora {
             bef_effect_result_t ret;
             bef_ai_light_cls_result lightInfo;
             ret = bef_effect_ai_lightcls_detect(lightDetectHandler_, rgbaBuffer_,
-                                                BEF_AI_PIX_FMT_RGBA8888, prevFrame_.yStride,
-                                                prevFrame_.height, prevFrame_.yStride * 4,
-                                                BEF_AI_CLOCKWISE_ROTATE_0, &lightInfo);
+                                                BEF_AI_PIX_FMT_RGBA8888, rgbaWidth(),
+                                                prevFrame_.height, rgbaStride(),
+                                                orientation_.rotateType(), &lightInfo);
             CHECK_BEF_AI_RET_SUCCESS(ret, "light detect failed ! %d", ret);
-            rapidjson::StringBuffer strBuf;
-            rapidjson::Writer<rapidjson::StringBuffer> writer(strBuf);
+            EventJson& event = EventJson::begin();
+            rapidjson::StringBuffer& strBuf = event.buffer;
+            rapidjson::Writer<rapidjson::StringBuffer>& writer = event.writer;
             writer.SetMaxDecimalPlaces(3);
             writer.StartObject();
+            writer.Key("timestamp");
+            writer.Int64(frameTimestampMs_);
             writer.Key("plugin.bytedance.light.info");
             writer.StartObject();
             writer.Key("selected_index");
@@ -440,94 +877,985 @@ namespace agora {
             dataCallback(text);
         }
 
-        int ByteDanceProcessor::processFrame(const agora::media::base::VideoFrame &capturedFrame) {
-//            PRINTF_INFO("processFrame: w: %d,  h: %d,  r: %d", capturedFrame.width, capturedFrame.height, capturedFrame.rotation);
-            const std::lock_guard<std::mutex> lock(mutex_);
+        void ByteDanceProcessor::processPortraitMatting() {
+            if (!portraitMattingHandler_) {
+                bef_effect_result_t ret;
+                ret = bef_effect_ai_portrait_matting_create(&portraitMattingHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processPortraitMatting create portrait matting handle failed ! %d",
+                                         ret);
+                if (!portraitMattingHandler_) {
+                    return;
+                }
 
-            if (aiEffectEnabled_ || faceAttributeEnabled_) {
-                prepareCachedVideoFrame(capturedFrame);
-            }
+                CHECK_LICENSE(ret, bef_effect_ai_matting_check_license, portraitMattingHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processPortraitMatting check_license portrait matting failed ! %d",
+                                         ret);
 
-            if (faceAttributeEnabled_) {
-                processFaceDetect();
+                ret = bef_effect_ai_portrait_matting_init_model(portraitMattingHandler_,
+                                                                BEF_MP_SMALL_MODEL,
+                                                                portraitMattingModelPath_.c_str());
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processPortraitMatting init model failed ! %d path: %s",
+                                         ret, portraitMattingModelPath_.c_str());
+
+                // recommended configuration: 128 px short side, edge refinement on
+                bef_effect_ai_portrait_matting_set_param(portraitMattingHandler_, BEF_MP_EdgeMode, 1);
+                bef_effect_ai_portrait_matting_set_param(portraitMattingHandler_, BEF_MP_FrashEvery, 15);
+                bef_effect_ai_portrait_matting_set_param(portraitMattingHandler_,
+                                                         BEF_MP_OutputMinSideLen, 128);
             }
 
-            if (handDetectEnabled_) {
-                processHandDetect();
+            bef_effect_result_t ret;
+            int maskWidth = 0;
+            int maskHeight = 0;
+            ret = bef_effect_ai_portrait_get_output_shape(portraitMattingHandler_, rgbaWidth(),
+                                                          prevFrame_.height, &maskWidth, &maskHeight);
+            CHECK_BEF_AI_RET_SUCCESS(ret, "portrait matting get output shape failed ! %d", ret);
+            if (ret != BEF_RESULT_SUC || maskWidth <= 0 || maskHeight <= 0) {
+                return;
             }
 
-            if (lightDetectEnabled_) {
-                processLightDetect();
+            agora_refptr<SegmentationMask> mask = masks_.acquire(MASK_PORTRAIT);
+            mask->resetRegions(1);
+            MaskRegion &region = mask->region(0);
+            region.width = maskWidth;
+            region.height = maskHeight;
+            region.channels = 1;
+            region.alpha.resize((size_t)maskWidth * maskHeight);
+
+            bef_ai_matting_ret result;
+            result.alpha = region.alpha.data();
+            result.width = maskWidth;
+            result.height = maskHeight;
+            ret = bef_effect_ai_portrait_matting_do_detect(portraitMattingHandler_, rgbaBuffer_,
+                                                           BEF_AI_PIX_FMT_RGBA8888,
+                                                           rgbaWidth(), prevFrame_.height, rgbaStride(),
+                                                           orientation_.rotateType(), false, &result);
+            CHECK_BEF_AI_RET_SUCCESS(ret, "portrait matting detect failed ! %d", ret);
+            if (ret == BEF_RESULT_SUC) {
+                mask->timestampMs = frameTimestampMs_;
+                masks_.publish(MASK_PORTRAIT, mask);
+                background_.setMask(mask);
             }
+        }
 
-            if (aiEffectEnabled_) {
-                processEffect(capturedFrame);
-            }
+        void ByteDanceProcessor::processSkeletonDetect() {
+            if (!skeletonHandler_) {
+                bef_effect_result_t ret;
+                ret = bef_effect_ai_skeleton_create(skeletonModelPath_.c_str(), &skeletonHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processSkeletonDetect create skeleton handle failed ! %d",
+                                         ret);
+                if (!skeletonHandler_) {
+                    return;
+                }
 
-            return 0;
-        }
+                CHECK_LICENSE(ret, bef_effect_ai_skeleton_check_license, skeletonHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processSkeletonDetect check_license skeleton failed ! %d",
+                                         ret);
 
+                ret = bef_effect_ai_skeleton_set_targetnum(skeletonHandler_, BEF_AI_MAX_SKELETON_NUM);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processSkeletonDetect set target num failed ! %d",
+                                         ret);
+                skeletonNeedUpdate_ = true;
+            }
 
-        int ByteDanceProcessor::releaseEffectEngine() {
-            const std::lock_guard<std::mutex> lock(mutex_);
-            if (byteEffectHandler_) {
-                bef_effect_ai_destroy(byteEffectHandler_);
-                byteEffectHandler_ = nullptr;
+            bef_effect_result_t ret;
+            if (skeletonNeedUpdate_) {
+                ret = bef_effect_ai_skeleton_set_tracking_inputsize(skeletonHandler_,
+                                                                    skeletonTrackingWidth_,
+                                                                    skeletonTrackingHeight_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processSkeletonDetect set tracking input size failed ! %d",
+                                         ret);
+                skeletonNeedUpdate_ = false;
             }
-            aiEffectEnabled_ = false;
-            licensePath_.clear();
-            modelDir_.clear();
 
-            if (aiNodes_) {
-                for (int i = 0; i < aiNodeCount_; i++) {
-                    free(aiNodes_[i]);
+            int bodyCount = 0;
+            bef_ai_skeleton_info *bodies = nullptr;
+            ret = bef_effect_ai_skeleton_detect(skeletonHandler_, rgbaBuffer_, BEF_AI_PIX_FMT_RGBA8888,
+                                                rgbaWidth(), prevFrame_.height,
+                                                rgbaStride(), orientation_.rotateType(),
+                                                &bodyCount, &bodies);
+            CHECK_BEF_AI_RET_SUCCESS(ret, "skeleton detect failed ! %d", ret);
+            if (ret != BEF_RESULT_SUC || !bodies) {
+                bodyCount = 0;
+            }
+
+            // compact form: rect [l, t, r, b] and a flat [x0, y0, x1, y1, ...] point list,
+            // -1 for key points that were not detected
+            EventJson& event = EventJson::begin();
+            rapidjson::StringBuffer& strBuf = event.buffer;
+            rapidjson::Writer<rapidjson::StringBuffer>& writer = event.writer;
+            writer.SetMaxDecimalPlaces(1);
+            writer.StartObject();
+            writer.Key("timestamp");
+            writer.Int64(frameTimestampMs_);
+            writer.Key("plugin.bytedance.skeleton.info");
+            writer.StartArray();
+            for (int i = 0; i < std::min(bodyCount, BEF_AI_MAX_SKELETON_NUM); i++) {
+                const bef_ai_skeleton_info &body = bodies[i];
+                writer.StartObject();
+                bef_ai_rect rect = orientation_.toDisplay(body.skeletonRect);
+                writer.Key("rect");
+                writer.StartArray();
+                writer.Int(rect.left);
+                writer.Int(rect.top);
+                writer.Int(rect.right);
+                writer.Int(rect.bottom);
+                writer.EndArray();
+                writer.Key("points");
+                writer.StartArray();
+                for (int j = 0; j < BEF_AI_MAX_SKELETON_POINT_NUM; j++) {
+                    const bef_ai_skeleton_point_info &point = body.keyPointInfos[j];
+                    float x = point.x;
+                    float y = point.y;
+                    orientation_.toDisplay(x, y);
+                    writer.Double(point.is_detect ? x : -1);
+                    writer.Double(point.is_detect ? y : -1);
                 }
-                free(aiNodes_);
+                writer.EndArray();
+                writer.EndObject();
             }
-            aiNodeIntensities_.clear();
-            aiNodeKeys_.clear();
-            aiNodeCount_ = 0;
-            aiEffectNeedUpdate_ = false;
+            writer.EndArray();
+            writer.EndObject();
+            const char* text = strBuf.GetString();
+            dataCallback(text);
+        }
 
-            faceStickerEnabled_ = false;
-            faceStickerItemPath_.clear();
+        void ByteDanceProcessor::processHairParse() {
+            if (!hairParserHandler_) {
+                bef_effect_result_t ret;
+                ret = bef_effect_ai_hairparser_create(&hairParserHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processHairParse create hair parser handle failed ! %d",
+                                         ret);
+                if (!hairParserHandler_) {
+                    return;
+                }
 
-            if (yuvBuffer_) {
-                free(yuvBuffer_);
-                yuvBuffer_ = nullptr;
-            }
-            if (rgbaBuffer_) {
-                free(rgbaBuffer_);
-                rgbaBuffer_ = nullptr;
+                CHECK_LICENSE(ret, bef_effect_ai_hairparser_check_license, hairParserHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processHairParse check_license hair parser failed ! %d",
+                                         ret);
+
+                ret = bef_effect_ai_hairparser_init_model(hairParserHandler_, hairParserModelPath_.c_str());
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processHairParse init model failed ! %d path: %s",
+                                         ret, hairParserModelPath_.c_str());
+
+                // SDK recommended network input, temporal tracking and edge blur on
+                ret = bef_effect_ai_hairparser_set_param(hairParserHandler_, 128, 224, true, true);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processHairParse set param failed ! %d",
+                                         ret);
             }
 
-            faceAttributeEnabled_ = false;
-            faceDetectModelPath_.clear();
-            faceAttributeModelPath_.clear();
-            if (faceDetectHandler_) {
-                bef_effect_ai_face_detect_destroy(faceDetectHandler_);
-                faceDetectHandler_ = nullptr;
+            bef_effect_result_t ret;
+            int maskWidth = 0;
+            int maskHeight = 0;
+            int channels = 0;
+            ret = bef_effect_ai_hairparser_get_output_shape(hairParserHandler_, &maskWidth, &maskHeight,
+                                                            &channels);
+            CHECK_BEF_AI_RET_SUCCESS(ret, "hair parser get output shape failed ! %d", ret);
+            if (ret != BEF_RESULT_SUC || maskWidth <= 0 || maskHeight <= 0 || channels <= 0) {
+                return;
             }
-            if (faceAttributesHandler_) {
-                bef_effect_ai_face_attribute_destroy(faceAttributesHandler_);
-                faceAttributesHandler_ = nullptr;
+
+            agora_refptr<SegmentationMask> mask = masks_.acquire(MASK_HAIR);
+            mask->resetRegions(1);
+            MaskRegion &region = mask->region(0);
+            region.width = maskWidth;
+            region.height = maskHeight;
+            region.channels = channels;
+            region.alpha.resize((size_t)maskWidth * maskHeight * channels);
+            ret = bef_effect_ai_hairparser_do_detect(hairParserHandler_, rgbaBuffer_,
+                                                     BEF_AI_PIX_FMT_RGBA8888,
+                                                     rgbaWidth(), prevFrame_.height,
+                                                     rgbaStride(),
+                                                     orientation_.rotateType(),
+                                                     region.alpha.data(), false);
+            CHECK_BEF_AI_RET_SUCCESS(ret, "hair parser detect failed ! %d", ret);
+            if (ret == BEF_RESULT_SUC) {
+                mask->timestampMs = frameTimestampMs_;
+                masks_.publish(MASK_HAIR, mask);
             }
+        }
 
-            handDetectEnabled_ = false;
-            handDetectModelPath_.clear();
-            handBoxModelPath_.clear();
-            handGestureModelPath_.clear();
-            handKPModelPath_.clear();
+        void ByteDanceProcessor::processHeadSeg() {
+            if (!headSegHandler_) {
+                int ret = BEF_AI_HSeg_CreateHandler(&headSegHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processHeadSeg create head seg handle failed ! %d",
+                                         ret);
+                if (!headSegHandler_) {
+                    return;
+                }
+
+                ret = LicenseCache::getInstance().check("BEF_AI_HSeg_CheckLicense", licensePath_, [this] {
+                    return BEF_AI_HSeg_CheckLicense(headSegHandler_, licensePath_.c_str());
+                });
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processHeadSeg check_license head seg failed ! %d",
+                                         ret);
+
+                bef_ai_headseg_config config;
+                config.net_input_width = 160;
+                config.net_input_height = 160;
+                ret = BEF_AI_HSeg_SetConfig(headSegHandler_, &config);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processHeadSeg set config failed ! %d",
+                                         ret);
+
+                BEF_AI_HSeg_SetParam(headSegHandler_, BEF_AI_HS_ENABLE_TRACKING, 1);
+                BEF_AI_HSeg_SetParam(headSegHandler_, BEF_AI_HS_MAX_FACE, BEF_MAX_FACE_NUM);
+                headSegModelChanged_ = true;
+            }
+
+            ModelBuffer sharedModel = shared_->headSegModel();
+            if (sharedModel != headSegModelSeen_) {
+                headSegModelSeen_ = sharedModel;
+                headSegModelBuffer_ = sharedModel;
+                headSegModelChanged_ = true;
+            }
+
+            if (headSegModelChanged_) {
+                int ret;
+                if (headSegModelBuffer_) {
+                    ret = BEF_AI_HSeg_SetModelFromBuff(headSegHandler_, headSegModelBuffer_->data(),
+                                                       (unsigned int)headSegModelBuffer_->size());
+                } else {
+                    ret = BEF_AI_HSeg_InitModel(headSegHandler_, headSegModelPath_.c_str());
+                }
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processHeadSeg load model failed ! %d",
+                                         ret);
+                headSegModelChanged_ = false;
+            }
+
+            // head segmentation is guided by the 106 face points
+            const bef_ai_face_info &faceInfo = analysis_.faceInfo;
+            if (faceInfo.face_count <= 0) {
+                return;
+            }
+
+            bef_ai_headseg_faceinfo faces[BEF_MAX_FACE_NUM];
+            int faceCount = std::min(faceInfo.face_count, BEF_MAX_FACE_NUM);
+            for (int i = 0; i < faceCount; i++) {
+                faces[i].face_id = faceInfo.base_infos[i].ID;
+                memcpy(faces[i].points, faceInfo.base_infos[i].points_array, sizeof(faces[i].points));
+            }
+
+            bef_ai_headseg_input input;
+            input.image = rgbaBuffer_;
+            input.image_width = rgbaWidth();
+            input.image_height = prevFrame_.height;
+            input.image_stride = rgbaStride();
+            input.pixel_format = BEF_AI_PIX_FMT_RGBA8888;
+            input.orient = orientation_.rotateType();
+            input.face_info = faces;
+            input.face_count = faceCount;
+
+            bef_ai_headseg_output output;
+            memset(&output, 0, sizeof(output));
+            int ret = BEF_AI_HSeg_DoHeadSeg(headSegHandler_, &input, &output);
+            CHECK_BEF_AI_RET_SUCCESS(ret, "head seg detect failed ! %d", ret);
+            if (ret != BEF_RESULT_SUC || !output.face_result) {
+                return;
+            }
+
+            // the SDK owns the output buffers until the next call, keep a copy
+            agora_refptr<SegmentationMask> mask = masks_.acquire(MASK_HEAD);
+            mask->resetRegions(output.face_count);
+            for (int i = 0; i < output.face_count; i++) {
+                const bef_ai_headseg_face_result &face = output.face_result[i];
+                MaskRegion &region = mask->region(i);
+                region.id = face.face_id;
+                region.width = face.width;
+                region.height = face.height;
+                region.channels = face.channel;
+                memcpy(region.matrix, face.matrix, sizeof(region.matrix));
+                region.alpha.assign(face.alpha, face.alpha + (size_t)face.width * face.height * face.channel);
+            }
+            mask->timestampMs = frameTimestampMs_;
+            masks_.publish(MASK_HEAD, mask);
+        }
+
+        void ByteDanceProcessor::processFaceVerify() {
+            if (!faceVerifyHandler_) {
+                bef_effect_result_t ret;
+                ret = bef_effect_ai_face_verify_create(faceVerifyModelPath_.c_str(), BEF_MAX_FACE_NUM,
+                                                       &faceVerifyHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processFaceVerify create face verify handle failed ! %d",
+                                         ret);
+                if (!faceVerifyHandler_) {
+                    return;
+                }
+
+                CHECK_LICENSE(ret, bef_effect_ai_face_verify_check_license, faceVerifyHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processFaceVerify check_license face verify failed ! %d",
+                                         ret);
+            }
+
+            const bef_ai_face_info &faceInfo = analysis_.faceInfo;
+
+            bef_effect_result_t ret;
+            if (!pendingEnrollName_.empty() && faceInfo.face_count > 0) {
+                // enroll the most prominent face
+                int largest = 0;
+                int largestArea = -1;
+                for (int i = 0; i < faceInfo.face_count; i++) {
+                    const bef_ai_rect &rect = faceInfo.base_infos[i].rect;
+                    int area = (rect.right - rect.left) * (rect.bottom - rect.top);
+                    if (area > largestArea) {
+                        largest = i;
+                        largestArea = area;
+                    }
+                }
+                ret = bef_effect_ai_face_extract_feature_single(faceVerifyHandler_, rgbaBuffer_,
+                                                                BEF_AI_PIX_FMT_RGBA8888,
+                                                                rgbaWidth(), prevFrame_.height,
+                                                                rgbaStride(),
+                                                                orientation_.rotateType(),
+                                                                &faceInfo.base_infos[largest],
+                                                                faceFeature_);
+                CHECK_BEF_AI_RET_SUCCESS(ret, "face verify enroll extract feature failed ! %d", ret);
+                if (ret == BEF_RESULT_SUC) {
+                    faceGallery_.enroll(pendingEnrollName_, faceFeature_);
+                    PRINTF_INFO("face verify enrolled %s, gallery size %d",
+                                pendingEnrollName_.c_str(), faceGallery_.size());
+                    faceIdentities_.clear();
+                }
+                pendingEnrollName_.clear();
+            }
+
+            bool changed = false;
+            nextFaceIdentities_.clear();
+            for (int i = 0; i < faceInfo.face_count; i++) {
+                const bef_ai_face_106 &face = faceInfo.base_infos[i];
+                const FaceIdentity *known = nullptr;
+                for (const FaceIdentity &identity : faceIdentities_) {
+                    if (identity.faceId == face.ID) {
+                        known = &identity;
+                        break;
+                    }
+                }
+                if (known) {
+                    nextFaceIdentities_.push_back(*known);
+                    continue;
+                }
+
+                // new track: one feature extraction for its whole lifetime
+                FaceIdentity identity = {face.ID, -1, 0.0f};
+                if (faceGallery_.size() > 0) {
+                    ret = bef_effect_ai_face_extract_feature_single(faceVerifyHandler_, rgbaBuffer_,
+                                                                    BEF_AI_PIX_FMT_RGBA8888,
+                                                                    rgbaWidth(),
+                                                                    prevFrame_.height,
+                                                                    rgbaStride(),
+                                                                    orientation_.rotateType(), &face,
+                                                                    faceFeature_);
+                    CHECK_BEF_AI_RET_SUCCESS(ret, "face verify extract feature failed ! %d", ret);
+                    if (ret == BEF_RESULT_SUC) {
+                        identity.galleryIndex = faceGallery_.match(faceFeature_, faceVerifyThreshold_,
+                                                                   &identity.similarity);
+                    }
+                }
+                nextFaceIdentities_.push_back(identity);
+                changed = true;
+            }
+            changed = changed || nextFaceIdentities_.size() != faceIdentities_.size();
+            faceIdentities_.swap(nextFaceIdentities_);
+            if (!changed) {
+                return;
+            }
+
+            EventJson& event = EventJson::begin();
+            rapidjson::StringBuffer& strBuf = event.buffer;
+            rapidjson::Writer<rapidjson::StringBuffer>& writer = event.writer;
+            writer.SetMaxDecimalPlaces(3);
+            writer.StartObject();
+            writer.Key("timestamp");
+            writer.Int64(frameTimestampMs_);
+            writer.Key("plugin.bytedance.faceVerify.info");
+            writer.StartArray();
+            for (const FaceIdentity &identity : faceIdentities_) {
+                writer.StartObject();
+                writer.Key("id");
+                writer.Int(identity.faceId);
+                writer.Key("name");
+                writer.String(identity.galleryIndex >= 0 ?
+                              faceGallery_.name(identity.galleryIndex).c_str() : "");
+                writer.Key("similarity");
+                writer.Double(identity.similarity);
+                writer.EndObject();
+            }
+            writer.EndArray();
+            writer.EndObject();
+            const char* text = strBuf.GetString();
+            dataCallback(text);
+        }
+
+        void ByteDanceProcessor::processPetFaceDetect() {
+            if (!petFaceHandler_) {
+                bef_effect_result_t ret;
+                ret = bef_effect_ai_pet_face_create(petFaceModelPath_.c_str(),
+                                                    BEF_DetCat | BEF_DetDog | BEF_QuickMode,
+                                                    AI_MAX_PET_NUM, &petFaceHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processPetFaceDetect create pet face handle failed ! %d",
+                                         ret);
+                if (!petFaceHandler_) {
+                    return;
+                }
+
+                CHECK_LICENSE(ret, bef_effect_ai_pet_face_check_license, petFaceHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processPetFaceDetect check_license pet face failed ! %d",
+                                         ret);
+            }
+
+            // the result struct is large, it lives in the processor instead of the stack
+            bef_effect_result_t ret;
+            ret = bef_effect_ai_pet_face_detect(petFaceHandler_, rgbaBuffer_, BEF_AI_PIX_FMT_RGBA8888,
+                                                rgbaWidth(), prevFrame_.height,
+                                                rgbaStride(), orientation_.rotateType(),
+                                                &petFaceResult_);
+            CHECK_BEF_AI_RET_SUCCESS(ret, "pet face detect failed ! %d", ret);
+            int count = ret == BEF_RESULT_SUC ? std::min(petFaceResult_.face_count, AI_MAX_PET_NUM) : 0;
+
+            EventJson& event = EventJson::begin();
+            rapidjson::StringBuffer& strBuf = event.buffer;
+            rapidjson::Writer<rapidjson::StringBuffer>& writer = event.writer;
+            writer.SetMaxDecimalPlaces(3);
+            writer.StartObject();
+            writer.Key("timestamp");
+            writer.Int64(frameTimestampMs_);
+            writer.Key("plugin.bytedance.petFace.info");
+            writer.StartArray();
+            for (int i = 0; i < count; i++) {
+                const bef_ai_pet_face_info &face = petFaceResult_.p_faces[i];
+                writer.StartObject();
+                writer.Key("id");
+                writer.Int(face.id);
+                writer.Key("type");
+                writer.Int(face.type);
+                bef_ai_rect rect = orientation_.toDisplay(face.rect);
+                writer.Key("rect");
+                writer.StartArray();
+                writer.Int(rect.left);
+                writer.Int(rect.top);
+                writer.Int(rect.right);
+                writer.Int(rect.bottom);
+                writer.EndArray();
+                writer.Key("action");
+                writer.Uint(face.action);
+                writer.Key("yaw");
+                writer.Double(face.yaw);
+                writer.Key("pitch");
+                writer.Double(face.pitch);
+                writer.Key("roll");
+                writer.Double(face.roll);
+                writer.EndObject();
+            }
+            writer.EndArray();
+            writer.EndObject();
+            const char* text = strBuf.GetString();
+            dataCallback(text);
+        }
+
+        void ByteDanceProcessor::processDynamicActionDetect() {
+            if (!dynamicActionHandler_) {
+                bef_effect_result_t ret;
+                ret = bef_effect_ai_dynamic_action_create(&dynamicActionHandler_, 0);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processDynamicActionDetect create dynamic action handle failed ! %d",
+                                         ret);
+                if (!dynamicActionHandler_) {
+                    return;
+                }
+
+                CHECK_LICENSE(ret, bef_effect_ai_dynamic_action_check_license, dynamicActionHandler_);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processDynamicActionDetect check_license dynamic action failed ! %d",
+                                         ret);
+
+                ret = bef_effect_ai_dynamic_action_load_model(dynamicActionHandler_,
+                                                              BEF_AI_DYNAMIC_ACTION_MODEL_SK,
+                                                              dynamicActionModelPath_.c_str());
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processDynamicActionDetect load model failed ! %d path: %s",
+                                         ret, dynamicActionModelPath_.c_str());
+
+                ret = bef_effect_ai_dynamic_action_set_param(dynamicActionHandler_,
+                                                             BEF_AI_DYNAMIC_ACTION_MAX_PERSON_NUM,
+                                                             BEF_AI_MAX_SKELETON_NUM);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processDynamicActionDetect set max person num failed ! %d",
+                                         ret);
+            }
+
+            bef_effect_result_t ret;
+            ret = bef_effect_ai_dynamic_action_detect(dynamicActionHandler_, rgbaBuffer_,
+                                                      BEF_AI_PIX_FMT_RGBA8888,
+                                                      rgbaWidth(), prevFrame_.height,
+                                                      rgbaStride(),
+                                                      orientation_.rotateType(),
+                                                      BEF_AI_DYNAMIC_ACTION_MODEL_SK, 0,
+                                                      &dynamicActionResult_, &dynamicActionSkeleton_);
+            CHECK_BEF_AI_RET_SUCCESS(ret, "dynamic action detect failed ! %d", ret);
+            int count = ret == BEF_RESULT_SUC ?
+                        std::min(dynamicActionResult_.person_count,
+                                 BEF_AI_DYNAMIC_ACTION_MAX_PERSON_NUM_ALLOWED) : 0;
+
+            EventJson& event = EventJson::begin();
+            rapidjson::StringBuffer& strBuf = event.buffer;
+            rapidjson::Writer<rapidjson::StringBuffer>& writer = event.writer;
+            writer.SetMaxDecimalPlaces(3);
+            writer.StartObject();
+            writer.Key("timestamp");
+            writer.Int64(frameTimestampMs_);
+            writer.Key("plugin.bytedance.dynamicAction.info");
+            writer.StartArray();
+            for (int i = 0; i < count; i++) {
+                const bef_ai_dynamic_action_info &person = dynamicActionResult_.p_persons[i];
+                writer.StartObject();
+                writer.Key("id");
+                writer.Int(person.id);
+                writer.Key("action");
+                writer.Uint(person.action);
+                writer.Key("duration");
+                writer.Uint(person.action_duration);
+                writer.Key("score");
+                writer.Double(person.action_score);
+                bef_ai_rect rect = orientation_.toDisplay(person.rect);
+                writer.Key("rect");
+                writer.StartArray();
+                writer.Int(rect.left);
+                writer.Int(rect.top);
+                writer.Int(rect.right);
+                writer.Int(rect.bottom);
+                writer.EndArray();
+                writer.EndObject();
+            }
+            writer.EndArray();
+            writer.EndObject();
+            const char* text = strBuf.GetString();
+            dataCallback(text);
+        }
+
+        bool ByteDanceProcessor::hasEnrolledFace() const {
+            for (const FaceIdentity &identity : faceIdentities_) {
+                if (identity.galleryIndex >= 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool ByteDanceProcessor::isPortraitMattingDue() {
+            if (background_.mode() == BACKGROUND_NONE) {
+                return false;
+            }
+            if (background_.hasMask() && ++framesSinceMatting_ < portraitMattingInterval_) {
+                return false;
+            }
+            framesSinceMatting_ = 0;
+            return true;
+        }
+
+        bool ByteDanceProcessor::isPresenceAnalysisDue() {
+            if (!activityGatingEnabled_) {
+                return true;
+            }
+            // without audio we cannot tell silence from a missing microphone
+            ActivityBus& bus = ActivityBus::getInstance();
+            int interval = (!bus.hasAudio() || bus.isSpeaking()) ? speakingInterval_ : silentInterval_;
+            return isDue(frameIndex_, interval);
+        }
+
+        void ByteDanceProcessor::planFrame() {
+            frameIndex_++;
+            analysis_.reset(frameIndex_, frameTimestampMs_);
+            schedule_.presence = isPresenceAnalysisDue();
+            schedule_.matting = isPortraitMattingDue();
+            schedule_.petFace = petFaceEnabled_ && isDue(frameIndex_, petFaceInterval_);
+            schedule_.dynamicAction = dynamicActionEnabled_ && isDue(frameIndex_, dynamicActionInterval_);
+        }
+
+        void ByteDanceProcessor::buildFrameGraph(const agora::media::base::VideoFrame &capturedFrame) {
+            graph_.reset();
+            graph_.setProvider(ANALYSIS_RGBA, ANALYSIS_I420,
+                               [this, &capturedFrame] { prepareCachedVideoFrame(capturedFrame); });
+            graph_.setProvider(ANALYSIS_FACE, ANALYSIS_RGBA, [this] { detectFaces(); });
+            graph_.setProvider(ANALYSIS_FACE_ATTRIBUTE, ANALYSIS_RGBA | ANALYSIS_FACE,
+                               [this] { detectFaceAttributes(); });
+
+            if (faceAttributeEnabled_ && schedule_.presence) {
+                graph_.addStage(ANALYSIS_RGBA | ANALYSIS_FACE | ANALYSIS_FACE_ATTRIBUTE, 0,
+                                [this] { processFaceDetect(); });
+            } else if (faceAttributeEnabled_ && smoothingEnabled_) {
+                // skipped frame: extrapolate the last faces instead of detecting
+                graph_.addStage(0, 0, [this] { predictFaces(); });
+            }
+
+            if (humanDistanceEnabled_ && schedule_.presence) {
+                graph_.addStage(ANALYSIS_RGBA | ANALYSIS_FACE | ANALYSIS_FACE_ATTRIBUTE, 0,
+                                [this] { processHumanDistance(); });
+            }
+
+            if (handDetectEnabled_ && schedule_.presence) {
+                graph_.addStage(ANALYSIS_RGBA, 0, [this] { processHandDetect(); });
+            } else if (handDetectEnabled_ && smoothingEnabled_) {
+                graph_.addStage(0, 0, [this] { predictHands(); });
+            }
+
+            if (lightDetectEnabled_) {
+                graph_.addStage(ANALYSIS_RGBA, 0, [this] { processLightDetect(); });
+            }
+
+            if (skeletonDetectEnabled_) {
+                graph_.addStage(ANALYSIS_RGBA, 0, [this] { processSkeletonDetect(); });
+            }
+
+            if (hairParseEnabled_) {
+                graph_.addStage(ANALYSIS_RGBA, 0, [this] { processHairParse(); });
+            }
+
+            if (headSegEnabled_) {
+                graph_.addStage(ANALYSIS_RGBA | ANALYSIS_FACE, 0, [this] { processHeadSeg(); });
+            }
+
+            if (faceVerifyEnabled_) {
+                graph_.addStage(ANALYSIS_RGBA | ANALYSIS_FACE, ANALYSIS_FACE_IDENTITY,
+                                [this] { processFaceVerify(); });
+            }
+
+            if (schedule_.petFace) {
+                graph_.addStage(ANALYSIS_RGBA, 0, [this] { processPetFaceDetect(); });
+            }
+
+            if (schedule_.dynamicAction) {
+                graph_.addStage(ANALYSIS_RGBA, 0, [this] { processDynamicActionDetect(); });
+            }
+
+            if (schedule_.matting) {
+                graph_.addStage(ANALYSIS_RGBA, ANALYSIS_PORTRAIT_MASK,
+                                [this] { processPortraitMatting(); });
+            }
+
+            if (analysisOnly_) {
+                return;
+            }
+
+            // the effect overwrites the RGBA copy, so it waits for every analyzer reading it
+            if (aiEffectEnabled_) {
+                unsigned int inputs = ANALYSIS_I420 | ANALYSIS_RGBA;
+                if (beautyEnrolledOnly_) {
+                    inputs |= ANALYSIS_FACE_IDENTITY;
+                }
+                graph_.addStage(inputs, ANALYSIS_I420 | ANALYSIS_RGBA, [this, &capturedFrame] {
+                    if (!beautyEnrolledOnly_ || hasEnrolledFace()) {
+                        processEffect(capturedFrame);
+                    } else {
+                        // this frame goes out as captured, older frames in flight would go out after it
+                        dropReadback();
+                    }
+                }, AnalysisGraph::STAGE_CALLER_THREAD);
+            }
+
+            if (background_.mode() != BACKGROUND_NONE) {
+                graph_.addStage(ANALYSIS_I420 | ANALYSIS_PORTRAIT_MASK, ANALYSIS_I420,
+                                [this, &capturedFrame] { background_.apply(capturedFrame); });
+            }
+        }
+
+        int ByteDanceProcessor::processFrame(const agora::media::base::VideoFrame &capturedFrame) {
+//            PRINTF_INFO("processFrame: w: %d,  h: %d,  r: %d", capturedFrame.width, capturedFrame.height, capturedFrame.rotation);
+            const std::lock_guard<std::mutex> lock(mutex_);
+
+            if (glReleasePending_ && GlContextManager::getInstance().isOwner(glContext_)) {
+                releaseGlOnOwner();
+            }
+            if (aiEffectEnabled_ && !analysisOnly_) {
+                glContext_ = GlContextManager::getInstance().bind(glContext_, capturedFrame.width,
+                                                                  capturedFrame.height);
+            }
+            if (readback_ && readbackContext_ != glContext_) {
+                // the filter moved to another thread, the frames in flight stay with the old context
+                readback_->detach();
+                readback_.reset();
+                readbackContext_ = nullptr;
+            }
+            if (!aiEffectEnabled_ || !gpuReadbackEnabled_ || analysisOnly_) {
+                dropReadback();
+            }
+            hasOutput_ = true;
+            outputTimestampMs_ = capturedFrame.renderTimeMs;
+
+            orientation_.set(capturedFrame.width, capturedFrame.height, capturedFrame.rotation, mirrorResults_);
+            advanceFrameClock(capturedFrame.renderTimeMs);
+            runFrame(capturedFrame);
+            return 0;
+        }
+
+        void ByteDanceProcessor::advanceFrameClock(int64_t renderTimeMs) {
+            frameTime_ = frameClock_.tick(renderTimeMs);
+            frameTimestampMs_ = frameTime_.timestampMs;
+            if (frameTime_.discontinuity) {
+                // tracks from before a stall or a rewind do not continue into this frame
+                faceSmoother_.clear();
+                handSmoother_.clear();
+            }
+        }
+
+        void ByteDanceProcessor::runFrame(const agora::media::base::VideoFrame &capturedFrame) {
+            planFrame();
+            buildFrameGraph(capturedFrame);
+            std::shared_ptr<WorkerPool> workers = shared_->workers();
+            if (stageEvents_.empty()) {
+                stageEvents_.resize(AnalysisGraph::kMaxStages);
+            }
+            graph_.run(workers.get());
+            flushStageEvents();
+            graph_.reset();
+        }
+
+        unsigned int ByteDanceProcessor::processTexture(const TextureFrame &frame) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (!texturePipeline_) {
+                textureSource_ = createGlTextureFrameSource();
+                if (!textureSource_) {
+                    return frame.textureId;
+                }
+                texturePipeline_.reset(new TexturePipeline(textureSource_.get()));
+                textureThread_ = std::this_thread::get_id();
+            }
+            // the effect may run before the CPU stages, both see this frame's time
+            orientation_.set(frame.width, frame.height, frame.rotation, mirrorResults_);
+            advanceFrameClock(frame.renderTimeMs);
+
+            TextureNeeds needs;
+            needs.effect = aiEffectEnabled_ && !analysisOnly_;
+            needs.analysis = needsCpuAnalysis();
+            needs.cpuWriters = !analysisOnly_ && (background_.mode() != BACKGROUND_NONE ||
+                                                  (aiEffectEnabled_ && beautyEnrolledOnly_));
+
+            TexturePipeline::Stages stages;
+            stages.effect = [this, &frame](unsigned int source, unsigned int target) {
+                // the caller's context is current, the effect handle lives in it
+                prepareEffect(frame.width, frame.height);
+                double timestamp = frameTimestampMs_;
+                bef_effect_result_t ret = bef_effect_ai_algorithm_texture(byteEffectHandler_, source, timestamp);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processTexture ai algorithm texture failed %d",
+                                         ret);
+                if (ret != BEF_RESULT_SUC) {
+                    return false;
+                }
+                ret = bef_effect_ai_process_texture(byteEffectHandler_, source, target, timestamp);
+                CHECK_BEF_AI_RET_SUCCESS(ret,
+                                         "ByteDanceProcessor::processTexture ai process texture failed %d",
+                                         ret);
+                return ret == BEF_RESULT_SUC;
+            };
+            stages.cpu = [this, &frame](uint8_t* rgba, int width, int height, bool analysisOnly) {
+                processTextureOnCpu(rgba, width, height, frame.renderTimeMs, analysisOnly);
+            };
+            return texturePipeline_->run(frame, needs, stages);
+        }
+
+        void ByteDanceProcessor::processTextureOnCpu(uint8_t* rgba, int width, int height, int64_t renderTimeMs,
+                                                     bool analysisOnly) {
+            int ysize = width * height;
+            int usize = (width / 2) * (height / 2);
+            textureI420_.resize(ysize + 2 * usize);
+            cvt_rgba2yuv(rgba, textureI420_.data(), BEF_AI_PIX_FMT_YUV420P, width, height);
+
+            agora::media::base::VideoFrame cpuFrame;
+            cpuFrame.type = agora::media::base::VIDEO_PIXEL_I420;
+            cpuFrame.width = width;
+            cpuFrame.height = height;
+            cpuFrame.yStride = width;
+            cpuFrame.uStride = width / 2;
+            cpuFrame.vStride = width / 2;
+            cpuFrame.yBuffer = textureI420_.data();
+            cpuFrame.uBuffer = textureI420_.data() + ysize;
+            cpuFrame.vBuffer = textureI420_.data() + ysize + usize;
+            cpuFrame.renderTimeMs = renderTimeMs;
+
+            bool wasAnalysisOnly = analysisOnly_;
+            analysisOnly_ = wasAnalysisOnly || analysisOnly;
+            // the analyzers get the readback itself rather than the I420 view converted back
+            textureRgba_ = rgba;
+            runFrame(cpuFrame);
+            textureRgba_ = nullptr;
+            analysisOnly_ = wasAnalysisOnly;
+
+            if (!analysisOnly) {
+                cvt_yuv2rgba(textureI420_.data(), rgba, BEF_AI_PIX_FMT_YUV420P, width, height, width, height,
+                             BEF_AI_CLOCKWISE_ROTATE_0, false);
+            }
+        }
+
+        bool ByteDanceProcessor::needsCpuAnalysis() const {
+            return faceAttributeEnabled_ || humanDistanceEnabled_ || handDetectEnabled_ || lightDetectEnabled_ ||
+                   skeletonDetectEnabled_ || hairParseEnabled_ || headSegEnabled_ || faceVerifyEnabled_ ||
+                   petFaceEnabled_ || dynamicActionEnabled_;
+        }
+
+        void ByteDanceProcessor::releaseTextureResources() {
+            // the texture path renders the effect in the caller's context, so its handle goes too
+            if (byteEffectHandler_) {
+                bef_effect_ai_destroy(byteEffectHandler_);
+                byteEffectHandler_ = nullptr;
+                aiEffectNeedUpdate_ = true;
+            }
+            texturePipeline_->reset();
+            textureSource_->release();
+            texturePipeline_.reset();
+            textureSource_.reset();
+        }
+
+
+        int ByteDanceProcessor::releaseEffectEngine() {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (byteEffectHandler_) {
+                bef_effect_ai_destroy(byteEffectHandler_);
+                byteEffectHandler_ = nullptr;
+            }
+            aiEffectEnabled_ = false;
+            licensePath_.clear();
+            modelDir_.clear();
+
+            if (aiNodes_) {
+                for (SizeType i = 0; i < aiNodeCount_; i++) {
+                    free(aiNodes_[i]);
+                }
+                free(aiNodes_);
+                aiNodes_ = nullptr;
+            }
+            aiNodeIntensities_.clear();
+            aiNodeKeys_.clear();
+            aiNodeCount_ = 0;
+            aiEffectNeedUpdate_ = false;
+
+            faceStickerEnabled_ = false;
+            faceStickerItemPath_.clear();
+
+            if (yuvBuffer_) {
+                free(yuvBuffer_);
+                yuvBuffer_ = nullptr;
+            }
+            if (rgbaBuffer_) {
+                free(rgbaBuffer_);
+                rgbaBuffer_ = nullptr;
+            }
+
+            faceAttributeEnabled_ = false;
+            faceSmoother_.clear();
+            handSmoother_.clear();
+            faceRoi_.reset();
+            handRoi_.reset();
+            faceDetectModelPath_.clear();
+            faceAttributeModelPath_.clear();
+            if (faceDetectHandler_) {
+                bef_effect_ai_face_detect_destroy(faceDetectHandler_);
+                faceDetectHandler_ = nullptr;
+            }
+            if (faceAttributesHandler_) {
+                bef_effect_ai_face_attribute_destroy(faceAttributesHandler_);
+                faceAttributesHandler_ = nullptr;
+            }
+
+            humanDistanceEnabled_ = false;
+            humanDistanceModelPath_.clear();
+            if (humanDistanceHandler_) {
+                bef_effect_ai_human_distance_destroy(humanDistanceHandler_);
+                humanDistanceHandler_ = nullptr;
+            }
+
+            handDetectEnabled_ = false;
+            handDetectModelPath_.clear();
+            handBoxModelPath_.clear();
+            handGestureModelPath_.clear();
+            handKPModelPath_.clear();
             if (handDetectHandler_) {
                 bef_effect_ai_hand_detect_destroy(handDetectHandler_);
+                handDetectHandler_ = nullptr;
             }
 
             lightDetectEnabled_ = false;
             lightDetectModelPath_.clear();
             if (lightDetectHandler_) {
                 bef_effect_ai_lightcls_release(lightDetectHandler_);
+                lightDetectHandler_ = nullptr;
+            }
+
+            skeletonDetectEnabled_ = false;
+            skeletonModelPath_.clear();
+            if (skeletonHandler_) {
+                bef_effect_ai_skeleton_destroy(skeletonHandler_);
+                skeletonHandler_ = nullptr;
             }
 
+            faceVerifyEnabled_ = false;
+            faceVerifyModelPath_.clear();
+            beautyEnrolledOnly_ = false;
+            if (faceVerifyHandler_) {
+                bef_effect_ai_face_verify_destroy(faceVerifyHandler_);
+                faceVerifyHandler_ = nullptr;
+            }
+            faceGallery_.clear();
+            pendingEnrollName_.clear();
+            faceIdentities_.clear();
+
+            petFaceEnabled_ = false;
+            petFaceModelPath_.clear();
+            if (petFaceHandler_) {
+                bef_effect_ai_pet_face_release(petFaceHandler_);
+                petFaceHandler_ = nullptr;
+            }
+
+            dynamicActionEnabled_ = false;
+            dynamicActionModelPath_.clear();
+            if (dynamicActionHandler_) {
+                bef_effect_ai_dynamic_action_release(dynamicActionHandler_);
+                dynamicActionHandler_ = nullptr;
+            }
+
+            hairParseEnabled_ = false;
+            hairParserModelPath_.clear();
+            if (hairParserHandler_) {
+                bef_effect_ai_hairparser_destroy(hairParserHandler_);
+                hairParserHandler_ = nullptr;
+            }
+
+            headSegEnabled_ = false;
+            headSegModelPath_.clear();
+            headSegModelBuffer_.reset();
+            headSegModelSeen_.reset();
+            headSegModelChanged_ = false;
+            if (headSegHandler_) {
+                BEF_AI_HSeg_ReleaseHandle(headSegHandler_);
+                headSegHandler_ = 0;
+            }
+
+            portraitMattingModelPath_.clear();
+            if (portraitMattingHandler_) {
+                bef_effect_ai_portrait_matting_destroy(portraitMattingHandler_);
+                portraitMattingHandler_ = nullptr;
+            }
+            framesSinceMatting_ = 0;
+            background_.reset();
+            masks_.clear();
+
             return 0;
         }
 
@@ -570,10 +1898,11 @@ namespace agora {
                 }
 
                 if (aiNodes_) {
-                    for (int i = 0; i < aiNodeCount_; i++) {
+                    for (SizeType i = 0; i < aiNodeCount_; i++) {
                         free(aiNodes_[i]);
                     }
                     free(aiNodes_);
+                    aiNodes_ = nullptr;
                 }
                 aiNodeIntensities_.clear();
                 aiNodeKeys_.clear();
@@ -594,7 +1923,7 @@ namespace agora {
                             const char *path = vPath.GetString();
                             size_t strLength = strlen(path);
                             aiNodes_[i] = (char *) malloc((strLength + 1) * sizeof(char *));
-                            strncpy(aiNodes_[i], path, strLength);
+                            memcpy(aiNodes_[i], path, strLength);
                             aiNodes_[i][strLength] = '\0';
                             aiNodeKeys_.push_back(vKey.GetString());
                             aiNodeIntensities_.push_back(vIntensity.GetFloat());
@@ -631,6 +1960,35 @@ namespace agora {
                 faceAttributeModelPath_ = std::string(attributeModelPath.GetString());
             }
 
+            if (d.HasMember("plugin.bytedance.humanDistanceEnabled")) {
+                Value& enabled = d["plugin.bytedance.humanDistanceEnabled"];
+                if (!enabled.IsBool()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                humanDistanceEnabled_ = enabled.GetBool();
+            }
+
+            if (d.HasMember("plugin.bytedance.humanDistanceModelPath")) {
+                Value& path = d["plugin.bytedance.humanDistanceModelPath"];
+                if (!path.IsString()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                humanDistanceModelPath_ = std::string(path.GetString());
+            }
+
+            if (d.HasMember("plugin.bytedance.humanDistanceCameraFov")) {
+                Value& fov = d["plugin.bytedance.humanDistanceCameraFov"];
+                if (!fov.IsNumber()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                humanDistanceCameraFov_ = fov.GetFloat();
+                if (humanDistanceHandler_ && humanDistanceCameraFov_ > 0) {
+                    bef_effect_ai_human_distance_setparam(humanDistanceHandler_,
+                                                          BEF_HumanDistanceCameraFov,
+                                                          humanDistanceCameraFov_);
+                }
+            }
+
             if (d.HasMember("plugin.bytedance.faceStickerEnabled")) {
                 Value& enabled = d["plugin.bytedance.faceStickerEnabled"];
                 if (!enabled.IsBool()) {
@@ -703,6 +2061,359 @@ namespace agora {
                 lightDetectModelPath_ = std::string(path.GetString());
             }
 
+            if (d.HasMember("plugin.bytedance.skeletonDetectEnabled")) {
+                Value& enabled = d["plugin.bytedance.skeletonDetectEnabled"];
+                if (!enabled.IsBool()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                skeletonDetectEnabled_ = enabled.GetBool();
+            }
+
+            if (d.HasMember("plugin.bytedance.skeletonModelPath")) {
+                Value& path = d["plugin.bytedance.skeletonModelPath"];
+                if (!path.IsString()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                skeletonModelPath_ = std::string(path.GetString());
+            }
+
+            if (d.HasMember("plugin.bytedance.skeletonTrackingInputSize")) {
+                Value& size = d["plugin.bytedance.skeletonTrackingInputSize"];
+                if (!size.IsArray() || size.Size() != 2 || !size[0].IsInt() || !size[1].IsInt() ||
+                    size[0].GetInt() <= 0 || size[1].GetInt() <= 0) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                skeletonTrackingWidth_ = size[0].GetInt();
+                skeletonTrackingHeight_ = size[1].GetInt();
+                skeletonNeedUpdate_ = true;
+            }
+
+            if (d.HasMember("plugin.bytedance.faceVerifyEnabled")) {
+                Value& enabled = d["plugin.bytedance.faceVerifyEnabled"];
+                if (!enabled.IsBool()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                faceVerifyEnabled_ = enabled.GetBool();
+                faceIdentities_.clear();
+            }
+
+            if (d.HasMember("plugin.bytedance.faceVerifyModelPath")) {
+                Value& path = d["plugin.bytedance.faceVerifyModelPath"];
+                if (!path.IsString()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                faceVerifyModelPath_ = std::string(path.GetString());
+            }
+
+            if (d.HasMember("plugin.bytedance.faceVerifyThreshold")) {
+                Value& threshold = d["plugin.bytedance.faceVerifyThreshold"];
+                if (!threshold.IsNumber()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                faceVerifyThreshold_ = threshold.GetFloat();
+                faceIdentities_.clear();
+            }
+
+            if (d.HasMember("plugin.bytedance.faceVerifyEnroll")) {
+                Value& name = d["plugin.bytedance.faceVerifyEnroll"];
+                if (!name.IsString() || name.GetStringLength() == 0) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                pendingEnrollName_ = std::string(name.GetString());
+            }
+
+            if (d.HasMember("plugin.bytedance.faceVerifyRemove")) {
+                Value& name = d["plugin.bytedance.faceVerifyRemove"];
+                if (!name.IsString()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                if (faceGallery_.remove(name.GetString())) {
+                    faceIdentities_.clear();
+                }
+            }
+
+            if (d.HasMember("plugin.bytedance.faceVerifyClear")) {
+                Value& clear = d["plugin.bytedance.faceVerifyClear"];
+                if (!clear.IsBool()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                if (clear.GetBool()) {
+                    faceGallery_.clear();
+                    faceIdentities_.clear();
+                }
+            }
+
+            if (d.HasMember("plugin.bytedance.beautyEnrolledOnly")) {
+                Value& enabled = d["plugin.bytedance.beautyEnrolledOnly"];
+                if (!enabled.IsBool()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                beautyEnrolledOnly_ = enabled.GetBool();
+            }
+
+            if (d.HasMember("plugin.bytedance.petFaceEnabled")) {
+                Value& enabled = d["plugin.bytedance.petFaceEnabled"];
+                if (!enabled.IsBool()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                petFaceEnabled_ = enabled.GetBool();
+            }
+
+            if (d.HasMember("plugin.bytedance.petFaceModelPath")) {
+                Value& path = d["plugin.bytedance.petFaceModelPath"];
+                if (!path.IsString()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                petFaceModelPath_ = std::string(path.GetString());
+            }
+
+            if (d.HasMember("plugin.bytedance.petFaceInterval")) {
+                Value& interval = d["plugin.bytedance.petFaceInterval"];
+                if (!interval.IsInt()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                petFaceInterval_ = std::max(1, interval.GetInt());
+            }
+
+            if (d.HasMember("plugin.bytedance.dynamicActionEnabled")) {
+                Value& enabled = d["plugin.bytedance.dynamicActionEnabled"];
+                if (!enabled.IsBool()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                dynamicActionEnabled_ = enabled.GetBool();
+            }
+
+            if (d.HasMember("plugin.bytedance.dynamicActionModelPath")) {
+                Value& path = d["plugin.bytedance.dynamicActionModelPath"];
+                if (!path.IsString()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                dynamicActionModelPath_ = std::string(path.GetString());
+            }
+
+            if (d.HasMember("plugin.bytedance.dynamicActionInterval")) {
+                Value& interval = d["plugin.bytedance.dynamicActionInterval"];
+                if (!interval.IsInt()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                dynamicActionInterval_ = std::max(1, interval.GetInt());
+            }
+
+            if (d.HasMember("plugin.bytedance.hairParseEnabled")) {
+                Value& enabled = d["plugin.bytedance.hairParseEnabled"];
+                if (!enabled.IsBool()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                hairParseEnabled_ = enabled.GetBool();
+            }
+
+            if (d.HasMember("plugin.bytedance.hairParserModelPath")) {
+                Value& path = d["plugin.bytedance.hairParserModelPath"];
+                if (!path.IsString()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                hairParserModelPath_ = std::string(path.GetString());
+            }
+
+            if (d.HasMember("plugin.bytedance.headSegEnabled")) {
+                Value& enabled = d["plugin.bytedance.headSegEnabled"];
+                if (!enabled.IsBool()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                headSegEnabled_ = enabled.GetBool();
+            }
+
+            if (d.HasMember("plugin.bytedance.headSegModelPath")) {
+                Value& path = d["plugin.bytedance.headSegModelPath"];
+                if (!path.IsString()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                headSegModelPath_ = std::string(path.GetString());
+                headSegModelBuffer_.reset();
+                headSegModelSeen_ = shared_->headSegModel();
+                headSegModelChanged_ = true;
+            }
+
+            if (d.HasMember("plugin.bytedance.backgroundMode")) {
+                Value& mode = d["plugin.bytedance.backgroundMode"];
+                if (!mode.IsString()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                std::string name = mode.GetString();
+                if (name == "blur") {
+                    background_.setMode(BACKGROUND_BLUR);
+                } else if (name == "color") {
+                    background_.setMode(BACKGROUND_COLOR);
+                } else if (name == "none") {
+                    background_.setMode(BACKGROUND_NONE);
+                } else {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+            }
+
+            if (d.HasMember("plugin.bytedance.portraitMattingModelPath")) {
+                Value& path = d["plugin.bytedance.portraitMattingModelPath"];
+                if (!path.IsString()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                portraitMattingModelPath_ = std::string(path.GetString());
+            }
+
+            if (d.HasMember("plugin.bytedance.portraitMattingInterval")) {
+                Value& interval = d["plugin.bytedance.portraitMattingInterval"];
+                if (!interval.IsInt()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                portraitMattingInterval_ = std::max(1, interval.GetInt());
+            }
+
+            if (d.HasMember("plugin.bytedance.backgroundBlurRadius")) {
+                Value& radius = d["plugin.bytedance.backgroundBlurRadius"];
+                if (!radius.IsInt()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                background_.setBlurRadius(radius.GetInt());
+            }
+
+            if (d.HasMember("plugin.bytedance.backgroundColor")) {
+                Value& color = d["plugin.bytedance.backgroundColor"];
+                if (!color.IsUint()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                background_.setColor(color.GetUint());
+            }
+
+            if (d.HasMember("plugin.bytedance.analysisThreadCap")) {
+                Value& cap = d["plugin.bytedance.analysisThreadCap"];
+                if (!cap.IsInt()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                shared_->setAnalysisThreadCap(cap.GetInt());
+            }
+
+            if (d.HasMember("plugin.bytedance.gpuReadback")) {
+                Value& readback = d["plugin.bytedance.gpuReadback"];
+                if (!readback.IsObject()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                if (readback.HasMember("enabled")) {
+                    if (!readback["enabled"].IsBool()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    gpuReadbackEnabled_ = readback["enabled"].GetBool();
+                }
+                if (readback.HasMember("depth")) {
+                    if (!readback["depth"].IsInt()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    gpuReadbackDepth_ = std::max(1, std::min((int)ReadbackRing::kMaxDepth,
+                                                             readback["depth"].GetInt()));
+                }
+            }
+
+            if (d.HasMember("plugin.bytedance.roiTracking")) {
+                Value& tracking = d["plugin.bytedance.roiTracking"];
+                if (!tracking.IsObject()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                if (tracking.HasMember("enabled")) {
+                    if (!tracking["enabled"].IsBool()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    roiTrackingEnabled_ = tracking["enabled"].GetBool();
+                    faceRoi_.reset();
+                    handRoi_.reset();
+                }
+                if (tracking.HasMember("fullScanInterval")) {
+                    if (!tracking["fullScanInterval"].IsInt()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    int interval = std::max(1, tracking["fullScanInterval"].GetInt());
+                    faceRoi_.setFullScanInterval(interval);
+                    handRoi_.setFullScanInterval(interval);
+                }
+            }
+
+            if (d.HasMember("plugin.bytedance.mirror")) {
+                Value& mirror = d["plugin.bytedance.mirror"];
+                if (!mirror.IsBool()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                mirrorResults_ = mirror.GetBool();
+            }
+
+            if (d.HasMember("plugin.bytedance.smoothing")) {
+                Value& smoothing = d["plugin.bytedance.smoothing"];
+                if (!smoothing.IsObject()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                OneEuroParams params;
+                if (smoothing.HasMember("enabled")) {
+                    if (!smoothing["enabled"].IsBool()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    smoothingEnabled_ = smoothing["enabled"].GetBool();
+                }
+                if (smoothing.HasMember("minCutoff")) {
+                    if (!smoothing["minCutoff"].IsNumber()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    params.minCutoff = std::max(0.01f, smoothing["minCutoff"].GetFloat());
+                }
+                if (smoothing.HasMember("beta")) {
+                    if (!smoothing["beta"].IsNumber()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    params.beta = std::max(0.0f, smoothing["beta"].GetFloat());
+                }
+                if (smoothing.HasMember("derivativeCutoff")) {
+                    if (!smoothing["derivativeCutoff"].IsNumber()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    params.derivativeCutoff = std::max(0.01f, smoothing["derivativeCutoff"].GetFloat());
+                }
+                faceSmoother_.setParams(params);
+                handSmoother_.setParams(params);
+                if (!smoothingEnabled_) {
+                    faceSmoother_.clear();
+                    handSmoother_.clear();
+                }
+            }
+
+            if (d.HasMember("plugin.bytedance.activityGating")) {
+                Value& gating = d["plugin.bytedance.activityGating"];
+                if (!gating.IsObject()) {
+                    return -ERROR_INVALID_JSON_TYPE;
+                }
+                if (gating.HasMember("enabled")) {
+                    if (!gating["enabled"].IsBool()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    activityGatingEnabled_ = gating["enabled"].GetBool();
+                }
+                if (gating.HasMember("speakingInterval")) {
+                    if (!gating["speakingInterval"].IsInt()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    speakingInterval_ = std::max(1, gating["speakingInterval"].GetInt());
+                }
+                if (gating.HasMember("silentInterval")) {
+                    if (!gating["silentInterval"].IsInt()) {
+                        return -ERROR_INVALID_JSON_TYPE;
+                    }
+                    silentInterval_ = std::max(1, gating["silentInterval"].GetInt());
+                }
+            }
+
+            return 0;
+        }
+
+        int ByteDanceProcessor::setHeadSegModel(const void* data, size_t size) {
+            if (!data || size == 0) {
+                return -ERROR_ERR_PARAMETER;
+            }
+            // picked up by every processor on its next head segmentation frame
+            shared_->setHeadSegModel(data, size);
             return 0;
         }
 
@@ -711,9 +2422,32 @@ namespace agora {
             return id;
         }
 
+        void ByteDanceProcessor::flushStageEvents() {
+            agora::rtc::IExtensionControl* control = shared_->extensionControl();
+            int count = std::min(graph_.stageCount(), (int)stageEvents_.size());
+            for (int i = 0; i < count; i++) {
+                std::string &events = stageEvents_[i];
+                for (size_t start = 0; start < events.size(); start = events.find('\0', start) + 1) {
+                    if (control != nullptr) {
+                        control->fireEvent(vendor_.c_str(), "beauty", events.c_str() + start);
+                    }
+                }
+                events.clear();
+            }
+        }
+
         void ByteDanceProcessor::dataCallback(const char* data){
-            if (control_ != nullptr) {
-                control_->fireEvent(id_, "beauty", data);
+            // stages running in parallel hold their events back until the frame joins
+            int stage = AnalysisGraph::currentStage();
+            if (stage >= 0 && stage < (int)stageEvents_.size()) {
+                std::string &events = stageEvents_[stage];
+                events.append(data);
+                events.push_back('\0');
+                return;
+            }
+            agora::rtc::IExtensionControl* control = shared_->extensionControl();
+            if (control != nullptr) {
+                control->fireEvent(vendor_.c_str(), "beauty", data);
             }
         }
     }
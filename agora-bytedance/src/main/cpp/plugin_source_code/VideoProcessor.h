@@ -5,8 +5,10 @@
 #ifndef AGORAWITHBYTEDANCE_VIDEOPROCESSOR_H
 #define AGORAWITHBYTEDANCE_VIDEOPROCESSOR_H
 
+#include <atomic>
 #include <thread>
 #include <string>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include <AgoraRtcKit/AgoraRefPtr.h>
@@ -15,53 +17,161 @@
 #include "AgoraRtcKit/AgoraMediaBase.h"
 #include "../bytedance/bef_effect_ai_api.h"
 #include "../bytedance/bef_effect_ai_lightcls.h"
+#include "../bytedance/bef_effect_ai_portrait_matting.h"
+#include "../bytedance/bef_effect_ai_skeleton.h"
+#include "../bytedance/bef_effect_ai_hairparser.h"
+#include "../bytedance/bef_effect_ai_headseg.h"
+#include "../bytedance/bef_effect_ai_face_verify.h"
+#include "../bytedance/bef_effect_ai_pet_face.h"
+#include "../bytedance/bef_effect_ai_dynamic_action.h"
+#include "../bytedance/bef_effect_ai_human_distance.h"
 
-#include "EGLCore.h"
+#include "AnalysisGraph.h"
+#include "BackgroundCompositor.h"
+#include "FaceGallery.h"
+#include "FrameAnalysisContext.h"
+#include "FrameClock.h"
+#include "FrameOrientation.h"
+#include "GlContextManager.h"
+#include "MaskCache.h"
+#include "ReadbackRing.h"
+#include "RoiTracker.h"
+#include "SharedVideoResources.h"
+#include "TexturePipeline.h"
+#include "TrackSmoother.h"
+#include "WorkerPool.h"
 #include "rapidjson/rapidjson.h"
 
 namespace agora {
     namespace extension {
         class ByteDanceProcessor  : public RefCountInterface {
         public:
-            bool initOpenGL();
+            explicit ByteDanceProcessor(std::shared_ptr<SharedVideoResources> shared);
 
+            // drops the GL context and effect handle now on the rendering thread, else before its next frame
             bool releaseOpenGL();
 
             int processFrame(const agora::media::base::VideoFrame &capturedFrame);
 
+            /**
+             * Texture in, texture out, on the caller's thread and GL context. Returns
+             * the processed texture, valid until the next call, or the input when
+             * nothing is enabled. A processor is fed either textures or CPU frames;
+             * call releaseOpenGL() on the same thread before the context goes.
+             */
+            unsigned int processTexture(const TextureFrame &frame);
+
             int releaseEffectEngine();
 
             int setParameters(std::string parameter);
 
             std::thread::id getThreadId();
 
-            int setExtensionControl(agora::rtc::IExtensionControl* control){
-                control_ = control;
-                return 0;
-            };
+            // head segmentation model handed over in memory (SetModelFromBuff), shared by every filter
+            int setHeadSegModel(const void* data, size_t size);
 
-            int setExtensionVendor(const char* id){
-                int len = std::string(id).length() + 1;
-                id_ = static_cast<char *>(malloc(len));
-                memset(id_, 0, len);
-                strcpy(id_, id);
-                return 0;
-            };
+            MaskCache& maskCache() { return masks_; }
+
+            // analyzers only: the frame is never written (beauty and background stages are skipped)
+            void setAnalysisOnly(bool analysisOnly) { analysisOnly_ = analysisOnly; }
+
+            // false while the readback ring fills up, the frame holds no effect output yet
+            bool hasOutput() const { return hasOutput_; }
+
+            // renderTimeMs of the pixels the last processFrame() left in the frame
+            int64_t outputTimestampMs() const { return outputTimestampMs_; }
         protected:
-            ~ByteDanceProcessor() {}
+            ~ByteDanceProcessor();
         private:
             void dataCallback(const char* data);
+            void flushStageEvents();
+            void detectFaces();
+            void detectFaceAttributes();
             void processFaceDetect();
+            void predictFaces();
+            void emitFaceEvent(const TrackSmoother::Sample* faces, int count);
+            void processHumanDistance();
             void processHandDetect();
+            void predictHands();
+            void emitHandEvent(const TrackSmoother::Sample* hands, int count);
             void processLightDetect();
+            void processPortraitMatting();
+            void processSkeletonDetect();
+            void processHairParse();
+            void processHeadSeg();
+            void processFaceVerify();
+            void processPetFaceDetect();
+            void processDynamicActionDetect();
+            bool hasEnrolledFace() const;
+            void writeBackEffect(const agora::media::base::VideoFrame &capturedFrame);
             void processEffect(const agora::media::base::VideoFrame &capturedFrame);
+            void processEffectOnGpu(const agora::media::base::VideoFrame &capturedFrame, double timestamp);
+            void dropReadback();
+            void prepareEffect(int width, int height);
+            void advanceFrameClock(int64_t renderTimeMs);
+            void runFrame(const agora::media::base::VideoFrame &capturedFrame);
+            void processTextureOnCpu(uint8_t* rgba, int width, int height, int64_t renderTimeMs, bool analysisOnly);
+            bool needsCpuAnalysis() const;
+            void releaseTextureResources();
             void prepareCachedVideoFrame(const agora::media::base::VideoFrame &capturedFrame);
+            bool isPresenceAnalysisDue();
+            bool isPortraitMattingDue();
+            void planFrame();
+            void buildFrameGraph(const agora::media::base::VideoFrame &capturedFrame);
+
+            static bool isDue(uint64_t frameIndex, int interval) {
+                return interval <= 1 || frameIndex % interval == 0;
+            }
+
+            // analyzers that run on the current frame, decided once before any work
+            struct FrameSchedule {
+                bool presence = false;
+                bool matting = false;
+                bool petFace = false;
+                bool dynamicAction = false;
+            };
+            FrameSchedule schedule_;
+
+            // layout of the face and hand samples handed to the smoothers
+            enum FACE_VALUE { FACE_YAW, FACE_ROLL, FACE_PITCH, FACE_LEFT, FACE_TOP, FACE_RIGHT, FACE_BOTTOM, FACE_VALUE_COUNT };
+            enum FACE_HELD { FACE_ACTION, FACE_EXPRESSION, FACE_CONFUSED_PROB, FACE_HELD_COUNT };
+            enum HAND_VALUE { HAND_LEFT, HAND_TOP, HAND_RIGHT, HAND_BOTTOM, HAND_VALUE_COUNT };
+            enum HAND_HELD { HAND_ACTION, HAND_SEQ_ACTION, HAND_HELD_COUNT };
+
+            // face and hand detection on a crop around the last results, see plugin.bytedance.roiTracking
+            bool roiTrackingEnabled_ = false;
+            RoiTracker faceRoi_;
+            RoiTracker handRoi_;
+
+            // face and hand results between detections, see plugin.bytedance.smoothing
+            bool smoothingEnabled_ = false;
+            TrackSmoother faceSmoother_{FACE_VALUE_COUNT, FACE_HELD_COUNT};
+            TrackSmoother handSmoother_{HAND_VALUE_COUNT, HAND_HELD_COUNT};
+
+            AnalysisGraph graph_;
+            // events of each stage, '\0' separated, fired in stage order once all have joined
+            std::vector<std::string> stageEvents_;
+
+            void releaseGlOnOwner();
 
-#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
-            EglCore *eglCore_ = nullptr;
-            EGLSurface offscreenSurface_ = nullptr;
-#endif
+            // context of the thread running the effect, see GlContextManager
+            GlContextManager::Context* glContext_ = nullptr;
+            std::atomic<bool> glReleasePending_ = {false};
+            // effect rendered on textures, read back frames later, see plugin.bytedance.gpuReadback
+            bool gpuReadbackEnabled_ = false;
+            int gpuReadbackDepth_ = 3;
+            std::unique_ptr<ReadbackRing> readback_;
+            GlContextManager::Context* readbackContext_ = nullptr;
+            bool hasOutput_ = true;
+            int64_t outputTimestampMs_ = 0;
+            // texture path, see processTexture()
+            std::unique_ptr<TextureFrameSource> textureSource_;
+            std::unique_ptr<TexturePipeline> texturePipeline_;
+            std::thread::id textureThread_;
+            std::vector<uint8_t> textureI420_;
+            const uint8_t* textureRgba_ = nullptr;
             std::mutex mutex_;
+            bool analysisOnly_ = false;
 
             bef_effect_handle_t byteEffectHandler_ = nullptr;
             std::string licensePath_;
@@ -78,6 +188,13 @@ namespace agora {
             std::string faceAttributeModelPath_;
             bef_effect_handle_t faceDetectHandler_ = nullptr;
             bef_effect_handle_t faceAttributesHandler_ = nullptr;
+            // detector outputs of the current frame, shared by every analyzer that needs them
+            FrameAnalysisContext analysis_;
+
+            bool humanDistanceEnabled_ = false;
+            std::string humanDistanceModelPath_;
+            float humanDistanceCameraFov_ = 0;
+            bef_effect_handle_t humanDistanceHandler_ = nullptr;
 
             bool handDetectEnabled_ = false;
             std::string handDetectModelPath_;
@@ -90,14 +207,95 @@ namespace agora {
             std::string lightDetectModelPath_;
             bef_effect_handle_t lightDetectHandler_ = nullptr;
 
+            bool skeletonDetectEnabled_ = false;
+            std::string skeletonModelPath_;
+            bef_effect_handle_t skeletonHandler_ = nullptr;
+            // network input while tracking; full detections keep the SDK default 128x224
+            int skeletonTrackingWidth_ = 96;
+            int skeletonTrackingHeight_ = 128;
+            bool skeletonNeedUpdate_ = false;
+
+            // identity of every tracked face; features are extracted once per face track
+            struct FaceIdentity {
+                int faceId;
+                int galleryIndex;
+                float similarity;
+            };
+            bool faceVerifyEnabled_ = false;
+            std::string faceVerifyModelPath_;
+            bef_effect_handle_t faceVerifyHandler_ = nullptr;
+            float faceVerifyThreshold_ = 0.6f;
+            bool beautyEnrolledOnly_ = false;
+            FaceGallery faceGallery_{BEF_AI_FACE_FEATURE_DIM};
+            std::string pendingEnrollName_;
+            std::vector<FaceIdentity> faceIdentities_;
+            std::vector<FaceIdentity> nextFaceIdentities_;
+            float faceFeature_[BEF_AI_FACE_FEATURE_DIM];
+
+            bool petFaceEnabled_ = false;
+            std::string petFaceModelPath_;
+            bef_effect_handle_t petFaceHandler_ = nullptr;
+            int petFaceInterval_ = 1;
+            bef_ai_pet_face_result petFaceResult_;
+
+            bool dynamicActionEnabled_ = false;
+            std::string dynamicActionModelPath_;
+            bef_effect_handle_t dynamicActionHandler_ = nullptr;
+            int dynamicActionInterval_ = 1;
+            bef_ai_dynamic_action_result dynamicActionResult_;
+            bef_ai_dynamic_action_sk dynamicActionSkeleton_;
+
+            bool hairParseEnabled_ = false;
+            std::string hairParserModelPath_;
+            bef_effect_handle_t hairParserHandler_ = nullptr;
+
+            bool headSegEnabled_ = false;
+            std::string headSegModelPath_;
+            // the shared model this handle was loaded from, null when it uses the path
+            ModelBuffer headSegModelBuffer_;
+            // last shared model looked at, a newer one replaces the path
+            ModelBuffer headSegModelSeen_;
+            bool headSegModelChanged_ = false;
+            bef_ai_headseg_handle headSegHandler_ = 0;
+
+            // latest segmentation masks, read by the background stage and other consumers
+            MaskCache masks_;
+            // media time of the frame being processed, the effect, every analyzer and their events use it
+            FrameClock frameClock_;
+            FrameTime frameTime_;
+            int64_t frameTimestampMs_ = 0;
+            // rotation of the frame being processed, results are reported in display coordinates
+            FrameOrientation orientation_;
+            bool mirrorResults_ = false;
+
+            // virtual background: matting runs every portraitMattingInterval_ frames,
+            // the compositor reuses the last mask in between
+            std::string portraitMattingModelPath_;
+            bef_effect_handle_t portraitMattingHandler_ = nullptr;
+            int portraitMattingInterval_ = 2;
+            int framesSinceMatting_ = 0;
+            BackgroundCompositor background_;
+
             agora::media::base::VideoFrame prevFrame_;
             unsigned char* yuvBuffer_ = nullptr;
+            // RGBA copy of the frame, rgbaWidth() pixels a row: the luma stride,
+            // padding included, so the effect output converts back plane for plane
             unsigned char* rgbaBuffer_ = nullptr;
 
+            int rgbaWidth() const { return prevFrame_.yStride; }
+
+            int rgbaStride() const { return prevFrame_.yStride * 4; }
+
+            // face/hand cadence driven by the local speaker's voice activity
+            bool activityGatingEnabled_ = false;
+            int speakingInterval_ = 1;
+            int silentInterval_ = 10;
+            uint64_t frameIndex_ = 0;
+
             bool faceStickerEnabled_ = false;
             std::string faceStickerItemPath_;
-            agora::rtc::IExtensionControl* control_;
-            char* id_;
+            std::shared_ptr<SharedVideoResources> shared_;
+            std::string vendor_;
         };
     }
 }
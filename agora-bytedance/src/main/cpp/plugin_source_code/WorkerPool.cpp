@@ -0,0 +1,195 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#include "WorkerPool.h"
+
+#include <cstdio>
+#if defined(__ANDROID__) || defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "JniHelper.h"
+
+namespace agora {
+    namespace extension {
+        namespace {
+            struct WorkerIdentity {
+                const WorkerPool* pool;
+                int index;
+            };
+
+            thread_local WorkerIdentity currentWorker = {nullptr, -1};
+
+            long maxFrequencyKhz(int cpu) {
+                char path[96];
+                snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+                FILE* file = fopen(path, "r");
+                if (!file) {
+                    return 0;
+                }
+                long frequency = 0;
+                if (fscanf(file, "%ld", &frequency) != 1) {
+                    frequency = 0;
+                }
+                fclose(file);
+                return frequency;
+            }
+
+            void pinCurrentThread(const std::vector<int>& cores) {
+#if defined(__ANDROID__) || defined(__linux__)
+                if (cores.empty()) {
+                    return;
+                }
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (size_t i = 0; i < cores.size(); i++) {
+                    CPU_SET(cores[i], &set);
+                }
+                sched_setaffinity(0, sizeof(set), &set);
+#endif
+            }
+        }
+
+        std::vector<int> WorkerPool::bigCores() {
+            int count = (int)std::thread::hardware_concurrency();
+            std::vector<long> frequencies(count > 0 ? count : 0);
+            long lowest = 0;
+            for (int cpu = 0; cpu < count; cpu++) {
+                frequencies[cpu] = maxFrequencyKhz(cpu);
+                if (frequencies[cpu] > 0 && (lowest == 0 || frequencies[cpu] < lowest)) {
+                    lowest = frequencies[cpu];
+                }
+            }
+            // everything above the little cluster; prime and big cores alike
+            std::vector<int> cores;
+            for (int cpu = 0; cpu < count; cpu++) {
+                if (frequencies[cpu] > lowest) {
+                    cores.push_back(cpu);
+                }
+            }
+            if (cores.empty()) {
+                for (int cpu = 0; cpu < count; cpu++) {
+                    cores.push_back(cpu);
+                }
+            }
+            return cores;
+        }
+
+        WorkerPool::WorkerPool(int threadCount, bool pinToBigCores)
+                : workerCount_(threadCount > 0 ? threadCount : 0),
+                  queues_(new Queue[threadCount > 0 ? threadCount : 1]) {
+            if (pinToBigCores) {
+                cores_ = bigCores();
+            }
+            threads_.reserve(workerCount_);
+            for (int i = 0; i < workerCount_; i++) {
+                threads_.emplace_back(&WorkerPool::workerLoop, this, i);
+            }
+        }
+
+        WorkerPool::~WorkerPool() {
+            {
+                const std::lock_guard<std::mutex> lock(sleepMutex_);
+                stopping_ = true;
+            }
+            available_.notify_all();
+            for (size_t i = 0; i < threads_.size(); i++) {
+                threads_[i].join();
+            }
+        }
+
+        bool WorkerPool::push(int queue, Task& task) {
+            Queue& q = queues_[queue];
+            const std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.count == kQueueCapacity) {
+                return false;
+            }
+            q.tasks[(q.head + q.count) % kQueueCapacity] = std::move(task);
+            q.count++;
+            return true;
+        }
+
+        void WorkerPool::submit(Task task) {
+            int workers = size();
+            if (workers == 0) {
+                task();
+                return;
+            }
+            bool fromWorker = currentWorker.pool == this;
+            int first = fromWorker ? currentWorker.index : (int)(nextQueue_++ % workers);
+            while (true) {
+                bool pushed = false;
+                for (int i = 0; i < workers && !pushed; i++) {
+                    pushed = push((first + i) % workers, task);
+                }
+                if (pushed) {
+                    break;
+                }
+                if (fromWorker) {
+                    // every worker may be waiting here for room, nobody would make it
+                    task();
+                    return;
+                }
+                // every ring full: wait for the workers to make room
+                std::this_thread::yield();
+            }
+            {
+                const std::lock_guard<std::mutex> lock(sleepMutex_);
+                queued_++;
+            }
+            available_.notify_one();
+        }
+
+        bool WorkerPool::pop(int worker, Task& task) {
+            int workers = size();
+            for (int i = 0; i < workers; i++) {
+                int victim = (worker + i) % workers;
+                Queue& q = queues_[victim];
+                const std::lock_guard<std::mutex> lock(q.mutex);
+                if (q.count == 0) {
+                    continue;
+                }
+                if (victim == worker) {
+                    task = std::move(q.tasks[(q.head + q.count - 1) % kQueueCapacity]);
+                } else {
+                    task = std::move(q.tasks[q.head]);
+                    q.head = (q.head + 1) % kQueueCapacity;
+                }
+                q.count--;
+                queued_--;
+                return true;
+            }
+            return false;
+        }
+
+        void WorkerPool::workerLoop(int index) {
+            currentWorker.pool = this;
+            currentWorker.index = index;
+            pinCurrentThread(cores_);
+
+            Task task;
+            while (true) {
+                if (pop(index, task)) {
+                    task();
+                    task = nullptr;
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleepMutex_);
+                available_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+                if (stopping_ && queued_ <= 0) {
+                    break;
+                }
+            }
+
+#if defined(__ANDROID__) || defined(TARGET_OS_ANDROID)
+            // license checks attach the worker to the JVM, it must not exit attached
+            if (JniHelper::getJniHelper()) {
+                JniHelper::getJniHelper()->detachWorkerThread();
+            }
+#endif
+            currentWorker.pool = nullptr;
+            currentWorker.index = -1;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+//
+// Created by agent on 2026/10/19.
+//
+
+#ifndef AGORAWITHBYTEDANCE_WORKERPOOL_H
+#define AGORAWITHBYTEDANCE_WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace agora {
+    namespace extension {
+        /**
+         * Fixed set of work-stealing threads.
+         *
+         * Every worker owns a bounded task ring. A task submitted from a worker
+         * goes to the back of its own ring and is popped from there again (LIFO,
+         * the data is still hot); other tasks are spread round robin. An idle
+         * worker steals from the front of the other rings. When every ring is
+         * full a worker runs its task itself and any other thread waits. The
+         * rings are preallocated, so submitting a task that fits
+         * std::function's inline storage does not allocate.
+         *
+         * With pinning enabled the threads are bound to the fastest cores of a
+         * big.LITTLE CPU.
+         */
+        class WorkerPool {
+        public:
+            typedef std::function<void()> Task;
+
+            static const int kQueueCapacity = 64;
+
+            WorkerPool(int threadCount, bool pinToBigCores);
+
+            ~WorkerPool();
+
+            int size() const { return workerCount_; }
+
+            void submit(Task task);
+
+            // cores faster than the slowest cluster, all cores if they are uniform
+            static std::vector<int> bigCores();
+
+        private:
+            struct Queue {
+                std::mutex mutex;
+                Task tasks[kQueueCapacity];
+                int head = 0;
+                int count = 0;
+            };
+
+            bool push(int queue, Task& task);
+
+            bool pop(int worker, Task& task);
+
+            void workerLoop(int index);
+
+            // fixed before the threads start, they read it without a lock
+            const int workerCount_;
+            std::vector<std::thread> threads_;
+            std::unique_ptr<Queue[]> queues_;
+            std::vector<int> cores_;
+            std::atomic<unsigned int> nextQueue_ = {0};
+            std::atomic<int> queued_ = {0};
+            std::mutex sleepMutex_;
+            std::condition_variable available_;
+            bool stopping_ = false;
+        };
+    }
+}
+
+#endif //AGORAWITHBYTEDANCE_WORKERPOOL_H